@@ -0,0 +1,77 @@
+#pragma once
+
+#include "responses.hpp"
+#include "config.hpp"
+#include "game.hpp"
+#include "replay.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <utility>
+
+namespace Analytics {
+
+    /**
+     * Counts values in buckets that grow with the value, so percentiles of any range of values come out within
+     * about 6% in a fixed 8KB
+     *
+     * Values below 16 get a bucket each, every power of two above that is split into 16. Histograms merge by adding
+     * their buckets, so each thread can keep its own
+     */
+    class Histogram {
+    public:
+        void Add(std::uint64_t value);
+        void Merge(const Histogram& other);
+
+        long long Count() const {return Total;}
+        double Mean() const {return Total ? (double)Sum/Total : 0;}
+        std::uint64_t Max() const {return Largest;}
+        std::uint64_t Percentile(double p) const;
+
+    private:
+        static constexpr int SUB_BITS = 4;
+        static constexpr int BUCKETS = (64 - SUB_BITS + 1) << SUB_BITS;
+
+        std::array<long long,BUCKETS> Buckets = {};
+        long long Total = 0;
+        long double Sum = 0;
+        std::uint64_t Largest = 0;
+    };
+
+    // Boards started from one tile, on boards of one size
+    struct Opening {
+        long long Boards = 0;
+        long long Won = 0;
+    };
+
+    /**
+     * Everything learned from a set of recordings
+     *
+     * Boards are counted as they were left, so a loss that was undone and then won counts as a win. The session
+     * stats are the games' own, added up over every recording.
+     */
+    struct Summary {
+        long long Recordings = 0;
+        long long Unreadable = 0;
+        long long Damaged = 0;      // Cut short or corrupt, read up to the damage
+        long long Events = 0;
+
+        Responses::SessionStats Stats;      // Of every recording
+
+        Histogram TilesPerTap;      // Tiles revealed by each tap that didn't hit a mine
+        Histogram MovesPerBoard;
+        Histogram BoardMillis;      // From a board's first tap to its last move
+        Histogram FirstLossMillis;  // From the start of a recording to its first loss, if it has one
+
+        // Keyed by rows, columns, row and column of the first tap
+        std::map<std::array<int,4>,Opening> Openings;
+
+        void Add(const Responses::SessionStats& stats);
+        void Merge(const Summary& other);
+    };
+
+    void Analyze(const std::string& path, Summary& summary);
+}
@@ -0,0 +1,22 @@
+#pragma once
+
+#include <iostream>
+#include <cstdint>
+#include <cstdlib>  // For strtol, strtoull
+#include <cstring>  // For strcmp
+
+namespace Config {
+
+    struct Settings {
+        int Rows = 26;
+        int Columns = 26;
+        int Mines = 100;
+        int Threads = 1;    // Threads used for large cascades and generating no-guess boards
+        bool NoGuess = false;   // Only generate boards that can be solved without guessing
+        unsigned long long Seed = 0;    // Seed of the first board, 0 picks one at random
+    };
+
+    bool Parse(int argc, char* argv[], Settings& settings);
+    bool ValidBoard(std::uint64_t rows, std::uint64_t columns, std::uint64_t mines);
+    void Usage(const char* program);
+}
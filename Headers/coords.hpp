@@ -0,0 +1,13 @@
+#pragma once
+
+#include <utility>
+#include <string>
+#include <cstddef>
+#include <cctype>   // For isalpha/isdigit/toupper
+
+namespace Coords {
+    std::string Label(int n);
+    int Parse(const char* component, std::size_t length);
+    int Parse(const std::string& component);
+    std::string Format(const std::pair<int,int>& tile);
+}
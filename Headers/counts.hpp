@@ -0,0 +1,33 @@
+#pragma once
+
+#include <algorithm>
+#include <vector>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>  // For SSE2
+#define COUNTS_SSE2 1
+#endif
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>  // For AVX2, enabled per function and picked at runtime
+#define COUNTS_AVX2 1
+#endif
+
+namespace Counts {
+
+    enum class Kernel {
+        Scalar,
+        SSE2,
+        AVX2
+    };
+
+    bool Supported(Kernel kernel);
+    Kernel Best();
+    const char* Name(Kernel kernel);
+    void Compute(const unsigned char* mines, unsigned char* counts, int rows, int columns, Kernel kernel);
+    void Compute(
+        const unsigned char* mines, unsigned char* counts, int rows, int columns, Kernel kernel,
+        unsigned char* sums
+    );
+    void Compute(const unsigned char* mines, unsigned char* counts, int rows, int columns);
+}
@@ -0,0 +1,70 @@
+#pragma once
+
+#include "responses.hpp"
+#include "config.hpp"
+#include "tiles.hpp"
+#include "solver.hpp"
+#include "noguess.hpp"
+#include "prng.hpp"
+#include "snapshot.hpp"
+
+#include <utility>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace Minesweeper {
+
+    /**
+     * One game of Minesweeper: a board, the seed its mines were placed with, and the stats of every board played
+     * on it
+     *
+     * Every board comes from its own seed, drawn from the game's seed, so any board can be played again by resetting
+     * to its seed and tapping the same first tile
+     *
+     * Games share nothing, so any number of them can be created, played and destroyed at once from different
+     * threads
+     */
+    class Game {
+    public:
+        explicit Game(const Config::Settings& settings);
+        Game(const Config::Settings& settings, std::uint64_t seed);
+
+        Responses::Tap Tap(const std::pair<int,int>& tile);
+        void Tap(const std::pair<int,int>& tile, Responses::Tap& response);
+        Responses::Flag Flag(const std::pair<int,int>& tile);
+        bool Undo(Responses::Step& step);
+        bool Redo(Responses::Step& step);
+        bool Save(const std::string& path) const;
+        bool Load(const std::string& path, Responses::Step& step);
+        void Reset();
+        void Reset(std::uint64_t seed);
+        void usePool(NoGuess::Pool* pool) {Pool = pool;}
+
+        bool Started() const {return !NewGame;}
+        bool Over() const {return State != States::Game::Playon;}
+        States::Game getState() const {return State;}
+        const Responses::SessionStats& getStats() const {return Stats;}
+        const Config::Settings& getSettings() const {return Board.getSettings();}
+        const Tiles::Board& getBoard() const {return Board;}
+        const Memory::Stats& getMemory() const {return Board.getMemory();}  // Of the current board
+        std::uint64_t getSeed() const {return Seed;}   // Of the current board, or the next one before it starts
+        bool NeedsGuess() const {return Guessing;}
+
+    private:
+        Tiles::Board Board;
+        Prng::Generator Seeds;
+        std::uint64_t Seed;
+        bool Pinned;    // The next board must come from Seed, e.g. to replay it
+        Responses::SessionStats Stats;
+
+        // No-guess boards are taken from the pool when it has one ready, and generated here otherwise
+        NoGuess::Pool* Pool = nullptr;
+        Solver::Engine Solver;
+
+        bool Guessing = false;  // No-guess generation gave up on the current board, so it may need a guess
+        bool NewGame = true;
+        States::Game State = States::Game::Playon;
+    };
+}
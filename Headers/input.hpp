@@ -1,11 +1,48 @@
 #pragma once
 
 #include "responses.hpp"
+#include "config.hpp"
+#include "coords.hpp"
+#include "render.hpp"
 
+#include <algorithm> // For copy
 #include <utility>  // For pair
-#include <iostream> // For setting the cursor
+#include <iostream> // For getline
+#include <cctype>   // For tolower/isdigit
+#include <cstddef>
+#include <cstring>  // For memchr
+#include <cerrno>
+#include <string>
+#include <vector>
+
+#include <unistd.h> // For read
 
 namespace Input
 {
-    Responses::Input Get();
+    Responses::Input Parse(const char* line, std::size_t length, const Config::Settings& settings);
+    Responses::Input Parse(const std::string& line, const Config::Settings& settings);
+    Responses::Input Get(const Config::Settings& settings, Render::Base& renderer);
+
+    /**
+     * Reads commands from a file or pipe in large blocks, for scripts instead of a player
+     *
+     * Lines are parsed where they were read, so nothing is prompted for or copied and blank lines are skipped
+     */
+    class Reader {
+    public:
+        explicit Reader(int descriptor);
+
+        bool Next(const Config::Settings& settings, Responses::Input& response);
+        long long getLines() const {return Lines;}   // Commands read so far
+
+    private:
+        int Descriptor;
+        std::vector<char> Buffer;
+        std::size_t Start = 0;      // First byte not yet parsed
+        std::size_t End = 0;        // One past the last byte read
+        bool Finished = false;      // Nothing more can be read
+        long long Lines = 0;
+
+        void fill();
+    };
 }
\ No newline at end of file
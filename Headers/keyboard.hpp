@@ -0,0 +1,122 @@
+#pragma once
+
+#include "responses.hpp"
+#include "analytics.hpp"
+#include "config.hpp"
+#include "render.hpp"
+#include "input.hpp"
+
+#include <algorithm>
+#include <functional>
+#include <utility>
+#include <chrono>
+#include <cstddef>
+#include <cctype>   // For tolower
+#include <cerrno>
+#include <string>
+#include <vector>
+
+#include <termios.h>
+#include <unistd.h>     // For read, isatty
+#include <poll.h>
+
+namespace Keyboard {
+
+    enum class Key {
+        None,       // Nothing the game uses, e.g. a function key
+        Up,
+        Down,
+        Left,
+        Right,
+        Enter,
+        Space,
+        Backspace,
+        Escape,
+        Interrupt,  // Ctrl-C or Ctrl-D, raw mode doesn't turn them into signals
+        Character   // Anything printable, see Press::Character
+    };
+
+    struct Press {
+        Key Type = Key::None;
+        char Character = 0;
+    };
+
+    std::size_t Decode(const char* data, std::size_t length, bool complete, Press& press);
+
+    /**
+     * Puts a terminal in raw mode for as long as it lives, so every key is read as soon as it is pressed and nothing
+     * is echoed. Anything that isn't a terminal, e.g. a pipe, is left as it is
+     */
+    class Raw {
+    public:
+        explicit Raw(int descriptor);
+        ~Raw();
+        Raw(const Raw&) = delete;
+        Raw& operator=(const Raw&) = delete;
+
+        bool Active() const {return Enabled;}
+
+    private:
+        int Descriptor;
+        termios Saved;
+        bool Enabled = false;
+    };
+
+    /**
+     * Waits for key presses with poll, running timers while it waits
+     *
+     * Timers run on the same thread as everything else, between keys, so they can draw without any locking
+     */
+    class Loop {
+    public:
+        explicit Loop(int descriptor);
+
+        void Every(std::chrono::milliseconds period, std::function<void()> callback);
+        bool Next(Press& press);
+        std::chrono::steady_clock::time_point getArrived() const {return Arrived;}     // When the last key was read
+
+    private:
+        struct Timer {
+            std::chrono::steady_clock::time_point Due;
+            std::chrono::milliseconds Period;
+            std::function<void()> Callback;
+        };
+
+        int Descriptor;
+        std::vector<Timer> Timers;
+        char Buffer[256];
+        std::size_t Length = 0;
+        bool Finished = false;      // Nothing more can be read
+        std::chrono::steady_clock::time_point Arrived;
+
+        int runTimers();
+    };
+
+    /**
+     * Plays the game from the keyboard, a key per move
+     *
+     * A cursor is moved over the board with the arrow keys (or hjkl), space or enter taps the tile under it and f
+     * flags it. ':' types a command like the ones read from a line, e.g. save and load
+     */
+    class Commands {
+    public:
+        Commands(int descriptor, const Config::Settings& settings);
+
+        Responses::Input Get(Render::Base& renderer);
+        Loop& getLoop() {return Events;}
+        const Analytics::Histogram& getLatency() const {return Latency;}
+
+    private:
+        Raw Terminal;
+        Loop Events;
+        Config::Settings Settings;
+        std::pair<int,int> Cursor = {1,1};
+        std::string Line;               // Command being typed
+        bool Typing = false;
+        bool Measuring = false;         // A key was handled, but what it did hasn't been drawn yet
+        Analytics::Histogram Latency;   // Microseconds from reading a key to the end of the frame showing it
+
+        void measure();
+    };
+
+}
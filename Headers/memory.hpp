@@ -0,0 +1,83 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <vector>
+
+namespace Memory {
+
+    struct Stats {
+        long long Allocations = 0;  // Since the last reset
+        long long Bytes = 0;        // Handed out since the last reset, alignment included
+        long long PeakBytes = 0;    // Most bytes handed out between any two resets
+        long long Blocks = 0;       // Times the arena itself went to the heap
+    };
+
+    /**
+     * Hands out memory by bumping a pointer through a block, and takes all of it back at once
+     *
+     * Nothing is freed on its own. Resetting rewinds to the start of the first block, so once the block has grown to
+     * fit, a reset costs nothing and allocating costs a few additions. If a reset finds more than one block in use,
+     * they are merged into a single block big enough for all of them.
+     *
+     * Not thread safe, every arena belongs to one board
+     */
+    class Arena {
+    public:
+        explicit Arena(std::size_t capacity = 0);
+        Arena(const Arena&) = delete;
+        Arena& operator=(const Arena&) = delete;
+
+        void* Allocate(std::size_t bytes, std::size_t alignment);
+        void Reset();
+        const Stats& getStats() const {return Usage;}
+
+    private:
+        std::vector<std::unique_ptr<char[]>> Blocks;
+        std::size_t Reserved = 0;   // Bytes over every block
+        char* Head = nullptr;
+        char* End = nullptr;
+        Stats Usage;
+
+        void grow(std::size_t bytes);
+    };
+
+    /**
+     * Lets standard containers allocate from an arena. Freeing does nothing, the memory comes back on reset
+     *
+     * Containers must be rebuilt after their arena is reset, any memory they still point to will be handed out again.
+     * Copies of a container use the heap instead (as does a default constructed allocator), so they stay valid
+     * whatever happens to the arena.
+     */
+    template <typename T>
+    class Allocator {
+    public:
+        using value_type = T;
+
+        Allocator() : Owner(nullptr) {}
+        explicit Allocator(Arena& arena) : Owner(&arena) {}
+        template <typename U>
+        Allocator(const Allocator<U>& other) : Owner(other.Owner) {}
+
+        T* allocate(std::size_t n) {
+            void* Address = Owner ? Owner->Allocate(n*sizeof(T),alignof(T)) : ::operator new(n*sizeof(T));
+            return static_cast<T*>(Address);
+        }
+        void deallocate(T* memory, std::size_t) {
+            if (!Owner) {::operator delete(memory);}
+        }
+        Allocator select_on_container_copy_construction() const {return Allocator();}
+
+        Arena* Owner;
+    };
+
+    template <typename T, typename U>
+    bool operator==(const Allocator<T>& a, const Allocator<U>& b) {return a.Owner == b.Owner;}
+    template <typename T, typename U>
+    bool operator!=(const Allocator<T>& a, const Allocator<U>& b) {return a.Owner != b.Owner;}
+
+    template <typename T>
+    using Buffer = std::vector<T,Allocator<T>>;
+}
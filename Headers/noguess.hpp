@@ -0,0 +1,62 @@
+#pragma once
+
+#include "config.hpp"
+#include "tiles.hpp"
+#include "solver.hpp"
+#include "prng.hpp"
+
+#include <condition_variable>
+#include <utility>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace NoGuess {
+
+    bool Solvable(const Tiles::Board& board, const std::pair<int,int>& start, Solver::Engine& solver);
+    bool Generate(Tiles::Board& board, const std::pair<int,int>& start, std::uint64_t& seed, Solver::Engine& solver);
+
+    /**
+     * Generates no-guess boards in the background, so a game never waits for one
+     *
+     * A no-guess board only works for the start tile it was made for, so every start tile has a small ring of
+     * seeds that are known to give one. Workers keep topping up whichever rings are emptiest, and sleep once every
+     * ring is full. Boards too big to keep a ring for every tile get no pool, and are generated when the game starts
+     * instead.
+     *
+     * Every ring's seeds sit in one buffer, Capacity of them per ring, so the rings take two allocations however
+     * many tiles there are.
+     */
+    class Pool {
+    public:
+        Pool(const Config::Settings& settings, std::uint64_t seed);
+        ~Pool();
+
+        bool Take(const std::pair<int,int>& start, std::uint64_t& seed);
+        int Ready();
+
+    private:
+        // Where a ring's seeds are in Seeds
+        struct Ring {
+            int Head = 0;
+            int Count = 0;
+            int Pending = 0;    // Boards being checked for it
+        };
+
+        Config::Settings Settings;
+        std::vector<Ring> Rings;    // One per start tile, row major
+        std::vector<std::uint64_t> Seeds;   // Capacity per ring, ring i's starting at i*Capacity
+        int Capacity = 0;
+        int Cursor = 0;
+        int NumReady = 0;
+
+        std::mutex Lock;
+        std::condition_variable Wake;
+        bool Stopping = false;
+        std::vector<std::thread> Workers;
+
+        int nextStart();
+        void work(std::uint64_t seed);
+    };
+}
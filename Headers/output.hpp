@@ -1,17 +1,39 @@
 #pragma once
 
 #include "responses.hpp"
+#include "config.hpp"
+#include "coords.hpp"
+#include "screen.hpp"
+#include "tiles.hpp"
 
+#include <algorithm>
 #include <iostream>
 #include <sstream>
 #include <iomanip>
+#include <cstdint>
+#include <array>
+#include <string>
+#include <vector>
 #include <map>
 
 namespace Output {
-    void Dashboard();
-    void Log(States::Log key, const std::pair<char,char>& tile);
+    void Dashboard(const Tiles::View& board);
+    void Margins(bool enabled);
+    std::string Message(States::Log key, const std::pair<int,int>& tile);
+    void Log(States::Log key, const std::pair<int,int>& tile);
+    void Seed(std::uint64_t seed);
     void Reveal(const Responses::Tap& response);
-    void Flag(const std::pair<char,char>& flagged_tile, const Responses::Flag& response);
+    void Flag(const std::pair<int,int>& flagged_tile, const Responses::Flag& response);
+    void Step(const Responses::Step& response);
     void Reset();
+    void Pan(int rows, int columns);
+    void Centre(const std::pair<int,int>& tile);
+    void Follow(const std::pair<int,int>& tile);
     void Quit(const Responses::SessionStats& stats);
+    void Cursor(const std::pair<int,int>& tile);
+    void Typing(const std::string& text, bool editing);
+    void Clock(long long seconds);
+    void Prompt();
+    void Flush();
+    const Screen::Metrics& getMetrics();
 }
\ No newline at end of file
@@ -0,0 +1,274 @@
+#pragma once
+
+#include "responses.hpp"
+#include "analytics.hpp"
+#include "render.hpp"
+#include "tiles.hpp"
+
+#include <algorithm>
+#include <functional>
+#include <iostream>
+#include <iomanip>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <string>
+#include <vector>
+#include <thread>
+
+namespace Pipeline {
+
+    /**
+     * A bounded queue between exactly one thread putting items in and one taking them out, without locks
+     *
+     * Each side only writes its own index, so the two never wait on each other. The indexes keep counting up and are
+     * wrapped when used, which is why the capacity is a power of two
+     */
+    template <typename T, std::size_t N>
+    class Queue {
+        static_assert(N && !(N & (N - 1)), "The capacity has to be a power of two");
+
+    public:
+        /**
+         * Called only by the thread putting items in
+         *
+         * @param item: Moved in if there is room, left as it was if not
+         *
+         * @return If there was room
+         */
+        bool Push(T& item) {
+            T* Slot = Back();
+            if (!Slot) {return false;}
+            *Slot = std::move(item);
+            Commit();
+            return true;
+        }
+
+        /**
+         * Called only by the thread taking items out
+         *
+         * @param item: Output, the oldest item
+         *
+         * @return If there was one
+         */
+        bool Pop(T& item) {
+            T* Slot = Front();
+            if (!Slot) {return false;}
+            item = std::move(*Slot);
+            Release();
+            return true;
+        }
+
+        /**
+         * The slot the next item goes in, so the thread putting items in can fill it where it is. It still holds the
+         * item it held last time round, which lets an item's vectors keep their capacity from one use to the next
+         *
+         * @return The slot, nullptr if the queue is full
+         */
+        T* Back() {
+            const std::size_t Next = Tail.Value.load(std::memory_order_relaxed);
+            if (Next - Head.Value.load(std::memory_order_acquire) == N) {return nullptr;}
+            return &Items[Next & (N - 1)];
+        }
+
+        // Hands the slot filled through Back over to the thread taking items out
+        void Commit() {Tail.Value.store(Tail.Value.load(std::memory_order_relaxed) + 1,std::memory_order_release);}
+
+        /**
+         * The oldest item, so the thread taking items out can use it where it is
+         *
+         * @return The item, nullptr if there isn't one
+         */
+        T* Front() {
+            const std::size_t Next = Head.Value.load(std::memory_order_relaxed);
+            if (Next == Tail.Value.load(std::memory_order_acquire)) {return nullptr;}
+            return &Items[Next & (N - 1)];
+        }
+
+        // Gives the slot of the item from Front back, once it's done with
+        void Release() {Head.Value.store(Head.Value.load(std::memory_order_relaxed) + 1,std::memory_order_release);}
+
+        // Items waiting, only exact for the thread taking them out
+        std::size_t Size() const {
+            return Tail.Value.load(std::memory_order_acquire) - Head.Value.load(std::memory_order_acquire);
+        }
+        static constexpr std::size_t Capacity() {return N;}
+
+    private:
+        static constexpr std::size_t CACHE_LINE = 64;
+
+        /**
+         * An index with a cache line of padding on either side, so the lines it sits on hold nothing else, whatever
+         * the queue's alignment and however small the items. Padding rather than alignas, which C++11's new doesn't
+         * honour past the default alignment
+         */
+        struct Index {
+            char Before[CACHE_LINE];
+            std::atomic<std::size_t> Value{0};
+            char After[CACHE_LINE];
+        };
+
+        Index Head;     // Next item to take out
+        T Items[N];
+        Index Tail;     // Next slot to put one in
+    };
+
+    /**
+     * Waits for the other end of a queue, spinning at first and then sleeping for longer and longer up to a
+     * millisecond, so an idle stage costs next to nothing
+     */
+    class Backoff {
+    public:
+        void Wait();
+        void Reset() {Tries = 0;}
+
+    private:
+        int Tries = 0;
+    };
+
+    // A command read by the input stage
+    struct Command {
+        Responses::Input Input;
+        bool Starts = false;        // A replayed board starts here, dealt from Seed
+        std::uint64_t Seed = 0;
+        bool End = false;           // Nothing more will be read
+        std::chrono::steady_clock::time_point Read;
+    };
+
+    // Everything in microseconds, except the depths which are items waiting in a queue when one is taken out
+    struct Metrics {
+        Analytics::Histogram InputDepth;
+        Analytics::Histogram RenderDepth;
+        Analytics::Histogram InputWait;     // From reading a command to the engine taking it
+        Analytics::Histogram Engine;        // Running a command, handing over what it drew included
+        Analytics::Histogram RenderWait;    // From the engine drawing something to the renderer taking it
+        Analytics::Histogram Frame;         // Drawing every update a frame merged, and writing it
+        Analytics::Histogram Latency;       // From reading a command to the end of the frame that showed it
+        long long Updates = 0;
+        long long Frames = 0;
+    };
+
+    /**
+     * What the screen shows of a board, kept up from the calls that drew it and nothing else
+     *
+     * A byte a tile, the same values as a board's view, except that once the board is lost every mine shows MINE
+     */
+    class Mirror : public Tiles::View {
+    public:
+        static constexpr signed char MINE = 9;
+
+        void Deal(const Config::Settings& settings);
+        void Hide();
+        void Show(const std::pair<int,int>& tile, signed char shown) {Shown[index(tile)] = shown;}
+
+        const Config::Settings& getSettings() const override {return Settings;}
+        signed char getShown(const std::pair<int,int>& tile) const override {return Shown[index(tile)];}
+        bool tileMine(const std::pair<int,int>& tile) const override {return Shown[index(tile)] == MINE;}
+
+    private:
+        Config::Settings Settings;
+        std::vector<signed char> Shown;
+
+        std::size_t index(const std::pair<int,int>& tile) const {
+            return (std::size_t)(tile.first - 1)*Settings.Columns + tile.second - 1;
+        }
+    };
+
+    /**
+     * Runs the game loop as three stages on threads of their own: input, the engine and the renderer
+     *
+     * Commands are read on the input thread and taken by the engine with Next, on the thread that runs the game. This
+     * is a renderer to the engine: what it draws is queued for the render thread, which draws on the real renderer.
+     * Whatever piles up while a frame is being written is drawn in the next one, so a slow frame delays the screen
+     * but never the next command.
+     *
+     * The render thread never reads the board, which the engine may already have moved past the update being drawn.
+     * It keeps a mirror of what the updates showed instead, and the window is redrawn from that
+     */
+    class Stages : public Render::Base {
+    public:
+        /**
+         * @param target: Renderer the render thread draws on
+         * @param source: Reads the next command, on the input thread. Reading stops after Quit or End
+         * @param prompt: Prompt whenever the renderer catches up, otherwise frames are only drawn on Flush
+         */
+        Stages(Render::Base& target, std::function<void(Command&)> source, bool prompt);
+        ~Stages();
+        Stages(const Stages&) = delete;
+        Stages& operator=(const Stages&) = delete;
+
+        Command Next();
+        void Stop();
+        const Metrics& getMetrics() const {return Measured;}
+        void Report(std::ostream& out) const;
+
+        void Dashboard(const Tiles::View& board) override;
+        void Log(States::Log key, const std::pair<int,int>& tile) override;
+        void Seed(std::uint64_t seed) override;
+        void Reveal(const Responses::Tap& response) override;
+        void Flag(const std::pair<int,int>& tile, const Responses::Flag& response) override;
+        void Step(const Responses::Step& response) override;
+        void Reset() override;
+        void Pan(int rows, int columns) override;
+        void Centre(const std::pair<int,int>& tile) override;
+        void Follow(const std::pair<int,int>& tile) override;
+        void Quit(const Responses::SessionStats& stats) override;
+        void Flush() override;
+
+    private:
+        /**
+         * A call to the renderer, waiting for the render thread
+         *
+         * Updates are written into their queue slot and drawn from it, never copied. A slot's tiles are assigned over
+         * the ones it held before, so once the slots have seen the largest update they will get, nothing allocates
+         */
+        struct Update {
+            enum class Kind {Dashboard, Log, Seed, Reveal, Flag, Step, Reset, Pan, Centre, Follow, Quit, Flush, Stop};
+
+            Kind Type = Kind::Flush;
+            Config::Settings Settings;
+            States::Log Key = States::Log::Bad;
+            std::pair<int,int> Tile;
+            std::uint64_t Seed = 0;
+            Responses::Tap Tap = {};
+            Responses::Flag Flag = {};
+            Responses::Step Step = {};
+            Responses::SessionStats Stats;
+            std::chrono::steady_clock::time_point Read;     // When the command that drew it was read
+            std::chrono::steady_clock::time_point Queued;
+        };
+
+        static constexpr std::size_t COMMANDS = 64;
+        static constexpr std::size_t UPDATES = 256;
+
+        Render::Base& Target;
+        std::function<void(Command&)> Source;
+        bool Prompting;
+        Queue<Command,COMMANDS> Commands;
+        Queue<Update,UPDATES> Updates;
+        std::thread Reading;
+        std::thread Drawing;
+        bool Stopped = false;
+
+        // Only touched by the render thread
+        Mirror Drawn;
+
+        // Only touched by the engine
+        Backoff Full;
+        std::chrono::steady_clock::time_point Current;      // When the command being run was read
+        std::chrono::steady_clock::time_point Taken;        // When the engine took it
+        bool Running = false;
+
+        // Histograms are each only written by one thread, and read once the threads are done
+        Metrics Measured;
+
+        void read();
+        void draw();
+        void apply(const Update& update);
+        Update& slot(Update::Kind type);
+        void commit(Update& update);
+    };
+
+}
@@ -0,0 +1,37 @@
+#pragma once
+
+#include "responses.hpp"
+#include "game.hpp"
+#include "solver.hpp"
+#include "probability.hpp"
+#include "prng.hpp"
+
+#include <utility>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace Policy {
+
+    struct Move {
+        States::Input Key;
+        std::pair<int,int> Tile;
+    };
+
+    /**
+     * Decides the moves of a simulated player
+     *
+     * Policies only look at what a player could see through the game's board
+     */
+    class Base {
+    public:
+        virtual ~Base() {}
+
+        // Called before every board
+        virtual void Start(unsigned seed) {(void)seed;}
+        virtual Move Next(const Minesweeper::Game& game) = 0;
+    };
+
+    std::unique_ptr<Base> Create(const std::string& name);
+    const char* Names();
+}
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <cstdint>
+
+namespace Prng {
+
+    /**
+     * xoshiro256**, a small, fast random number generator whose whole state is four 64 bit words
+     *
+     * Any 64 bit seed is spread over the state with splitmix64, so nearby seeds (1, 2, 3...) still give unrelated
+     * sequences. It meets the standard's requirements for a random bit generator, so it also works with
+     * std::shuffle and the std distributions
+     */
+    class Generator {
+    public:
+        using result_type = std::uint64_t;
+
+        explicit Generator(std::uint64_t seed = 0) {this->seed(seed);}
+
+        void seed(std::uint64_t seed);
+        result_type operator()();
+        std::uint32_t Below(std::uint32_t bound);
+
+        static constexpr result_type min() {return 0;}
+        static constexpr result_type max() {return ~result_type(0);}
+
+    private:
+        std::uint64_t State[4];
+    };
+
+    /**
+     * Resets the generator, the same seed always gives the same sequence
+     *
+     * @param seed: Any number
+     */
+    inline void Generator::seed(std::uint64_t seed) {
+        for (std::uint64_t& Word : State) {
+            seed += 0x9E3779B97F4A7C15;
+            std::uint64_t Mixed = seed;
+            Mixed = (Mixed ^ (Mixed >> 30))*0xBF58476D1CE4E5B9;
+            Mixed = (Mixed ^ (Mixed >> 27))*0x94D049BB133111EB;
+            Word = Mixed ^ (Mixed >> 31);
+        }
+    }
+
+    inline Generator::result_type Generator::operator()() {
+        const std::uint64_t Result = ((State[1]*5 << 7) | (State[1]*5 >> 57))*9;
+        const std::uint64_t Shifted = State[1] << 17;
+
+        State[2] ^= State[0];
+        State[3] ^= State[1];
+        State[1] ^= State[2];
+        State[0] ^= State[3];
+        State[2] ^= Shifted;
+        State[3] = (State[3] << 45) | (State[3] >> 19);
+        return Result;
+    }
+
+    /**
+     * Draws a uniform number in [0, bound) without dividing in the common case (Lemire's multiply and reject)
+     *
+     * @param bound: Number of possible results, more than 0
+     */
+    inline std::uint32_t Generator::Below(std::uint32_t bound) {
+        std::uint64_t Product = ((*this)() >> 32)*bound;
+        if ((std::uint32_t)Product < bound) {
+            // Results below this come up once too often, 2^32 isn't a multiple of bound
+            const std::uint32_t Threshold = (0u - bound)%bound;
+            while ((std::uint32_t)Product < Threshold) {
+                Product = ((*this)() >> 32)*bound;
+            }
+        }
+        return Product >> 32;
+    }
+}
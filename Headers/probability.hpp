@@ -0,0 +1,81 @@
+#pragma once
+
+#include "tiles.hpp"
+#include "solver.hpp"
+
+#include <algorithm>
+#include <utility>
+#include <atomic>
+#include <thread>
+#include <vector>
+#include <cmath>
+
+namespace Probability {
+
+    /**
+     * One independent part of the frontier
+     *
+     * Tiles next to exactly the same numbers are interchangeable, so they are searched as one group that holds
+     * anywhere from none to all of its tiles in mines. Groups are in search order.
+     */
+    struct Component {
+        std::vector<int> Cells;         // Grid positions, group by group
+        std::vector<int> GroupStart;    // Tiles of each group
+        std::vector<int> Needed;        // Mines each constraint still needs
+        std::vector<int> MemberStart;   // Tiles, then groups, of each constraint
+        std::vector<int> Members;
+        std::vector<int> LinkStart;     // Constraints of each tile, then of each group
+        std::vector<int> Links;
+
+        std::vector<double> Weights;        // Arrangements by number of mines
+        std::vector<double> MineWeights;    // Mines in each group over those arrangements, one row of groups per count
+    };
+
+    /**
+     * Exact chance of every tile being a mine, given what a player can see
+     *
+     * Tiles the solver can prove are settled first. The rest of the frontier is split into independent components,
+     * every arrangement of mines in each component is counted by how many mines it uses, and the components are
+     * combined by weighting each total with the number of ways the remaining mines fit in the tiles away from the
+     * frontier. Components big enough are searched on every configured thread. Engines keep their buffers between
+     * calls, so reuse one per thread.
+     */
+    class Engine {
+    public:
+        const std::vector<double>& Compute(const Tiles::Board& board);
+
+        // False if some component was too big to search and its numbers were ignored
+        bool Exact() const {return IsExact;}
+
+    private:
+        // Revealed number with unknown neighbours, Mask has bit (dr + 1)*3 + (dc + 1) for the neighbour at (dr,dc)
+        struct Constraint {
+            int Index;
+            unsigned Mask;
+            int Needed;
+        };
+
+        enum : unsigned char {UNKNOWN, SAFE, MINE};
+
+        Solver::Engine Solver;
+        std::vector<double> Odds;
+        bool IsExact = true;
+        int Rows = 0;
+        int Columns = 0;
+        int Threads = 1;
+
+        std::vector<signed char> View;
+        std::vector<unsigned char> Known;
+        std::vector<Constraint> Constraints;
+        std::vector<int> Parent;
+        std::vector<int> CellAt;
+        std::vector<int> Frontier;
+        std::vector<Component> Components;
+
+        int root(int cell);
+        void findComponents();
+        void order(Component& component);
+        bool enumerate(Component& component, int most_mines);
+        void combine(int remaining_mines, int interior);
+    };
+}
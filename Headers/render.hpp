@@ -0,0 +1,52 @@
+#pragma once
+
+#include "responses.hpp"
+#include "output.hpp"
+#include "tiles.hpp"
+
+#include <iostream>
+#include <sstream>
+#include <iomanip>
+#include <cstdint>
+#include <utility>
+#include <memory>
+#include <string>
+
+namespace Render {
+
+    /**
+     * Shows a game to the player, the game loop only talks to one of these
+     *
+     * Every call does nothing unless a backend overrides it, so a backend only implements what it can show. The null
+     * backend overrides nothing, which leaves only the engine to measure
+     */
+    class Base {
+    public:
+        virtual ~Base() {}
+
+        virtual void Dashboard(const Tiles::View& board) {(void)board;}
+        virtual void Log(States::Log key, const std::pair<int,int>& tile) {(void)key; (void)tile;}
+        virtual void Seed(std::uint64_t seed) {(void)seed;}
+        virtual void Reveal(const Responses::Tap& response) {(void)response;}
+        virtual void Flag(const std::pair<int,int>& tile, const Responses::Flag& response) {(void)tile; (void)response;}
+        virtual void Step(const Responses::Step& response) {(void)response;}
+        virtual void Reset() {}
+        virtual void Pan(int rows, int columns) {(void)rows; (void)columns;}
+        virtual void Centre(const std::pair<int,int>& tile) {(void)tile;}
+        virtual void Follow(const std::pair<int,int>& tile) {(void)tile;}
+        virtual void Quit(const Responses::SessionStats& stats) {(void)stats;}
+
+        // Only used when playing from the keyboard, see keyboard.hpp
+        virtual void Cursor(const std::pair<int,int>& tile) {(void)tile;}
+        virtual void Typing(const std::string& text, bool editing) {(void)text; (void)editing;}
+        virtual void Clock(long long seconds) {(void)seconds;}
+
+        // Called before every command is read, and before every empty line is read again
+        virtual void Prompt() {}
+        // Called before every move is read
+        virtual void Flush() {}
+    };
+
+    std::unique_ptr<Base> Create(const std::string& name);
+    const char* Names();
+}
@@ -0,0 +1,104 @@
+#pragma once
+
+#include "responses.hpp"
+#include "config.hpp"
+#include "game.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <fcntl.h>      // For open
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>     // For close
+
+namespace Replay {
+
+    // Bumped whenever the format changes, older recordings are then refused
+    constexpr std::uint32_t VERSION = 1;
+
+    /**
+     * One input that changed the game
+     *
+     * Every board's seed is stored with the tap that started it, so a replay deals the same boards even when they
+     * came from the no-guess pool
+     */
+    struct Event {
+        States::Input Key = States::Input::Bad;     // Tap, Flag, Reset, Undo or Redo
+        std::pair<int,int> Tile = {0,0};            // Tap and Flag only
+        std::uint32_t Delay = 0;                    // Milliseconds since the event before
+        bool Starts = false;                        // Tap that started a board
+        std::uint64_t Seed = 0;                     // Of that board
+        std::uint32_t Check = 0;                    // Fingerprint of the response
+    };
+
+    std::uint32_t Fingerprint(const Responses::Tap& response);
+    std::uint32_t Fingerprint(const Responses::Flag& response);
+    std::uint32_t Fingerprint(const Responses::Step& response);
+    std::uint32_t Apply(Minesweeper::Game& game, const Event& event, Responses::Tap& tap, Responses::Step& step);
+
+    /**
+     * Writes a session to a file as it is played
+     *
+     * A recording starts with the board settings and the game's seed. Every event after that is a varint of its
+     * delay, key and start bit, the tile as two varints, the board seed as a varint if it started a board, and a 4
+     * byte fingerprint of the response. A tap usually takes 7 bytes.
+     */
+    class Recorder {
+    public:
+        Recorder(const std::string& path, const Config::Settings& settings, std::uint64_t seed);
+
+        bool Valid() const {return Out.good();}
+        void Record(Event event);
+
+    private:
+        std::ofstream Out;
+        std::chrono::steady_clock::time_point Last;
+        std::vector<unsigned char> Buffer;
+    };
+
+    /**
+     * Reads back a recording, one event at a time
+     *
+     * The file is mapped and read front to back, so the kernel reads ahead and pages that were read can be dropped
+     * again. However big a recording is, reading it only keeps a few pages of it in memory
+     */
+    class Reader {
+    public:
+        explicit Reader(const std::string& path);
+        ~Reader();
+        Reader(const Reader&) = delete;
+        Reader& operator=(const Reader&) = delete;
+
+        bool Valid() const {return Good;}
+        bool Done() const {return Position == Bytes;}   // Every event was read
+        const Config::Settings& getSettings() const {return Settings;}
+        std::uint64_t getSeed() const {return Seed;}
+        bool Next(Event& event);
+
+    private:
+        const unsigned char* Data = nullptr;
+        std::size_t Bytes = 0;
+        std::size_t Position = 0;
+        bool Good = false;
+        Config::Settings Settings;
+        std::uint64_t Seed = 0;
+
+        bool varint(std::uint64_t& value);
+    };
+
+    struct Report {
+        bool Valid = false;         // The recording could be read at all
+        bool Complete = false;      // It was read to the end, without a damaged event
+        long long Events = 0;
+        long long Mismatches = 0;   // Events whose response differs from the recorded one
+        long long FirstMismatch = -1;
+    };
+
+    Report Verify(const std::string& path, int threads);
+}
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <utility>
+#include <string>
 #include <vector>
 
 namespace States {
@@ -8,8 +9,14 @@ namespace States {
         Tap,
         Flag,
         Reset,
+        Undo,
+        Redo,
+        Save,
+        Load,
         Quit,
-        Bad
+        Bad,
+        Pan,        // Tile holds the rows and columns to move the window by
+        View
     };
 
     enum class Game {
@@ -33,7 +40,12 @@ namespace States {
         Failed,
         Bad,
         Win,
-        Lose
+        Lose,
+        Undo,
+        Redo,
+        Save,
+        Load,
+        Guess       // A no-guess board couldn't be found, the one dealt may need a guess
     };
 
 }
@@ -41,12 +53,13 @@ namespace States {
 namespace Responses {
 
     struct Input {
-        std::pair<char,char> Tile;
+        std::pair<int,int> Tile;
+        std::string Path;   // Snapshot file, for Save and Load
         States::Input Key;
     };
 
     struct Tap {
-        std::vector<std::pair<std::pair<char,char>,int>> Tiles;
+        std::vector<std::pair<std::pair<int,int>,int>> Tiles;
         States::Game State;
         int NumTilesLeft;
         int NumFlags;
@@ -57,12 +70,22 @@ namespace Responses {
         int NumFlags;
     };
 
+    // A move undone or redone
+    struct Step {
+        std::vector<std::pair<std::pair<int,int>,int>> Tiles;  // Every tile that changed, with what it shows now:
+                                                            // its number, 9 for a mine, -1 hidden or -2 flagged
+        States::Game State;
+        int NumTilesLeft;
+        int NumFlags;
+    };
+
     // idk where else to put this
+    // 64 bit, since a simulated session plays millions of games and reveals billions of tiles
     struct SessionStats {
-        int BoardsPlayed = 0;
-        int GamesWon = 0;
-        int GamesLost = 0;
-        int TilesRevealed = 0;
+        long long BoardsPlayed = 0;
+        long long GamesWon = 0;
+        long long GamesLost = 0;
+        long long TilesRevealed = 0;
     };
 
 }
\ No newline at end of file
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <unistd.h>     // For write
+
+namespace Screen {
+
+    constexpr int DEFAULT = -1;     // Colour of text with no colour set
+
+    struct Metrics {
+        long long Frames = 0;
+        long long Bytes = 0;        // Over every frame
+        long long Cells = 0;        // Cells drawn over every frame, unchanged ones drawn to bridge gaps included
+        long long LastBytes = 0;
+        long long LastCells = 0;
+        double Seconds = 0;         // Spent building and writing every frame
+        double LastSeconds = 0;
+    };
+
+    /**
+     * A model of the terminal, drawn into freely and then written out a frame at a time
+     *
+     * Drawing only touches the back buffer. Flushing compares it with the front buffer (what the terminal shows),
+     * and sends only the cells that differ: each run of changed cells in a row takes one cursor move, colours are
+     * only set when they change, and short gaps of unchanged cells are redrawn rather than jumped over when that is
+     * shorter. The whole frame goes out in a single write.
+     *
+     * A rectangle can be scrolled up in place. On terminals with left/right margins (DECLRMM) the terminal scrolls
+     * it itself, so a scroll costs a fixed number of bytes however much is in the rectangle; anywhere else it's
+     * drawn like any other change
+     *
+     * Every cell is one column wide and holds a single UTF-8 character of up to 4 bytes
+     */
+    class Buffer {
+    public:
+        Buffer(int rows, int columns);
+
+        void Put(int row, int column, const char* glyph, int colour = DEFAULT);
+        int Print(int row, int column, const std::string& text, int colour = DEFAULT);
+        void Scroll(int top, int bottom, int left, int right);
+        void Invalidate();
+        void Park(int row, int column);
+        void useMargins(bool enabled) {Margins = enabled;}
+        std::size_t Flush(int descriptor = STDOUT_FILENO);
+
+        int getRows() const {return Rows;}
+        int getColumns() const {return Columns;}
+        const Metrics& getMetrics() const {return Usage;}
+
+    private:
+        struct Cell {
+            std::uint32_t Glyph;    // UTF-8 bytes, first byte lowest
+            int Colour;
+
+            bool operator==(const Cell& other) const {return Glyph == other.Glyph && Colour == other.Colour;}
+            bool operator!=(const Cell& other) const {return !(*this == other);}
+        };
+
+        int Rows;
+        int Columns;
+        std::vector<Cell> Front;
+        std::vector<Cell> Back;
+        std::vector<char> Dirty;    // Rows drawn into since the last frame, the only ones compared
+        bool Full = true;           // The terminal's contents are unknown, so the next frame clears it first
+        int ParkRow = 0;
+        int ParkColumn = 0;
+        bool Margins = false;       // The terminal can scroll part of a line, see useMargins
+        int Region[4] = {};         // Top, bottom, left and right of the rectangle the terminal will scroll
+        int Scrolls = 0;            // Lines the terminal will scroll it by in the next frame
+        std::string Frame;          // Reused, so frames stop allocating once it has grown to fit
+        Metrics Usage;
+
+        bool visible(int row, int column) const;
+        void shift(std::vector<Cell>& cells, const int region[4], int lines);
+        void moveTo(int row, int column);
+        void append(const Cell& cell, int& colour);
+    };
+}
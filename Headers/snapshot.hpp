@@ -0,0 +1,71 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>   // For rename
+#include <cstring>
+#include <fstream>
+#include <string>
+
+#include <fcntl.h>      // For open
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>     // For close
+
+namespace Snapshot {
+
+    // Bumped whenever the layout below or the board's cell layout changes, older files are then refused
+    constexpr std::uint32_t VERSION = 2;
+
+    /**
+     * Start of every snapshot file, followed by the grid positions of every mine (int32, row major order) and then
+     * the board's cells (one byte per tile, row major order)
+     *
+     * Every field has a fixed size and offset and is stored in the machine's own (little endian) byte order, so a
+     * mapped file is used as is. The cells carry the mine, revealed and flagged bits along with every tile's number,
+     * so loading a board is two copies.
+     */
+    struct Header {
+        char Magic[8];
+        std::uint32_t Version;
+        std::uint32_t Size;             // Of the header, in bytes
+        std::int32_t Rows;
+        std::int32_t Columns;
+        std::int32_t Mines;
+        std::int32_t State;             // States::Game
+        std::uint64_t Seed;
+        std::int32_t Revealed;
+        std::int32_t Flagged;
+        std::int64_t BoardsPlayed;
+        std::int64_t GamesWon;
+        std::int64_t GamesLost;
+        std::int64_t TilesRevealed;
+        std::uint64_t Checksum;         // Of the whole file, with this field as 0
+    };
+    static_assert(sizeof(Header) == 88, "Snapshot header must keep its layout");
+
+    bool Save(const std::string& path, Header header, const int* mines, const unsigned char* cells);
+
+    /**
+     * A snapshot file mapped into memory, read only
+     *
+     * Opening checks everything that can be checked without knowing the game it is for: the magic, version, sizes
+     * and checksum. The mapping lasts as long as the object.
+     */
+    class File {
+    public:
+        explicit File(const std::string& path);
+        ~File();
+        File(const File&) = delete;
+        File& operator=(const File&) = delete;
+
+        bool Valid() const {return Data != nullptr;}
+        const Header& getHeader() const {return *reinterpret_cast<const Header*>(Data);}
+        const int* getMines() const {return reinterpret_cast<const int*>(Data + sizeof(Header));}
+        const unsigned char* getCells() const {return Data + sizeof(Header) + sizeof(int)*getHeader().Mines;}
+
+    private:
+        const unsigned char* Data = nullptr;
+        std::size_t Bytes = 0;
+    };
+}
@@ -0,0 +1,76 @@
+#pragma once
+
+#include "tiles.hpp"
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+namespace Solver {
+
+    // What can be proven about the hidden tiles of a board from the numbers a player can see
+    struct Result {
+        std::vector<std::pair<int,int>> Safe;
+        std::vector<std::pair<int,int>> Mines;
+        bool Searched = false;  // The rules stalled and the frontier had to be searched
+        bool Complete = true;   // False if part of the frontier was too big to search
+    };
+
+    /**
+     * Deterministic Minesweeper solver
+     *
+     * Works through every revealed number with single tile and pairwise (subset) rules, and only searches every
+     * arrangement of mines on the frontier once the rules stall. Flags are the player's guesses, so they are treated
+     * as hidden tiles. Engines keep their buffers between calls, so reuse one per thread.
+     */
+    class Engine {
+    public:
+        const Result& Solve(const Tiles::Board& board);
+
+    private:
+        // Revealed number with hidden neighbours. Bit (dr + 1)*3 + (dc + 1) of a mask is the neighbour at (dr,dc)
+        struct Constraint {
+            int Index;
+            unsigned Mask;      // Hidden neighbours that are not proven yet
+            int Count;          // Mines among them
+        };
+
+        enum : unsigned char {UNKNOWN, SAFE, MINE};
+
+        Result Answer;
+        int Rows = 0;
+        int Columns = 0;
+        int TotalMines = 0;
+        int RemainingMines = 0;
+        bool Progress = false;
+
+        std::vector<signed char> View;
+        std::vector<unsigned char> Known;
+        std::vector<Constraint> Constraints;
+        std::vector<int> ConstraintAt;
+        std::vector<int> Queue;             // Constraints next to tiles proven since they were last looked at
+        std::vector<unsigned char> Queued;
+
+        // Frontier search
+        std::vector<int> Parent;
+        std::vector<std::pair<int,int>> Grouped;
+        std::vector<int> Cells;
+        std::vector<int> CellAt;
+        std::vector<int> Links;
+        std::vector<int> LinkStart;
+        std::vector<int> Needed;
+        std::vector<int> Placed;
+        std::vector<int> Open;
+        std::vector<signed char> Value;
+        std::vector<unsigned char> Seen;
+
+        void deduce(int index, unsigned char value);
+        void deduceFrame(int index, unsigned long long framed, unsigned char value);
+        void findConstraints();
+        void applyRules();
+        void applyTotal();
+        void search();
+        int root(int cell);
+        void searchComponent(int first, int last);
+    };
+}
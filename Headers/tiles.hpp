@@ -1,19 +1,139 @@
 #pragma once
 
 #include "responses.hpp"
+#include "config.hpp"
+#include "counts.hpp"
+#include "prng.hpp"
+#include "memory.hpp"
 
 #include <algorithm>
 #include <utility>
-#include <random>
+#include <limits>
+#include <cstdint>
 #include <vector>
-#include <stack>
-#include <map>
-#include <set>
+#include <deque>
+#include <atomic>
+#include <mutex>
+#include <thread>
 
 namespace Tiles
 {
+    // Values of unrevealed tiles in a board view, revealed tiles show their number (0-8)
+    constexpr signed char HIDDEN = -1;
+    constexpr signed char FLAGGED = -2;
 
-    void generateBoard(const std::pair<char,char>& safe_tile);
-    Responses::Tap Tap(const std::pair<char,char>& tapped_tile);
-    Responses::Flag Flag(const std::pair<char,char>& flagged_tile);
-}
\ No newline at end of file
+    // Tiles revealed by (part of) a cascade
+    struct Fill {
+        std::vector<std::pair<std::pair<int,int>,int>> Tiles;
+        int Revealed = 0;
+        int Unflagged = 0;
+        int Skip = -1;  // Grid position that is revealed but already listed by the caller
+        Memory::Buffer<int>* Deltas = nullptr;  // Where the runs of revealed tiles are logged, see Board::Move
+        size_t From = 0;                        // Runs before this belong to earlier moves
+    };
+
+    /**
+     * What a player can see of a board, which is all it takes to draw one
+     */
+    class View {
+    public:
+        virtual ~View() {}
+
+        virtual const Config::Settings& getSettings() const = 0;
+        virtual signed char getShown(const std::pair<int,int>& tile) const = 0;
+        virtual bool tileMine(const std::pair<int,int>& tile) const = 0;   // Only asked once the board is lost
+    };
+
+    /**
+     * A single Minesweeper board
+     *
+     * Every tile is one byte in a row major grid, holding its number of adjacent mines along with mine, revealed
+     * and flagged bits. Boards share nothing, so any number of them can be used at once from different threads.
+     *
+     * Everything a board needs for one game comes out of its own arena, which is emptied in one go when the next
+     * board is generated. The only exception is the move history, which has no upper bound and so lives on the heap,
+     * keeping its capacity from game to game
+     */
+    class Board final : public View {
+    public:
+        explicit Board(const Config::Settings& settings);
+        Board(const Board& other);
+        Board& operator=(const Board& other);
+
+        void generateBoard(const std::pair<int,int>& safe_tile, std::uint64_t seed);
+        void loadBoard(const std::vector<int>& mines);
+        bool loadState(const unsigned char* cells, const int* mines, int revealed, int flagged);
+        Responses::Tap Tap(const std::pair<int,int>& tapped_tile);
+        void Tap(const std::pair<int,int>& tapped_tile, Responses::Tap& response);
+        Responses::Flag Flag(const std::pair<int,int>& flagged_tile);
+        bool Undo(Responses::Step& step);
+        bool Redo(Responses::Step& step);
+
+        const Config::Settings& getSettings() const override {return Settings;}
+        int getRemaining() const {return TotalTiles - NumRevealed;}
+        int getNumFlags() const {return NumFlagged;}
+        const Memory::Buffer<int>& getMines() const {return Mines;}
+        const Memory::Buffer<unsigned char>& getCells() const {return Cells;}  // Raw, in the layout of tiles.cpp
+        const Memory::Stats& getMemory() const {return Arena.getStats();}
+
+        // What a player can see
+        bool tileFlagged(const std::pair<int,int>& tile) const;
+        bool tileRevealed(const std::pair<int,int>& tile) const;
+        int getNumber(const std::pair<int,int>& tile) const;
+        signed char getShown(const std::pair<int,int>& tile) const override;
+        void getView(std::vector<signed char>& view) const;
+        bool tileMine(const std::pair<int,int>& tile) const override;   // Only for showing the board once it's lost
+
+    private:
+        /**
+         * A move that changed the board, its changes are the pairs Deltas[Begin, End). A pair (first, count) is a
+         * run of tiles that were revealed, a pair (tile, 0) a tile that lost its flag to the reveal
+         */
+        struct Move {
+            int Tile;       // Grid position tapped or flagged
+            bool Flag;
+            int Begin;
+            int End;
+        };
+
+        Config::Settings Settings;
+        int TotalTiles;
+
+        Memory::Arena Arena;
+        Memory::Buffer<unsigned char> Cells;
+        Memory::Buffer<unsigned char> Plane;    // 1 for every mine, 0 otherwise
+        Memory::Buffer<int> Mines;              // Grid positions of every mine, in row major order
+        Memory::Buffer<int> Seeds;              // Blank tiles a cascade still has to grow from
+        Memory::Buffer<unsigned char> Sums;     // Working space for counting mines
+        Memory::Buffer<Move> Moves;             // Every move since the board was generated, undone ones included
+        Memory::Buffer<int> Deltas;             // Changes of every move, back to back
+        int Played = 0;                         // Moves that are not undone
+        int NumRevealed = 0;
+        int NumFlagged = 0;
+
+        int index(const std::pair<int,int>& tile) const;
+        std::pair<int,int> tile(int index) const;
+
+        void clean();
+        void generateMines(const std::pair<int,int>& safe_tile, Prng::Generator& rng);
+        void setTiles();
+        void reveal(int index);
+        void record(int index, bool flag);
+        void logRun(int index, Fill& fill);
+
+        bool blank(int index) const;
+        void revealInto(int index, Fill& fill);
+        template <typename Stack>
+        void scanRun(int from, int to, Stack& seeds, Fill& fill);
+        template <typename Stack, typename Outside>
+        void flood(int first_row, int last_row, Stack& seeds, Fill& fill, Outside outside, int budget);
+        void parallelFlood(Memory::Buffer<int>& seeds, Fill& fill);
+        void findAllAdjacent(
+            const std::pair<int,int>& starting_tile,
+            std::vector<std::pair<std::pair<int,int>,int>>& tiles
+        );
+
+        int getNumAdjacentMines(const std::pair<int,int>& tile) const;
+        signed char shown(int index) const;
+    };
+}
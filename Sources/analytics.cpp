@@ -0,0 +1,176 @@
+#include "analytics.hpp"
+
+namespace {
+
+    // A board being played, until it is reset, replaced or the recording ends
+    struct Board {
+        bool Active = false;
+        std::array<int,4> Opening;
+        long long Moves = 0;
+        std::uint64_t Start = 0;
+        std::uint64_t Last = 0;
+    };
+
+}
+
+namespace Analytics {
+
+    /**
+     * Counts a value
+     *
+     * @param value: Any value
+     */
+    void Histogram::Add(std::uint64_t value) {
+        int Bucket = value;
+        if (value >> SUB_BITS) {
+            const int Exponent = 63 - __builtin_clzll(value);
+            const int Sub = (value >> (Exponent - SUB_BITS)) & ((1 << SUB_BITS) - 1);
+            Bucket = ((Exponent - SUB_BITS + 1) << SUB_BITS) + Sub;
+        }
+        Buckets[Bucket]++;
+        Total++;
+        Sum += value;
+        Largest = std::max(Largest,value);
+    }
+
+    /**
+     * Adds another histogram's counts to this one
+     *
+     * @param other: Histogram to add
+     */
+    void Histogram::Merge(const Histogram& other) {
+        for (int i = 0; i < BUCKETS; i++) {
+            Buckets[i] += other.Buckets[i];
+        }
+        Total += other.Total;
+        Sum += other.Sum;
+        Largest = std::max(Largest,other.Largest);
+    }
+
+    /**
+     * Returns the value that p percent of the counted values are at most, to within a bucket
+     *
+     * @param p: Percentile, 0-100
+     *
+     * @return The middle of the bucket it falls in, 0 if nothing was counted
+     */
+    std::uint64_t Histogram::Percentile(double p) const {
+        const long long Rank = std::max<long long>(1,(long long)(p/100*Total + 0.5));
+        long long Seen = 0;
+        for (int Bucket = 0; Bucket < BUCKETS; Bucket++) {
+            Seen += Buckets[Bucket];
+            if (Seen < Rank) {continue;}
+            if (Bucket < (1 << SUB_BITS)) {return Bucket;}
+
+            const int Shift = (Bucket >> SUB_BITS) - 1;
+            const std::uint64_t Low = (std::uint64_t)((1 << SUB_BITS) + (Bucket & ((1 << SUB_BITS) - 1))) << Shift;
+            return std::min(Largest,Low + (((std::uint64_t)1 << Shift) >> 1));
+        }
+        return 0;
+    }
+
+    /**
+     * Adds the session stats of one recording
+     *
+     * @param stats: Stats of the game a recording was played on
+     */
+    void Summary::Add(const Responses::SessionStats& stats) {
+        Stats.BoardsPlayed += stats.BoardsPlayed;
+        Stats.GamesWon += stats.GamesWon;
+        Stats.GamesLost += stats.GamesLost;
+        Stats.TilesRevealed += stats.TilesRevealed;
+    }
+
+    /**
+     * Adds another summary to this one
+     *
+     * @param other: Summary to add, e.g. from another thread
+     */
+    void Summary::Merge(const Summary& other) {
+        Recordings += other.Recordings;
+        Unreadable += other.Unreadable;
+        Damaged += other.Damaged;
+        Events += other.Events;
+        Add(other.Stats);
+
+        TilesPerTap.Merge(other.TilesPerTap);
+        MovesPerBoard.Merge(other.MovesPerBoard);
+        BoardMillis.Merge(other.BoardMillis);
+        FirstLossMillis.Merge(other.FirstLossMillis);
+        for (const auto& Entry : other.Openings) {
+            Opening& Same = Openings[Entry.first];
+            Same.Boards += Entry.second.Boards;
+            Same.Won += Entry.second.Won;
+        }
+    }
+
+    /**
+     * Plays a recording back headless and adds what happened in it to a summary
+     *
+     * Only the game being replayed and a few pages of the file are in memory at any time
+     *
+     * @param path: Recording to read
+     * @param summary: Summary to add to
+     */
+    void Analyze(const std::string& path, Summary& summary) {
+        summary.Recordings++;
+        Replay::Reader In(path);
+        if (!In.Valid()) {
+            summary.Unreadable++;
+            return;
+        }
+
+        const Config::Settings& Settings = In.getSettings();
+        const int TotalTiles = Settings.Rows*Settings.Columns;
+        Minesweeper::Game Game(Settings,In.getSeed());
+        Responses::Tap Tap;
+        Responses::Step Step;
+
+        Board Current;
+        std::uint64_t Clock = 0;
+        bool Lost = false;
+        const auto finish = [&]() {
+            if (!Current.Active) {return;}
+            Opening& Cell = summary.Openings[Current.Opening];
+            Cell.Boards++;
+            Cell.Won += Game.getState() == States::Game::Win;
+            summary.MovesPerBoard.Add(Current.Moves);
+            summary.BoardMillis.Add(Current.Last - Current.Start);
+            Current.Active = false;
+        };
+
+        Replay::Event Event;
+        while (In.Next(Event)) {
+            Clock += Event.Delay;
+            summary.Events++;
+            if (Event.Key == States::Input::Reset || Event.Starts) {finish();}
+
+            const bool Taps = Event.Key == States::Input::Tap && !Game.Over();
+            const int Before = Event.Starts ? TotalTiles : Game.getBoard().getRemaining();
+            Replay::Apply(Game,Event,Tap,Step);
+
+            if (Event.Starts) {
+                Current.Active = true;
+                Current.Opening = {Settings.Rows,Settings.Columns,Event.Tile.first,Event.Tile.second};
+                Current.Moves = 0;
+                Current.Start = Clock;
+            }
+            if (Current.Active && Event.Key != States::Input::Reset) {
+                Current.Moves++;
+                Current.Last = Clock;
+            }
+            if (Taps && Tap.State != States::Game::Lose) {
+                summary.TilesPerTap.Add(Before - Game.getBoard().getRemaining());
+            }
+            if (!Lost && Game.getState() == States::Game::Lose) {
+                Lost = true;
+                summary.FirstLossMillis.Add(Clock);
+            }
+        }
+        finish();
+
+        summary.Damaged += !In.Done();
+        summary.Add(Game.getStats());
+    }
+
+}
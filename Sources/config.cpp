@@ -0,0 +1,123 @@
+#include "config.hpp"
+
+namespace {
+
+    // Constants
+    constexpr int MAX_SIDE = 100000;
+    constexpr long long MAX_TILES = 1000000000;
+    constexpr int SAFE_AREA = 9;    // First tap and its neighbours are never mines
+    constexpr int MAX_THREADS = 256;
+
+    /**
+     * Reads a positive whole number
+     *
+     * @param arg: Input string
+     * @param value: Where the number is written to
+     *
+     * @return If the whole string was a valid number
+     */
+    bool parseNumber(const char* arg, int& value) {
+        if (arg == nullptr) {return false;}
+
+        char* End;
+        const long Number = std::strtol(arg,&End,10);
+        if (*arg == '\0' || *End != '\0' || Number < 0 || Number > MAX_TILES) {return false;}
+
+        value = Number;
+        return true;
+    }
+
+    /**
+     * Reads a board seed, written in hexadecimal like the seeds the game logs
+     *
+     * @param arg: Input string
+     * @param value: Where the seed is written to
+     *
+     * @return If the whole string was a valid seed
+     */
+    bool parseSeed(const char* arg, unsigned long long& value) {
+        if (arg == nullptr || *arg == '\0' || *arg == '-' || std::strlen(arg) > 16) {return false;}
+
+        char* End;
+        value = std::strtoull(arg,&End,16);
+        return *End == '\0';
+    }
+
+}
+
+namespace Config {
+
+    /**
+     * Reads board settings from the command line
+     *
+     * -r/--rows N, -c/--columns N, -m/--mines N, -t/--threads N, -g/--no-guess, -s/--seed HEX
+     *
+     * @param argc: Argument count
+     * @param argv: Arguments
+     * @param settings: Settings to fill in, anything not given keeps its default
+     *
+     * @return If every argument was valid
+     */
+    bool Parse(int argc, char* argv[], Settings& settings) {
+        for (int i = 1; i < argc; i++) {
+            const char* Arg = argv[i];
+            const char* Value = (i + 1 < argc) ? argv[i + 1] : nullptr;
+
+            if (!std::strcmp(Arg,"-g") || !std::strcmp(Arg,"--no-guess")) {
+                settings.NoGuess = true;
+                continue;
+            }
+
+            if (!std::strcmp(Arg,"-s") || !std::strcmp(Arg,"--seed")) {
+                if (!parseSeed(Value,settings.Seed)) {return false;}
+                i++;
+                continue;
+            }
+
+            int* Target;
+            if (!std::strcmp(Arg,"-r") || !std::strcmp(Arg,"--rows"))         {Target = &settings.Rows;}
+            else if (!std::strcmp(Arg,"-c") || !std::strcmp(Arg,"--columns")) {Target = &settings.Columns;}
+            else if (!std::strcmp(Arg,"-m") || !std::strcmp(Arg,"--mines"))   {Target = &settings.Mines;}
+            else if (!std::strcmp(Arg,"-t") || !std::strcmp(Arg,"--threads")) {Target = &settings.Threads;}
+            else {return false;}
+
+            if (!parseNumber(Value,*Target)) {return false;}
+            i++;
+        }
+
+        return ValidBoard(settings.Rows,settings.Columns,settings.Mines) &&
+               settings.Threads >= 1 && settings.Threads <= MAX_THREADS;
+    }
+
+    /**
+     * Checks a board size, wherever it came from, e.g. the command line or the header of a file
+     *
+     * @param rows: Number of rows
+     * @param columns: Number of columns
+     * @param mines: Number of mines
+     *
+     * @return If a board can be dealt with that size
+     */
+    bool ValidBoard(std::uint64_t rows, std::uint64_t columns, std::uint64_t mines) {
+        // Each side is checked first, so the product can't wrap
+        if (rows < 1 || rows > MAX_SIDE || columns < 1 || columns > MAX_SIDE) {return false;}
+        const std::uint64_t TotalTiles = rows*columns;
+        return TotalTiles <= MAX_TILES && TotalTiles > SAFE_AREA && mines >= 1 && mines <= TotalTiles - SAFE_AREA;
+    }
+
+    /**
+     * Outputs the command line usage
+     *
+     * @param program: Name the program was run as
+     */
+    void Usage(const char* program) {
+        std::cerr
+        << "Usage: " << program << " [-r ROWS] [-c COLUMNS] [-m MINES] [-t THREADS] [-g] [-s SEED]\n"
+        << "  Boards can be up to " << MAX_SIDE << " tiles a side (" << MAX_TILES << " tiles total)\n"
+        << "  Mines must leave at least " << SAFE_AREA << " tiles free for the first tap\n"
+        << "  Threads (1-" << MAX_THREADS << ") are used to reveal large cascades and generate no-guess boards\n"
+        << "  -g, --no-guess only deals boards that can be solved from the first tap without guessing\n"
+        << "  -s, --seed replays the board with that seed (as logged at the end of every game) from the same first tap\n";
+    }
+
+}
@@ -0,0 +1,83 @@
+#include "coords.hpp"
+
+namespace {
+
+    // Constants
+    constexpr int LETTERS = 26;
+    constexpr int MAX_COORDINATE = 1000000000;
+
+}
+
+namespace Coords {
+
+    /**
+     * Converts a row/column number into its letter label
+     *
+     * Labels count like spreadsheet columns, A-Z then AA-AZ, BA-BZ, ... ZZ, AAA
+     *
+     * @param n: Row/column number, starting at 1
+     *
+     * @return Letter label
+     */
+    std::string Label(int n) {
+        std::string Label;
+        while (n > 0) {
+            n--;
+            Label.insert(Label.begin(),'A' + n%LETTERS);
+            n /= LETTERS;
+        }
+        return Label;
+    }
+
+    /**
+     * Converts one half of a tile input into a row/column number
+     *
+     * Accepts either a letter label (case insensitive) or a plain number
+     *
+     * @param component: Input characters, not copied
+     * @param length: Number of characters
+     *
+     * @return Row/column number starting at 1, 0 if the input isn't valid
+     */
+    int Parse(const char* component, std::size_t length) {
+        if (!length) {return 0;}
+
+        const bool Numeric = std::isdigit((unsigned char)component[0]);
+        long long n = 0;
+        for (std::size_t i = 0; i < length; i++) {
+            const unsigned char c = component[i];
+            if (Numeric && std::isdigit(c)) {
+                n = n*10 + (c - '0');
+            } else if (!Numeric && std::isalpha(c)) {
+                n = n*LETTERS + (std::toupper(c) - 'A' + 1);
+            } else {
+                return 0;
+            }
+            if (n > MAX_COORDINATE) {return 0;}
+        }
+        return n;
+    }
+
+    /**
+     * Converts one half of a tile input into a row/column number
+     *
+     * @param component: Input string
+     *
+     * @return Row/column number starting at 1, 0 if the input isn't valid
+     */
+    int Parse(const std::string& component) {
+        return Parse(component.data(),component.size());
+    }
+
+    /**
+     * Formats a tile for displaying
+     *
+     * @param tile: Input tile
+     *
+     * @return 'ROW:COLUMN'
+     */
+    std::string Format(const std::pair<int,int>& tile) {
+        return '\'' + Label(tile.first) + ':' + Label(tile.second) + '\'';
+    }
+
+}
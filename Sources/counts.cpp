@@ -0,0 +1,217 @@
+#include "counts.hpp"
+
+namespace {
+
+    /*
+     * Every kernel works a row at a time in two passes
+     *
+     * 1. Vertical: sum the mine plane of the rows above, at and below into a scratch row that has a zero on
+     *    either end, so Sums[c + 1] = mines[r - 1][c] + mines[r][c] + mines[r + 1][c]
+     *
+     * 2. Horizontal: counts[r][c] = Sums[c] + Sums[c + 1] + Sums[c + 2] - mines[r][c]
+     *
+     * Both passes are plain shifted adds, which is what lets them run 16/32 tiles at a time. The most a
+     * byte can hold is 9, so the adds never overflow
+     */
+
+    /**
+     * Scalar version of both passes for columns [from, columns)
+     */
+    void scalarRow(
+        const unsigned char* above, const unsigned char* row, const unsigned char* below,
+        unsigned char* sums, unsigned char* counts, int from, int columns
+    ) {
+        for (int c = from; c < columns; c++) {
+            sums[c + 1] = (above ? above[c] : 0) + row[c] + (below ? below[c] : 0);
+        }
+        // The horizontal pass reads one past the vertical pass
+        for (int c = from ? from - 1 : 0; c < columns; c++) {
+            counts[c] = sums[c] + sums[c + 1] + sums[c + 2] - row[c];
+        }
+    }
+
+    void scalarKernel(const unsigned char* mines, unsigned char* counts, int rows, int columns, unsigned char* sums) {
+        for (int r = 0; r < rows; r++) {
+            const unsigned char* Row = mines + (long long)r*columns;
+            const unsigned char* Above = r > 0 ? Row - columns : nullptr;
+            const unsigned char* Below = r < rows - 1 ? Row + columns : nullptr;
+            scalarRow(Above,Row,Below,sums,counts + (long long)r*columns,0,columns);
+        }
+    }
+
+#ifdef COUNTS_SSE2
+    void sse2Kernel(const unsigned char* mines, unsigned char* counts, int rows, int columns, unsigned char* sums) {
+        const __m128i Zero = _mm_setzero_si128();
+        for (int r = 0; r < rows; r++) {
+            const unsigned char* Row = mines + (long long)r*columns;
+            const unsigned char* Above = r > 0 ? Row - columns : nullptr;
+            const unsigned char* Below = r < rows - 1 ? Row + columns : nullptr;
+            unsigned char* Out = counts + (long long)r*columns;
+
+            int c = 0;
+            for (; c + 16 <= columns; c += 16) {
+                __m128i Sum = _mm_loadu_si128((const __m128i*)(Row + c));
+                Sum = _mm_add_epi8(Sum,Above ? _mm_loadu_si128((const __m128i*)(Above + c)) : Zero);
+                Sum = _mm_add_epi8(Sum,Below ? _mm_loadu_si128((const __m128i*)(Below + c)) : Zero);
+                _mm_storeu_si128((__m128i*)(sums + c + 1),Sum);
+            }
+            // Finishes the vertical pass, and the horizontal pass for the last partial block
+            const int Tail = c;
+            scalarRow(Above,Row,Below,sums,Out,Tail,columns);
+
+            for (c = 0; c + 16 <= Tail; c += 16) {
+                __m128i Count = _mm_loadu_si128((const __m128i*)(sums + c));
+                Count = _mm_add_epi8(Count,_mm_loadu_si128((const __m128i*)(sums + c + 1)));
+                Count = _mm_add_epi8(Count,_mm_loadu_si128((const __m128i*)(sums + c + 2)));
+                Count = _mm_sub_epi8(Count,_mm_loadu_si128((const __m128i*)(Row + c)));
+                _mm_storeu_si128((__m128i*)(Out + c),Count);
+            }
+            for (; c < Tail; c++) {
+                Out[c] = sums[c] + sums[c + 1] + sums[c + 2] - Row[c];
+            }
+        }
+    }
+#endif
+
+#ifdef COUNTS_AVX2
+    __attribute__((target("avx2")))
+    void avx2Kernel(const unsigned char* mines, unsigned char* counts, int rows, int columns, unsigned char* sums) {
+        const __m256i Zero = _mm256_setzero_si256();
+        for (int r = 0; r < rows; r++) {
+            const unsigned char* Row = mines + (long long)r*columns;
+            const unsigned char* Above = r > 0 ? Row - columns : nullptr;
+            const unsigned char* Below = r < rows - 1 ? Row + columns : nullptr;
+            unsigned char* Out = counts + (long long)r*columns;
+
+            int c = 0;
+            for (; c + 32 <= columns; c += 32) {
+                __m256i Sum = _mm256_loadu_si256((const __m256i*)(Row + c));
+                Sum = _mm256_add_epi8(Sum,Above ? _mm256_loadu_si256((const __m256i*)(Above + c)) : Zero);
+                Sum = _mm256_add_epi8(Sum,Below ? _mm256_loadu_si256((const __m256i*)(Below + c)) : Zero);
+                _mm256_storeu_si256((__m256i*)(sums + c + 1),Sum);
+            }
+            const int Tail = c;
+            scalarRow(Above,Row,Below,sums,Out,Tail,columns);
+
+            for (c = 0; c + 32 <= Tail; c += 32) {
+                __m256i Count = _mm256_loadu_si256((const __m256i*)(sums + c));
+                Count = _mm256_add_epi8(Count,_mm256_loadu_si256((const __m256i*)(sums + c + 1)));
+                Count = _mm256_add_epi8(Count,_mm256_loadu_si256((const __m256i*)(sums + c + 2)));
+                Count = _mm256_sub_epi8(Count,_mm256_loadu_si256((const __m256i*)(Row + c)));
+                _mm256_storeu_si256((__m256i*)(Out + c),Count);
+            }
+            for (; c < Tail; c++) {
+                Out[c] = sums[c] + sums[c + 1] + sums[c + 2] - Row[c];
+            }
+        }
+    }
+#endif
+
+}
+
+namespace Counts {
+
+    /**
+     * Returns if the given kernel can run on this machine
+     *
+     * @param kernel: Kernel to check
+     */
+    bool Supported(Kernel kernel) {
+        switch (kernel) {
+            case Kernel::Scalar:
+                return true;
+            case Kernel::SSE2:
+#ifdef COUNTS_SSE2
+                return true;
+#else
+                return false;
+#endif
+            case Kernel::AVX2:
+#ifdef COUNTS_AVX2
+                return __builtin_cpu_supports("avx2");
+#else
+                return false;
+#endif
+        }
+        return false;
+    }
+
+    /**
+     * Returns the fastest kernel that can run on this machine
+     */
+    Kernel Best() {
+        static const Kernel Fastest =
+            Supported(Kernel::AVX2) ? Kernel::AVX2 :
+            Supported(Kernel::SSE2) ? Kernel::SSE2 : Kernel::Scalar;
+        return Fastest;
+    }
+
+    /**
+     * Returns the display name of a kernel
+     *
+     * @param kernel: Input kernel
+     */
+    const char* Name(Kernel kernel) {
+        switch (kernel) {
+            case Kernel::Scalar: return "scalar";
+            case Kernel::SSE2:   return "sse2";
+            case Kernel::AVX2:   return "avx2";
+        }
+        return "";
+    }
+
+    /**
+     * Counts the mines adjacent to every tile
+     *
+     * Mines are not counted as their own neighbour, so a mine's count is how many other mines touch it
+     *
+     * @param mines: Mine plane, one byte per tile in row major order, 1 for a mine and 0 otherwise
+     * @param counts: Output, one byte per tile in row major order
+     * @param rows: Number of rows
+     * @param columns: Number of columns
+     * @param kernel: Kernel to use, falls back to scalar if it can't run on this machine
+     */
+    void Compute(const unsigned char* mines, unsigned char* counts, int rows, int columns, Kernel kernel) {
+        std::vector<unsigned char> Sums(columns + 2);
+        Compute(mines,counts,rows,columns,kernel,Sums.data());
+    }
+
+    /**
+     * Counts the mines adjacent to every tile, with a row of working space owned by the caller so that nothing is
+     * allocated
+     *
+     * @param sums: Working space of columns + 2 bytes
+     */
+    void Compute(
+        const unsigned char* mines, unsigned char* counts, int rows, int columns, Kernel kernel,
+        unsigned char* sums
+    ) {
+        // Sums[0] and Sums[columns + 1] stay 0 for the edges of the board
+        std::fill(sums,sums + columns + 2,0);
+
+        if (!Supported(kernel)) {kernel = Kernel::Scalar;}
+        switch (kernel) {
+#ifdef COUNTS_AVX2
+            case Kernel::AVX2:
+                avx2Kernel(mines,counts,rows,columns,sums);
+                return;
+#endif
+#ifdef COUNTS_SSE2
+            case Kernel::SSE2:
+                sse2Kernel(mines,counts,rows,columns,sums);
+                return;
+#endif
+            default:
+                scalarKernel(mines,counts,rows,columns,sums);
+                return;
+        }
+    }
+
+    /**
+     * Counts the mines adjacent to every tile with the fastest kernel available
+     */
+    void Compute(const unsigned char* mines, unsigned char* counts, int rows, int columns) {
+        Compute(mines,counts,rows,columns,Best());
+    }
+
+}
@@ -0,0 +1,268 @@
+#include "game.hpp"
+
+namespace {
+
+    /**
+     * Checks a snapshot's game state and stats against its board, and each other. The board itself is checked as
+     * it loads
+     *
+     * @param header: Header of the snapshot, its size already matching the game's
+     *
+     * @return If a game could have been saved like this
+     */
+    bool playable(const Snapshot::Header& header) {
+        const States::Game State = (States::Game)header.State;
+        const std::int64_t Safe = (std::int64_t)header.Rows*header.Columns - header.Mines;
+
+        // A game is won exactly when every safe tile is revealed, which it can't be once lost
+        if ((State == States::Game::Win) != (header.Revealed == Safe)) {return false;}
+
+        // Saving takes a board that has been tapped, and that board is counted along with how it ended
+        if (header.BoardsPlayed < 1 || header.GamesWon < 0 || header.GamesLost < 0 || header.TilesRevealed < 0) {
+            return false;
+        }
+        if (header.GamesWon + header.GamesLost > header.BoardsPlayed) {return false;}
+        if (State == States::Game::Win && header.GamesWon < 1)  {return false;}
+        if (State == States::Game::Lose && header.GamesLost < 1) {return false;}
+        return true;
+    }
+
+}
+
+namespace Minesweeper {
+
+    /**
+     * Creates a game with randomly seeded boards
+     *
+     * @param settings: Board settings, assumed to already be validated by Config::Parse
+     */
+    Game::Game(const Config::Settings& settings) :
+        Game(settings,(std::uint64_t)std::random_device()() << 32 | std::random_device()())
+    {
+        Pinned = false;
+    }
+
+    /**
+     * Creates a game whose first board is generated from the given seed, and every later board from a seed drawn
+     * from it
+     *
+     * @param settings: Board settings, assumed to already be validated by Config::Parse
+     * @param seed: Seed of the first board
+     */
+    Game::Game(const Config::Settings& settings, std::uint64_t seed) :
+        Board(settings),
+        Seeds(seed),
+        Seed(seed),
+        Pinned(true)
+    {}
+
+    /**
+     * Taps a tile, generating a new board around it if this is the first tap since a reset. In no-guess mode the
+     * board comes from the pool if it has one ready for that tile, unless it has to come from a given seed. If no
+     * board that can be solved without guessing turns up, the one dealt may need a guess, which NeedsGuess tells
+     *
+     * Should not be called once the game is over
+     *
+     * @param tile: Input tile
+     *
+     * @return Revealed tiles along with the state of the game
+     */
+    Responses::Tap Game::Tap(const std::pair<int,int>& tile) {
+        Responses::Tap Response;
+        Tap(tile,Response);
+        return Response;
+    }
+
+    /**
+     * Taps a tile like above, filling in a response owned by the caller. Once the response and the board have
+     * grown to fit, playing any number of games this way doesn't allocate (no-guess boards aside)
+     *
+     * @param tile: Input tile
+     * @param response: Output, revealed tiles along with the state of the game
+     */
+    void Game::Tap(const std::pair<int,int>& tile, Responses::Tap& response) {
+        if (NewGame) {
+            NewGame = false;
+            Guessing = false;
+            Stats.BoardsPlayed++;
+            if (!Pinned && Pool && Pool->Take(tile,Seed)) {
+                Board.generateBoard(tile,Seed);
+            } else if (Board.getSettings().NoGuess) {
+                Guessing = !NoGuess::Generate(Board,tile,Seed,Solver);
+            } else {
+                Board.generateBoard(tile,Seed);
+            }
+        }
+
+        Board.Tap(tile,response);
+        Stats.TilesRevealed += response.Tiles.size();
+        State = response.State;
+
+        switch (State) {
+            case States::Game::Playon: {
+                break; // Do nothing
+            }
+
+            case States::Game::Win: {
+                Stats.GamesWon++;
+                break;
+            }
+
+            case States::Game::Lose: {
+                Stats.GamesLost++;
+                break;
+            }
+        }
+    }
+
+    /**
+     * Flags/unflags a tile
+     *
+     * Should only be called once the board has been generated and while the game isn't over
+     *
+     * @param tile: Input tile
+     */
+    Responses::Flag Game::Flag(const std::pair<int,int>& tile) {
+        return Board.Flag(tile);
+    }
+
+    /**
+     * Takes back the last move, even the one that ended the game
+     *
+     * Undoing a finished game takes its win or loss back out of the stats, tiles revealed stay counted
+     *
+     * @param step: Output, tiles whose view changed along with the new state of the game
+     *
+     * @return False if there is no move to undo
+     */
+    bool Game::Undo(Responses::Step& step) {
+        if (NewGame || !Board.Undo(step)) {return false;}
+
+        if (State == States::Game::Win) {Stats.GamesWon--;}
+        else if (State == States::Game::Lose) {Stats.GamesLost--;}
+        State = step.State;
+        return true;
+    }
+
+    /**
+     * Makes the last undone move again
+     *
+     * @param step: Output, tiles whose view changed along with the new state of the game
+     *
+     * @return False if there is no undone move
+     */
+    bool Game::Redo(Responses::Step& step) {
+        if (NewGame || !Board.Redo(step)) {return false;}
+
+        State = step.State;
+        if (State == States::Game::Win) {Stats.GamesWon++;}
+        else if (State == States::Game::Lose) {Stats.GamesLost++;}
+        return true;
+    }
+
+    /**
+     * Saves the board, its seed and the session stats to a snapshot file
+     *
+     * @param path: File to write, replaced if it exists
+     *
+     * @return False if there is no board yet or the file couldn't be written
+     */
+    bool Game::Save(const std::string& path) const {
+        if (NewGame) {return false;}
+
+        const Config::Settings& Settings = Board.getSettings();
+        Snapshot::Header Header = {};
+        Header.Rows = Settings.Rows;
+        Header.Columns = Settings.Columns;
+        Header.Mines = Settings.Mines;
+        Header.State = (std::int32_t)State;
+        Header.Seed = Seed;
+        Header.Revealed = Settings.Rows*Settings.Columns - Board.getRemaining();
+        Header.Flagged = Board.getNumFlags();
+        Header.BoardsPlayed = Stats.BoardsPlayed;
+        Header.GamesWon = Stats.GamesWon;
+        Header.GamesLost = Stats.GamesLost;
+        Header.TilesRevealed = Stats.TilesRevealed;
+        return Snapshot::Save(path,Header,Board.getMines().data(),Board.getCells().data());
+    }
+
+    /**
+     * Picks up a game from a snapshot file, boards after it are drawn from its seed as after Reset(seed)
+     *
+     * The file is mapped rather than read, and the board checked and copied straight out of it in one pass each, so
+     * even huge boards load in about the time it takes to read them
+     *
+     * @param path: File to load
+     * @param step: Output, every tile that isn't hidden, for redrawing the board
+     *
+     * @return False if the file can't be read, fails its checks, is for a board of another size, or holds a board,
+     * state or stats no game could have left. The game is left as it was
+     */
+    bool Game::Load(const std::string& path, Responses::Step& step) {
+        const Snapshot::File File(path);
+        if (!File.Valid()) {return false;}
+
+        const Snapshot::Header& Header = File.getHeader();
+        const Config::Settings& Settings = Board.getSettings();
+        if (Header.Rows != Settings.Rows || Header.Columns != Settings.Columns || Header.Mines != Settings.Mines) {
+            return false;
+        }
+        if (Header.State < 0 || Header.State > (std::int32_t)States::Game::Lose) {return false;}
+        if (!playable(Header)) {return false;}
+        if (!Board.loadState(File.getCells(),File.getMines(),Header.Revealed,Header.Flagged)) {return false;}
+
+        Seed = Header.Seed;
+        Seeds.seed(Seed);
+        Pinned = false;
+        NewGame = false;
+        Guessing = false;
+        State = (States::Game)Header.State;
+        Stats.BoardsPlayed = Header.BoardsPlayed;
+        Stats.GamesWon = Header.GamesWon;
+        Stats.GamesLost = Header.GamesLost;
+        Stats.TilesRevealed = Header.TilesRevealed;
+
+        std::vector<signed char> View;
+        Board.getView(View);
+        step.Tiles.clear();
+        for (int i = 0; i < (int)View.size(); i++) {
+            if (View[i] != Tiles::HIDDEN) {
+                step.Tiles.push_back({{1 + i/Settings.Columns,1 + i%Settings.Columns},View[i]});
+            }
+        }
+        if (State == States::Game::Lose) {
+            for (const int Mine : Board.getMines()) {
+                step.Tiles.push_back({{1 + Mine/Settings.Columns,1 + Mine%Settings.Columns},9});
+            }
+        }
+        step.State = State;
+        step.NumTilesLeft = Board.getRemaining();
+        step.NumFlags = Board.getNumFlags();
+        return true;
+    }
+
+    /**
+     * Clears the board, the next tap generates a new one from a fresh seed
+     */
+    void Game::Reset() {
+        NewGame = true;
+        State = States::Game::Playon;
+        Seed = Seeds();
+        Pinned = false;
+    }
+
+    /**
+     * Clears the board and reseeds the game, so the next board is the same every time for the same seed and first
+     * tap, and so are the boards after it
+     *
+     * @param seed: Seed of the next board, e.g. one reported by getSeed
+     */
+    void Game::Reset(std::uint64_t seed) {
+        NewGame = true;
+        State = States::Game::Playon;
+        Seeds.seed(seed);
+        Seed = seed;
+        Pinned = true;
+    }
+
+}
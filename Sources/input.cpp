@@ -3,71 +3,112 @@
 namespace {
 
     // Constants
-    constexpr char SET_CURSOR[] = "\033[33;12H";
-    constexpr char FILLER[] = "                                                                         ";
+    constexpr int PAN_STEP = 13;    // Half the dashboard's window
+    constexpr int MAX_TOKENS = 2;   // Words in the longest command
+    constexpr std::size_t BLOCK = 1 << 16;  // Bytes a Reader asks for at a time
 
-    // Util
-    std::string parseInput() {
-        std::string Input;
-        do {
-            std::cout << SET_CURSOR << FILLER << SET_CURSOR;
-            std::getline(std::cin, Input);
-        } while (Input.empty());
-        return Input;
-    }
+    struct Direction {
+        const char* Name;
+        int Rows;
+        int Columns;
+    };
+    constexpr Direction DIRECTIONS[] = {
+        {"up", -1, 0},
+        {"down", 1, 0},
+        {"left", 0, -1},
+        {"right", 0, 1},
+    };
+
+    // A word of the input, pointing into the line instead of being copied out of it
+    struct Token {
+        const char* Data;
+        std::size_t Length;
+    };
 
     /**
-     * Splits string input with given delimiter
+     * Splits input into the words between a delimiter, without allocating
      *
-     * @param s: Input string
-     * @param delimiter: Split delimiter
+     * @param begin: First character of the input
+     * @param end: One past the last character
+     * @param delimiter: Split delimiter, runs of it count as one
+     * @param tokens: Output, the first max words
+     * @param max: Size of tokens
      *
-     * @return Vector array of strings
+     * @return Number of words, max + 1 if there are more than max
      */
-    std::vector<std::string> split(std::string& s,const char delimiter = ' ') {
-        std::vector<std::string> Strings;
-        size_t Position = 0;
-        std::string Str;
-        while ((Position = s.find(delimiter))!=std::string::npos) {
-            Str = s.substr(0,Position);
-            if(Str.size() >= 1) {
-                std::transform(Str.begin(),Str.end(),Str.begin(),
-                    [](unsigned char c){return std::tolower(c);}
-                    );
-                Strings.push_back(Str);
+    int tokenize(const char* begin, const char* end, const char delimiter, Token* tokens, int max) {
+        int Count = 0;
+        while (begin != end) {
+            const char* Word = begin;
+            while (begin != end && *begin != delimiter) {begin++;}
+            if (begin != Word) {
+                if (Count == max) {return max + 1;}
+                tokens[Count++] = {Word,(std::size_t)(begin - Word)};
             }
-            s.erase(0, Position + 1);
+            if (begin != end) {begin++;}
         }
-        if(s.size() >= 1) {
-            std::transform(s.begin(),s.end(),s.begin(),
-                [](unsigned char c){return std::tolower(c);}
-                );
-            Strings.push_back(s);
+        return Count;
+    }
+
+    /**
+     * Compares a word of the input to a command, ignoring case
+     *
+     * @param token: Input word
+     * @param word: Lower case command
+     *
+     * @return If they are the same
+     */
+    bool equals(const Token& token, const char* word) {
+        for (std::size_t i = 0; i < token.Length; i++) {
+            if (!word[i] || word[i] != std::tolower((unsigned char)token.Data[i])) {return false;}
+        }
+        return word[token.Length] == '\0';
+    }
+
+    const Direction* findDirection(const Token& token) {
+        for (const Direction& Each : DIRECTIONS) {
+            if (equals(token,Each.Name)) {return &Each;}
         }
-        return Strings;
+        return nullptr;
+    }
+
+    /**
+     * Reads how far to pan
+     *
+     * @param count: Input word, a plain number
+     *
+     * @return The number, 0 if the input isn't valid
+     */
+    int parseCount(const Token& count) {
+        if (!std::isdigit((unsigned char)count.Data[0])) {return 0;}
+        return Coords::Parse(count.Data,count.Length);
     }
 
-    const std::pair<char,char> InvalidTile = {'0','0'};
+    const std::pair<int,int> InvalidTile = {0,0};
     /**
      * Checks for valid tile input and returns formatted tile data
      *
-     * @param tile: Input tile string
+     * Each half of the tile can either be letters (A, Z, AA, ...) or a number (1, 26, 27, ...), split by ':' or ';'
+     *
+     * @param tile: Input word
+     * @param settings: Board settings, tiles outside the board are invalid
      *
      * @return Formatted tile
      */
-    std::pair<char,char> parseTile(std::string& tile) {
-        std::vector<std::string> Tokens = split(tile,':');
-        if (Tokens.size() != 2) {
-            Tokens = split(tile,';');
-            if (Tokens.size() != 2) {return InvalidTile;}
+    std::pair<int,int> parseTile(const Token& tile, const Config::Settings& settings) {
+        const char* End = tile.Data + tile.Length;
+        Token Halves[2];
+        if (tokenize(tile.Data,End,':',Halves,2) != 2) {
+            // ';' is only looked for after the last ':', as it always has been
+            const char* Start = End;
+            while (Start != tile.Data && Start[-1] != ':') {Start--;}
+            if (tokenize(Start,End,';',Halves,2) != 2) {return InvalidTile;}
         }
 
-        const std::string RowComponent = Tokens[0];
-        const std::string ColumnComponent = Tokens[1];
-        if ((RowComponent.size() == 1 && std::isalpha(RowComponent[0])) &&
-            (ColumnComponent.size() == 1 && std::isalpha(ColumnComponent[0]))
-        ) {
-            const std::pair<char,char> Tile = {std::toupper(RowComponent[0]),std::toupper(ColumnComponent[0])};
+        const int Row = Coords::Parse(Halves[0].Data,Halves[0].Length);
+        const int Column = Coords::Parse(Halves[1].Data,Halves[1].Length);
+        if ((Row >= 1 && Row <= settings.Rows) && (Column >= 1 && Column <= settings.Columns)) {
+            const std::pair<int,int> Tile = {Row,Column};
             return Tile;
         }
         return InvalidTile;
@@ -78,55 +119,158 @@ namespace {
 namespace Input {
 
     /**
-     * Input Handler
+     * Reads a command from a line of input
+     *
+     * Only Save and Load allocate, for their path
+     *
+     * @param line: Input line, without its newline
+     * @param length: Number of characters
+     * @param settings: Board settings, used to validate tile inputs
+     *
+     * @return The command
      */
-    Responses::Input Get() {
+    Responses::Input Parse(const char* line, std::size_t length, const Config::Settings& settings) {
+        Responses::Input Response;
+        Response.Key = States::Input::Bad;
 
-        std::string Input = parseInput();
-        std::vector<std::string> Tokens = split(Input);
+        const char* End = line + length;
+        Token Tokens[MAX_TOKENS];
+        const int Count = tokenize(line,End,' ',Tokens,MAX_TOKENS);
+        if (!Count) {return Response;}
 
-        Responses::Input Response;
-        switch (Tokens.size()) {
-            case 1: {
-                std::string Key = Tokens[0];
+        const Token& Key = Tokens[0];
+        if (equals(Key,"save") || equals(Key,"load")) {
+            // Paths keep their case and spaces, only the spaces around them are dropped
+            if (Count == 1) {return Response;}
+            while (End[-1] == ' ') {End--;}
+            Response.Path.assign(Tokens[1].Data,End);
+            Response.Key = equals(Key,"save") ? States::Input::Save : States::Input::Load;
+            return Response;
+        }
+        const Direction* Pan = findDirection(Key);
 
-                if (Key == "quit" || Key == "q") {
+        switch (Count) {
+            case 1: {
+                if (equals(Key,"quit") || equals(Key,"q")) {
                     Response.Key = States::Input::Quit;
-                } else if (Key == "reset" || Key == "r") {
+                } else if (equals(Key,"reset") || equals(Key,"r")) {
                     Response.Key = States::Input::Reset;
-                } else {
-                    Response.Key = States::Input::Bad;
+                } else if (equals(Key,"undo") || equals(Key,"u")) {
+                    Response.Key = States::Input::Undo;
+                } else if (equals(Key,"redo")) {
+                    Response.Key = States::Input::Redo;
+                } else if (Pan) {
+                    Response.Key = States::Input::Pan;
+                    Response.Tile = {Pan->Rows*PAN_STEP,Pan->Columns*PAN_STEP};
                 }
 
                 return Response;
             }
 
             case 2: {
-                std::string Key = Tokens[0];
-                std::pair<char,char> Tile = parseTile(Tokens[1]);
-
-                if (Tile == InvalidTile) {
-                    Response.Key = States::Input::Bad;
+                if (Pan) {
+                    const int Lines = parseCount(Tokens[1]);
+                    Response.Key = Lines ? States::Input::Pan : States::Input::Bad;
+                    Response.Tile = {Pan->Rows*Lines,Pan->Columns*Lines};
                     return Response;
                 }
+                const std::pair<int,int> Tile = parseTile(Tokens[1],settings);
+                if (Tile == InvalidTile) {return Response;}
 
-                if (Key == "tap" || Key == "t") {
+                if (equals(Key,"tap") || equals(Key,"t")) {
                     Response.Key = States::Input::Tap;
                     Response.Tile = Tile;
-                } else if (Key == "flag" || Key == "f") {
+                } else if (equals(Key,"flag") || equals(Key,"f")) {
                     Response.Key = States::Input::Flag;
                     Response.Tile = Tile;
-                } else {
-                    Response.Key = States::Input::Bad;
+                } else if (equals(Key,"view") || equals(Key,"v")) {
+                    Response.Key = States::Input::View;
+                    Response.Tile = Tile;
                 }
 
                 return Response;
             }
 
             default: {
-                Response.Key = States::Input::Bad;
                 return Response;
             }
         }
     }
+
+    Responses::Input Parse(const std::string& line, const Config::Settings& settings) {
+        return Parse(line.data(),line.size(),settings);
+    }
+
+    /**
+     * Input Handler
+     *
+     * @param settings: Board settings, used to validate tile inputs
+     * @param renderer: Shows the prompt
+     */
+    Responses::Input Get(const Config::Settings& settings, Render::Base& renderer) {
+        // Kept between calls so reading a line reuses its memory
+        static std::string Line;
+        do {
+            renderer.Prompt();
+            if (!std::getline(std::cin, Line)) {
+                // Nothing more is coming, e.g. piped input ran out
+                Responses::Input Response;
+                Response.Key = States::Input::Quit;
+                return Response;
+            }
+        } while (Line.empty());
+        return Parse(Line,settings);
+    }
+
+    /**
+     * @param descriptor: File descriptor to read commands from, e.g. STDIN_FILENO
+     */
+    Reader::Reader(int descriptor) :
+        Descriptor(descriptor),
+        Buffer(BLOCK)
+    {}
+
+    /**
+     * Reads the next block after the line being read, growing the buffer if that line fills it
+     */
+    void Reader::fill() {
+        std::copy(Buffer.begin() + Start,Buffer.begin() + End,Buffer.begin());
+        End -= Start;
+        Start = 0;
+        if (End == Buffer.size()) {Buffer.resize(2*Buffer.size());}
+
+        const ssize_t Result = read(Descriptor,Buffer.data() + End,Buffer.size() - End);
+        if (Result > 0) {
+            End += Result;
+        } else if (Result == 0 || errno != EINTR) {
+            Finished = true;
+        }
+    }
+
+    /**
+     * Reads the next command
+     *
+     * @param settings: Board settings, used to validate tile inputs
+     * @param response: Output, the command
+     *
+     * @return If there was a command, false once everything has been read
+     */
+    bool Reader::Next(const Config::Settings& settings, Responses::Input& response) {
+        while (true) {
+            const char* Line = Buffer.data() + Start;
+            const char* Newline = (const char*)std::memchr(Line,'\n',End - Start);
+            if (Newline || (Finished && Start != End)) {
+                // The last line doesn't need a newline
+                const char* Stop = Newline ? Newline : Buffer.data() + End;
+                Start = Stop - Buffer.data() + (Newline ? 1 : 0);
+                if (Stop == Line) {continue;}
+
+                response = Parse(Line,Stop - Line,settings);
+                Lines++;
+                return true;
+            }
+            if (Finished) {return false;}
+            fill();
+        }
+    }
 }
\ No newline at end of file
@@ -0,0 +1,274 @@
+#include "keyboard.hpp"
+
+namespace {
+
+    // Constants
+    constexpr int ESCAPE_WAIT = 25;     // Milliseconds the rest of an escape sequence gets to arrive
+    constexpr std::size_t MAX_LINE = 72;    // Characters a typed command can have, the width of the input line
+    constexpr char HINT[] = "arrows move  space tap  f flag  u undo  y redo  n new  : type  q quit";
+    static_assert(sizeof(HINT) - 1 <= MAX_LINE, "The hint has to fit on the input line");
+
+}
+
+namespace Keyboard {
+
+    /**
+     * Reads the key at the front of what was read from a terminal
+     *
+     * Arrow keys arrive as escape sequences, which can be split over reads. Until the rest of one has had time to
+     * arrive, a lone escape isn't taken as the escape key
+     *
+     * @param data: Bytes read
+     * @param length: Number of bytes
+     * @param complete: No more bytes are coming soon, so an unfinished escape sequence is just the escape key
+     * @param press: Output, the key
+     *
+     * @return Bytes the key took up, 0 if they are all part of an unfinished escape sequence
+     */
+    std::size_t Decode(const char* data, std::size_t length, bool complete, Press& press) {
+        press = Press();
+        if (!length) {return 0;}
+
+        const unsigned char First = data[0];
+        if (First == '\033') {
+            // CSI and SS3 sequences: parameter bytes, then a final byte saying which key it was
+            std::size_t End = 2;
+            while (End < length && data[End] >= 0x20 && data[End] < 0x40) {End++;}
+            if (length == 1 || ((data[1] == '[' || data[1] == 'O') && End >= length)) {
+                if (!complete) {return 0;}
+                press.Type = Key::Escape;
+                return 1;
+            }
+            if ((data[1] != '[' && data[1] != 'O') || data[End] < 0x40 || data[End] > 0x7E) {
+                press.Type = Key::Escape;
+                return 1;
+            }
+
+            switch (data[End]) {
+                case 'A': press.Type = Key::Up; break;
+                case 'B': press.Type = Key::Down; break;
+                case 'C': press.Type = Key::Right; break;
+                case 'D': press.Type = Key::Left; break;
+                default: break;
+            }
+            return End + 1;
+        }
+
+        if (First == '\r' || First == '\n')     {press.Type = Key::Enter;}
+        else if (First == ' ')                  {press.Type = Key::Space;}
+        else if (First == 0x7F || First == 0x08) {press.Type = Key::Backspace;}
+        else if (First == 0x03 || First == 0x04) {press.Type = Key::Interrupt;}
+        else if (First > ' ') {
+            press.Type = Key::Character;
+            press.Character = First;
+        }
+        return 1;
+    }
+
+    /**
+     * @param descriptor: File descriptor of the terminal, e.g. STDIN_FILENO
+     */
+    Raw::Raw(int descriptor) :
+        Descriptor(descriptor)
+    {
+        if (!isatty(descriptor) || tcgetattr(descriptor,&Saved)) {return;}
+
+        termios Settings = Saved;
+        Settings.c_iflag &= ~(ICRNL | IXON);
+        Settings.c_lflag &= ~(ICANON | ECHO | ISIG | IEXTEN);
+        Settings.c_cc[VMIN] = 1;
+        Settings.c_cc[VTIME] = 0;
+        Enabled = !tcsetattr(descriptor,TCSAFLUSH,&Settings);
+    }
+
+    Raw::~Raw() {
+        if (Enabled) {tcsetattr(Descriptor,TCSAFLUSH,&Saved);}
+    }
+
+    /**
+     * @param descriptor: File descriptor to read keys from, e.g. STDIN_FILENO
+     */
+    Loop::Loop(int descriptor) :
+        Descriptor(descriptor)
+    {}
+
+    /**
+     * Runs a callback every period, starting a period from now, for as long as keys are being waited for
+     *
+     * @param period: Time between runs
+     * @param callback: What to run
+     */
+    void Loop::Every(std::chrono::milliseconds period, std::function<void()> callback) {
+        Timers.push_back({std::chrono::steady_clock::now() + period,period,std::move(callback)});
+    }
+
+    /**
+     * Runs every timer that is due
+     *
+     * @return Milliseconds until the next one is, -1 if there are none
+     */
+    int Loop::runTimers() {
+        if (Timers.empty()) {return -1;}
+
+        std::chrono::steady_clock::time_point Now = std::chrono::steady_clock::now();
+        std::chrono::steady_clock::time_point Next = std::chrono::steady_clock::time_point::max();
+        for (std::size_t i = 0; i < Timers.size(); i++) {
+            if (Timers[i].Due <= Now) {
+                Timers[i].Callback();
+                Now = std::chrono::steady_clock::now();
+
+                // Runs that were missed, e.g. while a large board was being dealt, are skipped instead of bunched up
+                Timers[i].Due += Timers[i].Period;
+                if (Timers[i].Due <= Now) {Timers[i].Due = Now + Timers[i].Period;}
+            }
+            Next = std::min(Next,Timers[i].Due);
+        }
+        return std::chrono::duration_cast<std::chrono::milliseconds>(Next - Now).count() + 1;
+    }
+
+    /**
+     * Waits for the next key, running timers until it comes
+     *
+     * @param press: Output, the key
+     *
+     * @return If there was a key, false once nothing more can be read
+     */
+    bool Loop::Next(Press& press) {
+        while (true) {
+            const bool Waited = std::chrono::steady_clock::now() - Arrived >= std::chrono::milliseconds(ESCAPE_WAIT);
+            const std::size_t Used = Decode(Buffer,Length,Finished || Waited || Length == sizeof(Buffer),press);
+            if (Used) {
+                std::copy(Buffer + Used,Buffer + Length,Buffer);
+                Length -= Used;
+                if (press.Type == Key::None) {continue;}
+                return true;
+            }
+            if (Finished) {return false;}
+
+            int Timeout = runTimers();
+            if (Length) {Timeout = Timeout < 0 ? ESCAPE_WAIT : std::min(Timeout,ESCAPE_WAIT);}
+            pollfd Poll = {Descriptor,POLLIN,0};
+            const int Ready = poll(&Poll,1,Timeout);
+            if (Ready < 0 && errno != EINTR) {Finished = true;}
+            if (Ready <= 0) {continue;}
+
+            const ssize_t Result = read(Descriptor,Buffer + Length,sizeof(Buffer) - Length);
+            if (Result > 0) {
+                Length += Result;
+                Arrived = std::chrono::steady_clock::now();
+            } else if (Result == 0 || errno != EINTR) {
+                Finished = true;
+            }
+        }
+    }
+
+    /**
+     * Takes over a terminal, which is put back as it was when this is destroyed
+     *
+     * @param descriptor: File descriptor of the terminal, e.g. STDIN_FILENO
+     * @param settings: Board settings, the cursor stays on the board
+     */
+    Commands::Commands(int descriptor, const Config::Settings& settings) :
+        Terminal(descriptor),
+        Events(descriptor),
+        Settings(settings)
+    {}
+
+    /**
+     * Counts the time from reading the last key to now, once what it did has been drawn
+     */
+    void Commands::measure() {
+        if (!Measuring) {return;}
+        const auto Elapsed = std::chrono::steady_clock::now() - Events.getArrived();
+        Latency.Add(std::chrono::duration_cast<std::chrono::microseconds>(Elapsed).count());
+        Measuring = false;
+    }
+
+    /**
+     * Handles keys until one makes a move, moving the cursor and showing what is typed in the meantime
+     *
+     * The frame showing a move is drawn by whoever makes it, before asking for the next one
+     *
+     * @param renderer: Shows the cursor and what is typed
+     *
+     * @return The move, Quit once the keyboard can't be read
+     */
+    Responses::Input Commands::Get(Render::Base& renderer) {
+        measure();
+        Responses::Input Response;
+        Response.Key = States::Input::Bad;
+        renderer.Cursor(Cursor);
+        renderer.Typing(Typing ? Line : HINT,Typing);
+        renderer.Flush();
+
+        Press Pressed;
+        while (Events.Next(Pressed)) {
+            Measuring = true;
+            bool Move = false;
+            if (Typing) {
+                if (Pressed.Type == Key::Enter) {
+                    Typing = false;
+                    Move = !Line.empty();
+                    if (Move) {Response = Input::Parse(Line,Settings);}
+                    Line.clear();
+                } else if (Pressed.Type == Key::Escape || Pressed.Type == Key::Interrupt) {
+                    Typing = false;
+                    Line.clear();
+                    Move = Pressed.Type == Key::Interrupt;
+                    if (Move) {Response.Key = States::Input::Quit;}
+                } else if (Pressed.Type == Key::Backspace) {
+                    // A whole UTF-8 character at a time
+                    while (!Line.empty() && ((unsigned char)Line.back() & 0xC0) == 0x80) {Line.pop_back();}
+                    if (!Line.empty()) {Line.pop_back();}
+                } else if ((Pressed.Type == Key::Character || Pressed.Type == Key::Space) && Line.size() < MAX_LINE) {
+                    Line += Pressed.Type == Key::Space ? ' ' : Pressed.Character;
+                }
+            } else {
+                const char Character = Pressed.Type == Key::Character ? std::tolower((unsigned char)Pressed.Character)
+                    : 0;
+                int Rows = 0, Columns = 0;
+                if (Pressed.Type == Key::Up || Character == 'k')          {Rows = -1;}
+                else if (Pressed.Type == Key::Down || Character == 'j')   {Rows = 1;}
+                else if (Pressed.Type == Key::Left || Character == 'h')   {Columns = -1;}
+                else if (Pressed.Type == Key::Right || Character == 'l')  {Columns = 1;}
+                Cursor.first = std::max(1,std::min(Cursor.first + Rows,Settings.Rows));
+                Cursor.second = std::max(1,std::min(Cursor.second + Columns,Settings.Columns));
+
+                Move = true;
+                if (Pressed.Type == Key::Space || Pressed.Type == Key::Enter) {
+                    Response.Key = States::Input::Tap;
+                    Response.Tile = Cursor;
+                } else if (Character == 'f') {
+                    Response.Key = States::Input::Flag;
+                    Response.Tile = Cursor;
+                } else if (Character == 'u') {
+                    Response.Key = States::Input::Undo;
+                } else if (Character == 'y') {
+                    Response.Key = States::Input::Redo;
+                } else if (Character == 'n') {
+                    Response.Key = States::Input::Reset;
+                } else if (Character == 'q' || Pressed.Type == Key::Interrupt) {
+                    Response.Key = States::Input::Quit;
+                } else {
+                    Typing = Character == ':';
+                    Move = false;
+                }
+            }
+
+            // Typed commands on a tile take the cursor there
+            const States::Input Made = Response.Key;
+            if (Move && (Made == States::Input::Tap || Made == States::Input::Flag || Made == States::Input::View)) {
+                Cursor = Response.Tile;
+            }
+            renderer.Cursor(Cursor);
+            renderer.Typing(Typing ? Line : HINT,Typing);
+            if (Move) {return Response;}
+            renderer.Flush();
+            measure();
+        }
+
+        Response.Key = States::Input::Quit;
+        return Response;
+    }
+
+}
@@ -0,0 +1,74 @@
+#include "memory.hpp"
+
+namespace {
+
+    // Smallest block the arena asks the heap for
+    constexpr std::size_t MIN_BLOCK = 4096;
+
+}
+
+namespace Memory {
+
+    /**
+     * Creates an arena
+     *
+     * @param capacity: Bytes to reserve up front, enough for everything allocated between two resets means the
+     * arena never goes back to the heap
+     */
+    Arena::Arena(std::size_t capacity) {
+        grow(capacity);
+    }
+
+    /**
+     * Allocates memory that stays valid until the next reset
+     *
+     * @param bytes: Size of the allocation
+     * @param alignment: Power of two the address must be a multiple of
+     */
+    void* Arena::Allocate(std::size_t bytes, std::size_t alignment) {
+        std::size_t Padding = -reinterpret_cast<std::size_t>(Head) & (alignment - 1);
+        if (bytes + Padding > static_cast<std::size_t>(End - Head)) {
+            grow(bytes + alignment);
+            Padding = -reinterpret_cast<std::size_t>(Head) & (alignment - 1);
+        }
+
+        char* Address = Head + Padding;
+        Head = Address + bytes;
+        Usage.Allocations++;
+        Usage.Bytes += bytes + Padding;
+        Usage.PeakBytes = std::max(Usage.PeakBytes,Usage.Bytes);
+        return Address;
+    }
+
+    /**
+     * Takes back everything that was allocated, merging the blocks first if there is more than one
+     */
+    void Arena::Reset() {
+        if (Blocks.size() > 1) {
+            const std::size_t Total = Reserved;
+            Blocks.clear();
+            Reserved = 0;
+            grow(Total);
+        } else if (!Blocks.empty()) {
+            Head = Blocks.front().get();
+        }
+        Usage.Allocations = 0;
+        Usage.Bytes = 0;
+    }
+
+    /**
+     * Starts a new block with room for at least the given number of bytes, and at least as big as every block
+     * before it together, so that a growing arena needs few blocks
+     *
+     * @param bytes: Room needed
+     */
+    void Arena::grow(std::size_t bytes) {
+        const std::size_t Size = std::max({bytes,Reserved,MIN_BLOCK});
+        Blocks.emplace_back(new char[Size]);
+        Reserved += Size;
+        Head = Blocks.back().get();
+        End = Head + Size;
+        Usage.Blocks++;
+    }
+
+}
@@ -0,0 +1,189 @@
+#include "noguess.hpp"
+
+namespace {
+
+    // Layouts tried before settling for one that needs a guess, dense boards are rarely solvable
+    constexpr int MAX_ATTEMPTS = 1000;
+
+    // Seeds kept ready for every start tile
+    constexpr int RING_SIZE = 2;
+
+    // Pools are only kept while filling every ring takes at most about this many tiles times mines of work
+    constexpr long long POOL_MINES = 1 << 22;
+
+}
+
+namespace NoGuess {
+
+    /**
+     * Checks if a board can be finished from a start tile without ever guessing
+     *
+     * Plays a copy of the board, tapping every tile the solver proves safe until there are none left
+     *
+     * @param board: Freshly generated board
+     * @param start: First tap, that the board was generated around
+     * @param solver: Solver to play with
+     */
+    bool Solvable(const Tiles::Board& board, const std::pair<int,int>& start, Solver::Engine& solver) {
+        Tiles::Board Copy = board;
+        Responses::Tap TR = Copy.Tap(start);
+        while (TR.State == States::Game::Playon) {
+            const Solver::Result& Result = solver.Solve(Copy);
+            if (Result.Safe.empty()) {return false;}
+
+            for (const std::pair<int,int>& Tile : Result.Safe) {
+                Copy.Tap(Tile,TR);
+            }
+        }
+        return TR.State == States::Game::Win;
+    }
+
+    /**
+     * Generates boards around a start tile until one can be solved without guessing
+     *
+     * The seed itself is tried first and every later seed is drawn from it, so generating again from the seed that
+     * was handed back gives the same board straight away
+     *
+     * @param board: Board to generate
+     * @param start: First tap
+     * @param seed: Seed to start from, replaced by the seed of the board that was accepted
+     * @param solver: Solver to check the boards with
+     *
+     * @return False if no board was solvable within MAX_ATTEMPTS tries, the board and seed are then the first ones
+     */
+    bool Generate(Tiles::Board& board, const std::pair<int,int>& start, std::uint64_t& seed, Solver::Engine& solver) {
+        Prng::Generator Rng(seed);
+        std::uint64_t Attempt = seed;
+        for (int i = 0; i < MAX_ATTEMPTS; i++) {
+            board.generateBoard(start,Attempt);
+            if (Solvable(board,start,solver)) {
+                seed = Attempt;
+                return true;
+            }
+            Attempt = Rng();
+        }
+        board.generateBoard(start,seed);
+        return false;
+    }
+
+    /**
+     * Starts generating boards on Settings.Threads workers
+     *
+     * @param settings: Board settings, assumed to already be validated by Config::Parse
+     * @param seed: Seed of the first worker, worker N uses SEED + N
+     */
+    Pool::Pool(const Config::Settings& settings, std::uint64_t seed) :
+        Settings(settings)
+    {
+        const long long TotalTiles = (long long)Settings.Rows*Settings.Columns;
+        if (TotalTiles*Settings.Mines*RING_SIZE > POOL_MINES) {return;}
+
+        Capacity = RING_SIZE;
+        Rings.resize(TotalTiles);
+        Seeds.resize(TotalTiles*Capacity);
+        for (int i = 0; i < Settings.Threads; i++) {
+            Workers.emplace_back(&Pool::work,this,seed + i);
+        }
+    }
+
+    Pool::~Pool() {
+        {
+            std::lock_guard<std::mutex> Guard(Lock);
+            Stopping = true;
+        }
+        Wake.notify_all();
+        for (std::thread& Worker : Workers) {
+            Worker.join();
+        }
+    }
+
+    /**
+     * Takes a ready board for a start tile
+     *
+     * @param start: First tap
+     * @param seed: Output, seed that generates a no-guess board around the start tile
+     *
+     * @return False if there is no board ready for that tile
+     */
+    bool Pool::Take(const std::pair<int,int>& start, std::uint64_t& seed) {
+        std::lock_guard<std::mutex> Guard(Lock);
+        if (Rings.empty()) {return false;}
+
+        const int Start = (start.first - 1)*Settings.Columns + start.second - 1;
+        Ring& Slots = Rings[Start];
+        if (!Slots.Count) {return false;}
+
+        seed = Seeds[(std::size_t)Start*Capacity + Slots.Head];
+        Slots.Head = (Slots.Head + 1)%Capacity;
+        Slots.Count--;
+        NumReady--;
+        Wake.notify_one();
+        return true;
+    }
+
+    /**
+     * Returns the number of boards ready over every start tile
+     */
+    int Pool::Ready() {
+        std::lock_guard<std::mutex> Guard(Lock);
+        return NumReady;
+    }
+
+    /**
+     * Picks the ring to generate for next, every ring gets one board before any gets two
+     *
+     * Lock must be held
+     *
+     * @return Grid position of the start tile, -1 if every ring is full
+     */
+    int Pool::nextStart() {
+        const int NumRings = Rings.size();
+        for (int Level = 0; Level < Capacity; Level++) {
+            for (int i = 0; i < NumRings; i++) {
+                const int Start = (Cursor + i)%NumRings;
+                if (Rings[Start].Count + Rings[Start].Pending <= Level) {
+                    Cursor = (Start + 1)%NumRings;
+                    return Start;
+                }
+            }
+        }
+        return -1;
+    }
+
+    /**
+     * Worker loop, tries one board at a time so that it can stop between any two
+     *
+     * @param seed: Seed for the worker's random number generator, which draws the seed of every board
+     */
+    void Pool::work(std::uint64_t seed) {
+        Prng::Generator Rng(seed);
+        Tiles::Board Board(Settings);
+        Solver::Engine Solver;
+
+        std::unique_lock<std::mutex> Guard(Lock);
+        while (!Stopping) {
+            const int Start = nextStart();
+            if (Start < 0) {
+                Wake.wait(Guard);
+                continue;
+            }
+            Rings[Start].Pending++;
+            Guard.unlock();
+
+            const std::pair<int,int> Tile = {1 + Start/Settings.Columns,1 + Start%Settings.Columns};
+            const std::uint64_t Seed = Rng();
+            Board.generateBoard(Tile,Seed);
+            const bool Found = Solvable(Board,Tile,Solver);
+
+            Guard.lock();
+            Ring& Slots = Rings[Start];
+            Slots.Pending--;
+            if (Found) {
+                Seeds[(std::size_t)Start*Capacity + (Slots.Head + Slots.Count)%Capacity] = Seed;
+                Slots.Count++;
+                NumReady++;
+            }
+        }
+    }
+
+}
@@ -3,73 +3,137 @@
 namespace {
 
     // Constants
-    constexpr int CHAR_OFFSET = 64;
-
-    constexpr int LOG_MAX_SIZE = 22;
+    constexpr int LOG_MAX_SIZE = 22;    // Lines of the log on screen
+    constexpr int LOG_WIDTH = 21;
+    constexpr int LOG_HISTORY = 256;    // Lines of the log kept, oldest overwritten first
     constexpr int LOG_OFFSET_X = 3;
     constexpr int LOG_OFFSET_Y = 8;
 
     constexpr int TILE_OFFSET_X = 29;
     constexpr int TILE_OFFSET_Y = 3;
-    const std::map<int,std::string> TILE_COLOURS = {
-        {1, "\033[38;5;26m"},   // 26   : Blue
-        {2, "\033[38;5;22m"},   // 22   : Green
-        {3, "\033[38;5;196m"},  // 196  : Red
-        {4, "\033[38;5;226m"},  // 226  : Yellow
-        {5, "\033[38;5;126m"},  // 126  : Pinkish
-        {6, "\033[38;5;6m"},    // 6    : Cyan
-        {7, "\033[38;5;99m"},   // 99   : Purple
-        {8, "\033[38;5;245m"},  // 245  : Grey
+    constexpr int GRID_SIZE = 26;   // Rows/columns of the board that fit on the dashboard
+    constexpr int LABEL_OFFSET_X = 27;
+    constexpr int TILE_COLOURS[9] = {
+        Screen::DEFAULT,
+        26,     // Blue
+        22,     // Green
+        196,    // Red
+        226,    // Yellow
+        126,    // Pinkish
+        6,      // Cyan
+        99,     // Purple
+        245,    // Grey
     };
 
     constexpr int INFO_OFFSET_X = 19;
+    constexpr int INFO_END_X = 23;
     constexpr int FLAG_INFO_OFFSET_Y = 4;
     constexpr int TILES_LEFT_INFO_OFFSET_Y = 5;
-
-    constexpr char BLANK[] = "\033[38;5;245m.\033[0m";
-    constexpr char MINE[] = "\033[38;5;196m▇\033[0m";
-    constexpr char FLAG[] = "\033[38;5;208m▶\033[0m";
+    constexpr int VIEW_INFO_OFFSET_Y = 6;
+    constexpr int TIME_INFO_OFFSET_Y = 2;
+
+    constexpr int SCREEN_ROWS = 34;
+    constexpr int SCREEN_COLUMNS = 85;
+    constexpr int INPUT_Y = 33;
+    constexpr int INPUT_X = 12;
+
+    constexpr char BLANK[] = ".";
+    constexpr int BLANK_COLOUR = 245;
+    constexpr char MINE[] = "▇";
+    constexpr int MINE_COLOUR = 196;
+    constexpr char FLAG[] = "▶";
+    constexpr int FLAG_COLOUR = 208;
+    constexpr char DIGITS[] = "012345678";
+    constexpr int CURSOR_COLOUR = 45;   // Light blue
+
+    Config::Settings Board;
+    const Tiles::View* Source = nullptr;    // Board drawn when the window is redrawn
+    Screen::Buffer Terminal(SCREEN_ROWS,SCREEN_COLUMNS);
+
+    // Window of the board on the dashboard, by its top left tile
+    int Top = 1;
+    int Left = 1;
+    bool Hidden = true;     // The board hasn't been dealt since the last reset, so every tile is hidden
+    bool Lost = false;      // Mines are shown
+
+    // Where the keyboard cursor's brackets are drawn, either side of a tile, 0 if they aren't
+    int CursorY = 0;
+    int CursorX = 0;
 
     // Util
-    inline std::string formatTile(const std::pair<char,char>& tile) {
-        return {'\'',tile.first,':',tile.second,'\''};
+    inline bool onScreen(const std::pair<int,int>& tile) {
+        return tile.first >= Top && tile.first < Top + GRID_SIZE
+            && tile.second >= Left && tile.second < Left + GRID_SIZE;
     }
 
-    inline std::string setCursor(int y, int x) {
-        return "\033[" + std::to_string(y) + ';' + std::to_string(x) + 'H';
+    inline int infoWidth() {
+        return std::max<int>(3,std::to_string((long long)Board.Rows*Board.Columns).length());
+    }
+
+    inline std::string formatInfo(const int n) {
+        std::stringstream ss;
+        ss << std::setw(infoWidth()) << std::setfill('0') << n;
+        return ss.str();
     }
 
-    std::string formatStatLine(const std::string& temp, const int stat_count) {
+    inline std::string placeholder(const char* pattern) {
+        std::string Placeholder;
+        for (int i = 0; i < infoWidth(); i++) {
+            Placeholder += pattern[i%3];
+        }
+        return Placeholder;
+    }
+
+    inline void putTile(const std::pair<int,int>& tile, const char* glyph, int colour = Screen::DEFAULT) {
+        Terminal.Put(TILE_OFFSET_Y + tile.first - Top + 1,TILE_OFFSET_X + (tile.second - Left + 1)*2,glyph,colour);
+    }
+
+    // Only the last letter of a label fits, every letter shows up once across the window
+    inline void putLabel(int row, int column, int n) {
+        const char Letter[2] = {(char)('A' + (n - 1)%26),'\0'};
+        Terminal.Put(row,column,Letter);
+    }
+
+    std::string formatStatLine(const std::string& temp, const long long stat_count) {
         std::string Formatted = "┃                               ";
         Formatted += temp + std::to_string(stat_count);
 
         const int Length = Formatted.length();
         Formatted.append(85 - Length + 1,' ');
-        Formatted.append("┃\n");
+        Formatted.append("┃");
         return Formatted;
     }
 
+    // Log lines, padded or cut to the width of the panel
+    std::array<std::string,LOG_HISTORY> Logs;
+    long long LogCount = 0;
+
     /**
-     * Inserts log message into UI
+     * Inserts log message into UI, scrolling the panel up once it is full
      *
      * @param message: Log message
      */
     void insertLog(const std::string& message) {
-        static std::queue<std::string> Logs;
-
-        const char* FILLER = "                     ";
-        Logs.push(message);
-        if (Logs.size() > LOG_MAX_SIZE) {
-            Logs.pop();
-            std::queue<std::string> Temp = Logs;
-            while (!Temp.empty()) {
-                const int Y = (LOG_MAX_SIZE - Temp.size()) + 1;
-                const std::string CursorPos = setCursor(Y + LOG_OFFSET_Y,LOG_OFFSET_X);
-                std::cout << CursorPos << FILLER << CursorPos << Temp.front();
-                Temp.pop();
-            }
-        } else {
-            std::cout << setCursor(Logs.size() + LOG_OFFSET_Y,LOG_OFFSET_X) << message;
+        std::string& Entry = Logs[LogCount%LOG_HISTORY];
+        Entry.assign(message,0,LOG_WIDTH);
+        Entry.resize(LOG_WIDTH,' ');
+        LogCount++;
+
+        // Only a terminal with left/right margins scrolls the panel itself, anywhere else every line of it that moved
+        // is redrawn in the next frame
+        if (LogCount > LOG_MAX_SIZE) {
+            Terminal.Scroll(LOG_OFFSET_Y + 1,LOG_OFFSET_Y + LOG_MAX_SIZE,LOG_OFFSET_X,LOG_OFFSET_X + LOG_WIDTH - 1);
+        }
+        Terminal.Print(LOG_OFFSET_Y + std::min<long long>(LogCount,LOG_MAX_SIZE),LOG_OFFSET_X,Entry);
+    }
+
+    /**
+     * Draws the latest lines of the log into the panel
+     */
+    void drawLog() {
+        const long long First = std::max<long long>(0,LogCount - LOG_MAX_SIZE);
+        for (long long i = First; i < LogCount; i++) {
+            Terminal.Print(LOG_OFFSET_Y + 1 + (i - First),LOG_OFFSET_X,Logs[i%LOG_HISTORY]);
         }
     }
 
@@ -79,18 +143,15 @@ namespace {
      * @param tile: The tile to reveal
      * @param n: The number of mines adjacent to the tile
      */
-    void revealTile(const std::pair<char,char>& tile, const int n) {
-        const int Row = tile.first - CHAR_OFFSET;
-        const int Column = (tile.second - CHAR_OFFSET)*2;
-
-        std::cout << setCursor(TILE_OFFSET_Y + Row,TILE_OFFSET_X + Column);
+    void revealTile(const std::pair<int,int>& tile, const int n) {
+        if (!onScreen(tile)) {return;}
 
         if (n == 9)
-        {std::cout << MINE;}
+        {putTile(tile,MINE,MINE_COLOUR);}
         else if (n == 0)
-        {std::cout << BLANK;}
+        {putTile(tile,BLANK,BLANK_COLOUR);}
         else
-        {std::cout << TILE_COLOURS.at(n) << n << "\033[0m";}
+        {putTile(tile,&DIGITS[n],TILE_COLOURS[n]);}
     }
 
     /**
@@ -99,10 +160,8 @@ namespace {
      * @param num_flags: Number of flags used
      */
     void setFlagCount(const int num_flags) {
-        std::stringstream ss;
-        ss << std::setw(3) << std::setfill('0') << num_flags;
-        std::string Formatted = ss.str();
-        std::cout << setCursor(FLAG_INFO_OFFSET_Y,INFO_OFFSET_X) << Formatted;
+        const int X = std::min(INFO_OFFSET_X,INFO_END_X + 1 - infoWidth());
+        Terminal.Print(FLAG_INFO_OFFSET_Y,X,formatInfo(num_flags));
     }
 
     /**
@@ -111,37 +170,91 @@ namespace {
      * @param num_tiles_left: Number of tiles left
      */
     void setRemainingCount(const int num_tiles_left) {
-        std::stringstream ss;
-        ss << std::setw(3) << std::setfill('0') << num_tiles_left;
-        std::string Formatted = ss.str();
-        std::cout << setCursor(TILES_LEFT_INFO_OFFSET_Y,INFO_OFFSET_X) << Formatted;
+        const int X = std::min(INFO_OFFSET_X,INFO_END_X + 1 - infoWidth());
+        Terminal.Print(TILES_LEFT_INFO_OFFSET_Y,X,formatInfo(num_tiles_left));
+    }
+
+    /**
+     * Builds one line of the Info section
+     *
+     * @param label: Name of the stat
+     * @param value: Value to show
+     */
+    std::string infoLine(const std::string& label, const std::string& value) {
+        std::string Line = "┃ " + label;
+        const int X = std::min(INFO_OFFSET_X,INFO_END_X + 1 - (int)value.length());
+        Line.append(X - 3 - label.length(),' ');
+        Line += value;
+        Line.append(INFO_END_X + 1 - X - value.length(),' ');
+        return Line + "┃";
+    }
+
+    /**
+     * Draws a tile in the window from the board, as the player sees it
+     *
+     * @param tile: Tile in the window
+     */
+    void drawTile(const std::pair<int,int>& tile) {
+        if (Hidden) {
+            putTile(tile,"-");
+            return;
+        }
+        const signed char Shown = Source->getShown(tile);
+        if (Lost && Source->tileMine(tile))   {revealTile(tile,9);}
+        else if (Shown == Tiles::FLAGGED)     {putTile(tile,FLAG,FLAG_COLOUR);}
+        else if (Shown == Tiles::HIDDEN)      {putTile(tile,"-");}
+        else                                  {revealTile(tile,Shown);}
     }
 
     /**
-     * Resets board section of the UI
+     * Redraws the window, its labels and where it is, only ever touching the tiles in it
      */
-    void resetBoard() {
-        const int TOTAL_TILES = 676;
-        int Row = 1;
-        int Column = 1;
-        for (int i = 1; i <= TOTAL_TILES; i++) {
-            std::cout << setCursor(TILE_OFFSET_Y + Row, TILE_OFFSET_X + (Column*2)) << '-';
-            if (i%26==0) { // 26 = number of columns
-                Row++;
-                Column = 1;
-            } else {
-                Column++;
+    void drawWindow() {
+        const int Rows = std::min(Board.Rows,GRID_SIZE);
+        const int Columns = std::min(Board.Columns,GRID_SIZE);
+        for (int Column = Left; Column < Left + Columns; Column++) {
+            putLabel(TILE_OFFSET_Y - 1,TILE_OFFSET_X + (Column - Left + 1)*2,Column);
+        }
+        for (int Row = Top; Row < Top + Rows; Row++) {
+            putLabel(TILE_OFFSET_Y + Row - Top + 1,LABEL_OFFSET_X,Row);
+            for (int Column = Left; Column < Left + Columns; Column++) {
+                drawTile({Row,Column});
             }
         }
+        if (Board.Rows > GRID_SIZE || Board.Columns > GRID_SIZE) {
+            Terminal.Print(VIEW_INFO_OFFSET_Y,1,infoLine("View",Coords::Format({Top,Left})));
+        }
+    }
+
+    /**
+     * Moves the window, keeping it on the board, and redraws it if it moved
+     *
+     * @param top: Row of the window's top left tile
+     * @param left: Column of the window's top left tile
+     */
+    void moveWindow(int top, int left) {
+        top = std::max(1,std::min(top,Board.Rows - GRID_SIZE + 1));
+        left = std::max(1,std::min(left,Board.Columns - GRID_SIZE + 1));
+        if (top == Top && left == Left) {return;}
+        Top = top;
+        Left = left;
+        drawWindow();
     }
 
     /**
      * Resets the Info section of the UI
      */
     void resetInfo() {
-        std::cout
-        << setCursor(FLAG_INFO_OFFSET_Y,INFO_OFFSET_X) << "&*^"
-        << setCursor(TILES_LEFT_INFO_OFFSET_Y,INFO_OFFSET_X) << "!~%";
+        const int X = std::min(INFO_OFFSET_X,INFO_END_X + 1 - infoWidth());
+        Terminal.Print(FLAG_INFO_OFFSET_Y,X,placeholder("&*^"));
+        Terminal.Print(TILES_LEFT_INFO_OFFSET_Y,X,placeholder("!~%"));
+    }
+
+    /**
+     * Builds one empty line of the board section, its label and tiles are drawn with the window
+     */
+    std::string boardLine() {
+        return "┃   │                                                     │ ┃";
     }
 
 }
@@ -150,69 +263,90 @@ namespace Output {
 
     /**
      * Outputs the main UI
+     *
+     * @param board: Board of the game, the window is drawn from it whenever it moves
      */
-    void Dashboard() {
-        std::cout << "\033[2J\033[H"
-        <<"┏━INFO━━━━━━━━━━━━━━━━━┓┏━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━┓\n"
-        <<"┃                      ┃┃     A B C D E F G H I J K L M N O P Q R S T U V W X Y Z   ┃\n"
-        <<"┃ Total Bombs     100  ┃┃   ┌─────────────────────────────────────────────────────┐ ┃\n"
-        <<"┃ Flags Used      &*^  ┃┃ A │ - - - - - - - - - - - - - - - - - - - - - - - - - - │ ┃\n"
-        <<"┃ Tiles Left      !~%  ┃┃ B │ - - - - - - - - - - - - - - - - - - - - - - - - - - │ ┃\n"
-        <<"┃                      ┃┃ C │ - - - - - - - - - - - - - - - - - - - - - - - - - - │ ┃\n"
-        <<"┗━━━━━━━━━━━━━━━━━━━━━━┛┃ D │ - - - - - - - - - - - - - - - - - - - - - - - - - - │ ┃\n"
-        <<"┏━LOG━━━━━━━━━━━━━━━━━━┓┃ E │ - - - - - - - - - - - - - - - - - - - - - - - - - - │ ┃\n"
-        <<"┃                      ┃┃ F │ - - - - - - - - - - - - - - - - - - - - - - - - - - │ ┃\n"
-        <<"┃                      ┃┃ G │ - - - - - - - - - - - - - - - - - - - - - - - - - - │ ┃\n"
-        <<"┃                      ┃┃ H │ - - - - - - - - - - - - - - - - - - - - - - - - - - │ ┃\n"
-        <<"┃                      ┃┃ I │ - - - - - - - - - - - - - - - - - - - - - - - - - - │ ┃\n"
-        <<"┃                      ┃┃ J │ - - - - - - - - - - - - - - - - - - - - - - - - - - │ ┃\n"
-        <<"┃                      ┃┃ K │ - - - - - - - - - - - - - - - - - - - - - - - - - - │ ┃\n"
-        <<"┃                      ┃┃ L │ - - - - - - - - - - - - - - - - - - - - - - - - - - │ ┃\n"
-        <<"┃                      ┃┃ M │ - - - - - - - - - - - - - - - - - - - - - - - - - - │ ┃\n"
-        <<"┃                      ┃┃ N │ - - - - - - - - - - - - - - - - - - - - - - - - - - │ ┃\n"
-        <<"┃                      ┃┃ O │ - - - - - - - - - - - - - - - - - - - - - - - - - - │ ┃\n"
-        <<"┃                      ┃┃ P │ - - - - - - - - - - - - - - - - - - - - - - - - - - │ ┃\n"
-        <<"┃                      ┃┃ Q │ - - - - - - - - - - - - - - - - - - - - - - - - - - │ ┃\n"
-        <<"┃                      ┃┃ R │ - - - - - - - - - - - - - - - - - - - - - - - - - - │ ┃\n"
-        <<"┃                      ┃┃ S │ - - - - - - - - - - - - - - - - - - - - - - - - - - │ ┃\n"
-        <<"┃                      ┃┃ T │ - - - - - - - - - - - - - - - - - - - - - - - - - - │ ┃\n"
-        <<"┃                      ┃┃ U │ - - - - - - - - - - - - - - - - - - - - - - - - - - │ ┃\n"
-        <<"┃                      ┃┃ V │ - - - - - - - - - - - - - - - - - - - - - - - - - - │ ┃\n"
-        <<"┃                      ┃┃ W │ - - - - - - - - - - - - - - - - - - - - - - - - - - │ ┃\n"
-        <<"┃                      ┃┃ X │ - - - - - - - - - - - - - - - - - - - - - - - - - - │ ┃\n"
-        <<"┃                      ┃┃ Y │ - - - - - - - - - - - - - - - - - - - - - - - - - - │ ┃\n"
-        <<"┃                      ┃┃ Z │ - - - - - - - - - - - - - - - - - - - - - - - - - - │ ┃\n"
-        <<"┃                      ┃┃   └─────────────────────────────────────────────────────┘ ┃\n"
-        <<"┗━━━━━━━━━━━━━━━━━━━━━━┛┗━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━┛\n"
-        <<"┏━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━┓\n"
-        <<"┃ INPUT ::                                                                          ┃\n"
-        <<"┗━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━┛";
+    void Dashboard(const Tiles::View& board) {
+        Board = board.getSettings();
+        Source = &board;
+        Top = 1;
+        Left = 1;
+        Hidden = true;
+        Lost = false;
+        CursorY = 0;
+
+        const std::string Header = "┃                                                           ┃";
+
+        const std::string Blank = "┃                      ┃";
+        std::vector<std::string> Info = {
+            Blank,
+            infoLine("Total Bombs",std::to_string(Board.Mines)),
+            infoLine("Flags Used",placeholder("&*^")),
+            infoLine("Tiles Left",placeholder("!~%")),
+            Blank,
+            "┗━━━━━━━━━━━━━━━━━━━━━━┛",
+            "┏━LOG━━━━━━━━━━━━━━━━━━┓",
+        };
+        Info.resize(GRID_SIZE + 2,Blank);
+
+        std::vector<std::string> Lines = {
+            "┏━INFO━━━━━━━━━━━━━━━━━┓┏━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━┓",
+            Info[0] + Header,
+            Info[1] + "┃   ┌─────────────────────────────────────────────────────┐ ┃",
+        };
+        for (int Row = 1; Row <= GRID_SIZE; Row++) {
+            Lines.push_back(Info[Row + 1] + boardLine());
+        }
+        Lines.insert(Lines.end(),{
+            "┃                      ┃┃   └─────────────────────────────────────────────────────┘ ┃",
+            "┗━━━━━━━━━━━━━━━━━━━━━━┛┗━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━┛",
+            "┏━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━┓",
+            "┃ INPUT ::                                                                          ┃",
+            "┗━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━┛",
+        });
+
+        for (int Y = 0; Y < (int)Lines.size(); Y++) {
+            Terminal.Print(Y + 1,1,Lines[Y]);
+        }
+        drawWindow();
+        drawLog();
+        Terminal.Park(INPUT_Y,INPUT_X);
+        Terminal.Invalidate();
     }
 
     /**
-     * Log Handler
+     * Lets the terminal scroll the log panel itself, for terminals with left/right margins (DECLRMM)
      *
-     * @param key: The type of log to output
+     * @param enabled: If the terminal has them
+     */
+    void Margins(bool enabled) {
+        Terminal.useMargins(enabled);
+    }
+
+    /**
+     * Builds the message of a log
+     *
+     * @param key: The type of log
      * @param tile: Input tile
-     * @param failed_input: Status of the input
      *
+     * @return Message, as it is logged
      */
-    void Log(States::Log key, const std::pair<char,char>& tile) {
+    std::string Message(States::Log key, const std::pair<int,int>& tile) {
 
         std::string Message;
 
         switch (key)  {
             case States::Log::Tap:
-                Message = "Tapped Tile " + formatTile(tile);
+                Message = "Tapped Tile " + Coords::Format(tile);
                 break;
             case States::Log::Flag:
-                Message = "Flagged Tile " + formatTile(tile);
+                Message = "Flagged Tile " + Coords::Format(tile);
                 break;
             case States::Log::Unflag:
-                Message = "Unflagged Tile " + formatTile(tile);
+                Message = "Unflagged Tile " + Coords::Format(tile);
                 break;
             case States::Log::Flagfail:
-                Message = "Can't Flag Tile " + formatTile(tile);
+                Message = "Can't Flag Tile " + Coords::Format(tile);
                 break;
             case States::Log::Reset:
                 Message = "Reset Board";
@@ -229,8 +363,45 @@ namespace Output {
             case States::Log::Lose:
                 Message = "Game Lost";
                 break;
+            case States::Log::Undo:
+                Message = "Undid Move";
+                break;
+            case States::Log::Redo:
+                Message = "Redid Move";
+                break;
+            case States::Log::Save:
+                Message = "Saved Game";
+                break;
+            case States::Log::Load:
+                Message = "Loaded Game";
+                break;
+            case States::Log::Guess:
+                Message = "Board Needs Guessing";
+                break;
         }
-            insertLog(Message);
+        return Message;
+    }
+
+    /**
+     * Log Handler
+     *
+     * @param key: The type of log to output
+     * @param tile: Input tile
+     *
+     */
+    void Log(States::Log key, const std::pair<int,int>& tile) {
+        insertLog(Message(key,tile));
+    }
+
+    /**
+     * Logs the seed of a board, so that it can be replayed with --seed
+     *
+     * @param seed: Seed of the board
+     */
+    void Seed(std::uint64_t seed) {
+        std::stringstream ss;
+        ss << "Seed " << std::hex << std::setw(16) << std::setfill('0') << seed;
+        insertLog(ss.str());
     }
 
     /**
@@ -241,9 +412,16 @@ namespace Output {
     void Reveal(const Responses::Tap& response) {
         setFlagCount(response.NumFlags);
         setRemainingCount(response.NumTilesLeft);
+        Hidden = false;
+        Lost = response.State == States::Game::Lose;
 
+        // Past a window's worth of tiles, redrawing the window from the board is the cheaper way
+        if (response.Tiles.size() > (std::size_t)GRID_SIZE*GRID_SIZE) {
+            drawWindow();
+            return;
+        }
         for (const auto& TileData : response.Tiles) {
-            const std::pair<char,char> Tile = TileData.first;
+            const std::pair<int,int> Tile = TileData.first;
             const int AdjacentMines = TileData.second;
             revealTile(Tile,AdjacentMines);
         }
@@ -255,28 +433,78 @@ namespace Output {
      * @param flagged_tile: Tile where the flag will go on
      * @param response: Additional data to determine what to render
      */
-    void Flag(const std::pair<char,char>& flagged_tile, const Responses::Flag& response) {
+    void Flag(const std::pair<int,int>& flagged_tile, const Responses::Flag& response) {
         setFlagCount(response.NumFlags);
+        if (!onScreen(flagged_tile)) {return;}
 
-        const char* c;
-        if (response.State == States::Flag::Add)     {c = FLAG;}
-   else if (response.State == States::Flag::Remove)  {c = "-";}
-   else if (response.State == States::Flag::Nothing) {return;}
+        if (response.State == States::Flag::Add)     {putTile(flagged_tile,FLAG,FLAG_COLOUR);}
+   else if (response.State == States::Flag::Remove)  {putTile(flagged_tile,"-");}
+    }
 
-        const int Row = flagged_tile.first - CHAR_OFFSET;
-        const int Column = (flagged_tile.second - CHAR_OFFSET)*2;
+    /**
+     * Redraws the tiles changed by an undo or redo
+     *
+     * @param response: Changed tiles along with what they show now
+     */
+    void Step(const Responses::Step& response) {
+        setFlagCount(response.NumFlags);
+        setRemainingCount(response.NumTilesLeft);
+        Hidden = false;
+        Lost = response.State == States::Game::Lose;
 
-        std::cout << setCursor(TILE_OFFSET_Y + Row,TILE_OFFSET_X + Column) << c;
+        if (response.Tiles.size() > (std::size_t)GRID_SIZE*GRID_SIZE) {
+            drawWindow();
+            return;
+        }
+        for (const auto& TileData : response.Tiles) {
+            const std::pair<int,int> Tile = TileData.first;
+            if (TileData.second >= 0) {
+                revealTile(Tile,TileData.second);
+            } else if (onScreen(Tile)) {
+                if (TileData.second == -2) {putTile(Tile,FLAG,FLAG_COLOUR);}
+                else {putTile(Tile,"-");}
+            }
+        }
     }
 
     /**
      * Clears/Resets the board and info UI
      */
     void Reset() {
-        resetBoard();
+        Hidden = true;
+        Lost = false;
+        drawWindow();
         resetInfo();
     }
 
+    /**
+     * Moves the window over the board
+     *
+     * @param rows: Rows to move it down, negative for up
+     * @param columns: Columns to move it right, negative for left
+     */
+    void Pan(int rows, int columns) {
+        moveWindow(Top + rows,Left + columns);
+    }
+
+    /**
+     * Moves the window so that a tile is in the middle of it, or as close as the edges of the board allow
+     *
+     * @param tile: Tile to centre on
+     */
+    void Centre(const std::pair<int,int>& tile) {
+        moveWindow(tile.first - GRID_SIZE/2,tile.second - GRID_SIZE/2);
+    }
+
+    /**
+     * Brings a tile into the window if it's outside of it, e.g. the last one tapped
+     *
+     * @param tile: Tile to show
+     */
+    void Follow(const std::pair<int,int>& tile) {
+        if (!onScreen(tile)) {Centre(tile);}
+    }
+
     /**
      * Handles clearing the dashboard and outputting the session stats UI
      *
@@ -284,45 +512,84 @@ namespace Output {
      */
     void Quit(const Responses::SessionStats& stats) {
 
-        const std::string BoardsPlayed = formatStatLine("Boards Played    ", stats.BoardsPlayed);
-        const std::string GamesWonStat = formatStatLine("Games Won        ", stats.GamesWon) ;
-        const std::string GamesLostStat = formatStatLine("Games Lost       ", stats.GamesLost);
-        const std::string TilesRevealedStat = formatStatLine("Tiles Revealed   ", stats.TilesRevealed);
-
-        std::cout << setCursor(1,1)
-        << "┏━Session-Stats━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━┓\n"
-        << "┃                                                                                   ┃\n"
-        << "┃                                                                                   ┃\n"
-        << "┃                                                                                   ┃\n"
-        << "┃                                                                                   ┃\n"
-        << "┃                                                                                   ┃\n"
-        << "┃                                                                                   ┃\n"
-        << "┃                                                                                   ┃\n"
-        << "┃                                                                                   ┃\n"
-        << "┃                                                                                   ┃\n"
-        << "┃                                                                                   ┃\n"
-        << "┃                                                                                   ┃\n"
-        << "┃                                                                                   ┃\n"
-        << "┃                                                                                   ┃\n"
-        << BoardsPlayed
-        << GamesWonStat
-        << GamesLostStat
-        << TilesRevealedStat
-        << "┃                                                                                   ┃\n"
-        << "┃                                                                                   ┃\n"
-        << "┃                                                                                   ┃\n"
-        << "┃                                                                                   ┃\n"
-        << "┃                                                                                   ┃\n"
-        << "┃                                                                                   ┃\n"
-        << "┃                                                                                   ┃\n"
-        << "┃                                                                                   ┃\n"
-        << "┃                                                                                   ┃\n"
-        << "┃                                                                                   ┃\n"
-        << "┃                                                                                   ┃\n"
-        << "┃                                                                                   ┃\n"
-        << "┃                                                                                   ┃\n"
-        << "┃                                                                                   ┃\n"
-        << "┗━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━┛\n";
-    }
-
-}
\ No newline at end of file
+        const std::string Blank = "┃                                                                                   ┃";
+        std::vector<std::string> Lines(SCREEN_ROWS - 1,Blank);     // Leaves the last line to the shell
+        Lines.front() = "┏━Session-Stats━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━┓";
+        Lines[14] = formatStatLine("Boards Played    ", stats.BoardsPlayed);
+        Lines[15] = formatStatLine("Games Won        ", stats.GamesWon);
+        Lines[16] = formatStatLine("Games Lost       ", stats.GamesLost);
+        Lines[17] = formatStatLine("Tiles Revealed   ", stats.TilesRevealed);
+        Lines.back() = "┗━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━┛";
+
+        for (int Y = 0; Y < (int)Lines.size(); Y++) {
+            Terminal.Print(Y + 1,1,Lines[Y]);
+        }
+        Terminal.Park(SCREEN_ROWS,1);
+        Terminal.Flush();
+    }
+
+    /**
+     * Marks the tile under the keyboard's cursor, moving the window to it if it's outside of it
+     *
+     * @param tile: Tile under the cursor
+     */
+    void Cursor(const std::pair<int,int>& tile) {
+        Follow(tile);
+        if (CursorY) {
+            Terminal.Put(CursorY,CursorX - 1," ");
+            Terminal.Put(CursorY,CursorX + 1," ");
+        }
+        CursorY = TILE_OFFSET_Y + tile.first - Top + 1;
+        CursorX = TILE_OFFSET_X + (tile.second - Left + 1)*2;
+        Terminal.Put(CursorY,CursorX - 1,"[",CURSOR_COLOUR);
+        Terminal.Put(CursorY,CursorX + 1,"]",CURSOR_COLOUR);
+    }
+
+    /**
+     * Shows text on the input line, e.g. a command being typed a key at a time
+     *
+     * @param text: Text to show, at most as wide as the line
+     * @param editing: If the cursor is left after the text, otherwise it's left at the start of the line
+     */
+    void Typing(const std::string& text, bool editing) {
+        const int Length = Terminal.Print(INPUT_Y,INPUT_X,text);
+        Terminal.Print(INPUT_Y,INPUT_X + Length,std::string(std::max(0,SCREEN_COLUMNS - 1 - INPUT_X - Length),' '));
+        Terminal.Park(INPUT_Y,INPUT_X + (editing ? Length : 0));
+    }
+
+    /**
+     * Shows how long the board has been played for
+     *
+     * @param seconds: Seconds since its first tap
+     */
+    void Clock(long long seconds) {
+        const std::string Time = std::to_string(seconds/60) + ':' + std::to_string(seconds%60/10)
+            + std::to_string(seconds%10);
+        Terminal.Print(TIME_INFO_OFFSET_Y,1,infoLine("Time",Time));
+    }
+
+    /**
+     * Draws everything so far and clears the input line for the next command, e.g. after one was just typed there
+     */
+    void Prompt() {
+        Terminal.Flush();
+        const std::string Clear = "\033[" + std::to_string(INPUT_Y) + ';' + std::to_string(INPUT_X) + 'H';
+        const std::string Line = Clear + std::string(SCREEN_COLUMNS - INPUT_X,' ') + Clear;
+        std::cout << Line << std::flush;
+    }
+
+    /**
+     * Sends everything drawn since the last call to the terminal, as one write of only what changed
+     */
+    void Flush() {
+        Terminal.Flush();
+    }
+
+    /**
+     * Returns the bytes, cells and time taken by every frame so far
+     */
+    const Screen::Metrics& getMetrics() {
+        return Terminal.getMetrics();
+    }
+
+}
@@ -0,0 +1,318 @@
+#include "pipeline.hpp"
+
+namespace {
+
+    // Constants
+    constexpr int SPINS = 64;           // Waits spent spinning before yielding
+    constexpr int YIELDS = 64;          // Then yielding before sleeping
+    constexpr int MIN_SLEEP = 16;       // Microseconds, doubled on every wait after that
+    constexpr int MAX_SLEEP = 1000;
+
+    std::uint64_t micros(std::chrono::steady_clock::duration elapsed) {
+        return std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count();
+    }
+
+}
+
+namespace Pipeline {
+
+    void Backoff::Wait() {
+        if (Tries >= SPINS + YIELDS) {
+            const int Doublings = std::min(Tries - SPINS - YIELDS,10);
+            std::this_thread::sleep_for(std::chrono::microseconds(std::min(MAX_SLEEP,MIN_SLEEP << Doublings)));
+        } else if (Tries >= SPINS) {
+            std::this_thread::yield();
+        }
+        if (Tries < SPINS + YIELDS + 10) {Tries++;}
+    }
+
+    /**
+     * Starts showing a board, every tile hidden as the dashboard draws it
+     *
+     * @param settings: Size of the board
+     */
+    void Mirror::Deal(const Config::Settings& settings) {
+        Settings = settings;
+        Shown.assign((std::size_t)settings.Rows*settings.Columns,Tiles::HIDDEN);
+    }
+
+    void Mirror::Hide() {
+        std::fill(Shown.begin(),Shown.end(),Tiles::HIDDEN);
+    }
+
+    Stages::Stages(Render::Base& target, std::function<void(Command&)> source, bool prompt) :
+        Target(target),
+        Source(std::move(source)),
+        Prompting(prompt)
+    {
+        Reading = std::thread(&Stages::read,this);
+        Drawing = std::thread(&Stages::draw,this);
+    }
+
+    Stages::~Stages() {
+        Stop();
+    }
+
+    /**
+     * Reads commands until the last one, waiting for the engine whenever it is a whole queue behind
+     */
+    void Stages::read() {
+        Backoff Waiting;
+        while (true) {
+            Command Next;
+            Source(Next);
+            Next.Read = std::chrono::steady_clock::now();
+
+            const bool Last = Next.End || Next.Input.Key == States::Input::Quit;
+            while (!Commands.Push(Next)) {Waiting.Wait();}
+            Waiting.Reset();
+            if (Last) {return;}
+        }
+    }
+
+    /**
+     * Takes the next command, waiting for one to be read if there isn't one yet
+     *
+     * Called by the engine, which is taken to have finished the last command it took
+     *
+     * @return The command, Quit or End once nothing more will be read
+     */
+    Command Stages::Next() {
+        if (Running) {Measured.Engine.Add(micros(std::chrono::steady_clock::now() - Taken));}
+        Running = true;
+
+        Command Next;
+        Backoff Waiting;
+        while (!Commands.Pop(Next)) {Waiting.Wait();}
+        Taken = std::chrono::steady_clock::now();
+        Measured.InputDepth.Add(Commands.Size() + 1);
+        Measured.InputWait.Add(micros(Taken - Next.Read));
+        Current = Next.Read;
+        return Next;
+    }
+
+    /**
+     * Waits for a free slot in the render queue, whenever the render thread is a whole queue behind
+     *
+     * @param type: What the update is
+     *
+     * @return The slot, filled in by the caller and then handed over with commit
+     */
+    Stages::Update& Stages::slot(Update::Kind type) {
+        Update* Next;
+        while (!(Next = Updates.Back())) {Full.Wait();}
+        Full.Reset();
+        Next->Type = type;
+        Next->Read = Current;
+        return *Next;
+    }
+
+    void Stages::commit(Update& update) {
+        update.Queued = std::chrono::steady_clock::now();
+        Updates.Commit();
+    }
+
+    /**
+     * Draws updates as they come. Everything waiting is drawn in one go, then a frame is written once there's
+     * nothing left, so updates that arrive while a frame is being written all end up in the next one
+     */
+    void Stages::draw() {
+        Backoff Idle;
+        std::vector<std::chrono::steady_clock::time_point> Shown;     // When the commands in the frame were read
+        std::chrono::steady_clock::duration Spent(0);                 // Drawing the frame so far
+        bool Changed = false;   // Something was drawn that isn't on screen yet
+        bool Flushing = false;  // The engine asked for a frame
+        bool Stopping = false;
+
+        const auto frame = [&](bool write) {
+            const std::chrono::steady_clock::time_point Began = std::chrono::steady_clock::now();
+            if (write && Prompting) {Target.Prompt();}
+            else if (write)         {Target.Flush();}
+            const std::chrono::steady_clock::time_point Now = std::chrono::steady_clock::now();
+
+            Measured.Frame.Add(micros(Spent + (Now - Began)));
+            for (const std::chrono::steady_clock::time_point& Read : Shown) {Measured.Latency.Add(micros(Now - Read));}
+            Measured.Frames++;
+            Shown.clear();
+            Spent = std::chrono::steady_clock::duration(0);
+            Changed = Flushing = false;
+        };
+
+        while (!Stopping) {
+            const std::size_t Waiting = Updates.Size();
+            if (!Waiting) {
+                if (Changed && (Prompting || Flushing)) {frame(true);}
+                Idle.Wait();
+                continue;
+            }
+            Idle.Reset();
+            Measured.RenderDepth.Add(Waiting);
+
+            const std::chrono::steady_clock::time_point Began = std::chrono::steady_clock::now();
+            const Update* Next = nullptr;
+            for (std::size_t i = 0; i < Waiting && !Stopping && (Next = Updates.Front()); i++) {
+                Measured.RenderWait.Add(micros(Began - Next->Queued));
+                if (Next->Type == Update::Kind::Stop) {
+                    Stopping = true;
+                } else if (Next->Type == Update::Kind::Flush) {
+                    Flushing = true;
+                } else {
+                    // Before the first command there's only the dashboard, which nothing waited for
+                    Measured.Updates++;
+                    Changed = true;
+                    const bool Command = Next->Read != std::chrono::steady_clock::time_point();
+                    if (Command && (Shown.empty() || Shown.back() != Next->Read)) {Shown.push_back(Next->Read);}
+                    apply(*Next);
+
+                    // Quitting draws its own last frame
+                    if (Next->Type == Update::Kind::Quit) {frame(false);}
+                }
+                Updates.Release();
+            }
+            Spent += std::chrono::steady_clock::now() - Began;
+        }
+        if (Changed && Flushing) {frame(true);}
+    }
+
+    /**
+     * Draws an update on the real renderer, after showing what it changed on the mirror the window is drawn from
+     */
+    void Stages::apply(const Update& update) {
+        switch (update.Type) {
+            case Update::Kind::Dashboard:
+                Drawn.Deal(update.Settings);
+                Target.Dashboard(Drawn);
+                break;
+            case Update::Kind::Reveal:
+                for (const auto& TileData : update.Tap.Tiles) {Drawn.Show(TileData.first,TileData.second);}
+                Target.Reveal(update.Tap);
+                break;
+            case Update::Kind::Flag:
+                if (update.Flag.State == States::Flag::Add)         {Drawn.Show(update.Tile,Tiles::FLAGGED);}
+                else if (update.Flag.State == States::Flag::Remove) {Drawn.Show(update.Tile,Tiles::HIDDEN);}
+                Target.Flag(update.Tile,update.Flag);
+                break;
+            case Update::Kind::Step:
+                for (const auto& TileData : update.Step.Tiles) {Drawn.Show(TileData.first,TileData.second);}
+                Target.Step(update.Step);
+                break;
+            case Update::Kind::Reset:
+                Drawn.Hide();
+                Target.Reset();
+                break;
+            case Update::Kind::Log:         Target.Log(update.Key,update.Tile); break;
+            case Update::Kind::Seed:        Target.Seed(update.Seed); break;
+            case Update::Kind::Pan:         Target.Pan(update.Tile.first,update.Tile.second); break;
+            case Update::Kind::Centre:      Target.Centre(update.Tile); break;
+            case Update::Kind::Follow:      Target.Follow(update.Tile); break;
+            case Update::Kind::Quit:        Target.Quit(update.Stats); break;
+            case Update::Kind::Flush:
+            case Update::Kind::Stop:        break;
+        }
+    }
+
+    /**
+     * Draws everything still queued and stops the render thread, once the engine is done with the last command
+     */
+    void Stages::Stop() {
+        if (Stopped) {return;}
+        Stopped = true;
+
+        commit(slot(Update::Kind::Stop));
+        Drawing.join();
+        Reading.join();
+    }
+
+    /**
+     * Prints the queue depths and how long each stage took, once stopped
+     *
+     * @param out: Where to, e.g. std::cerr
+     */
+    void Stages::Report(std::ostream& out) const {
+        const auto row = [&out](const char* name, const Analytics::Histogram& histogram) {
+            out << std::left << std::setw(24) << name << std::right << std::setw(10) << histogram.Percentile(50)
+            << std::setw(10) << histogram.Percentile(99) << std::setw(10) << histogram.Max() << '\n';
+        };
+
+        out << Measured.Updates << " updates drawn in " << Measured.Frames << " frames\n"
+        << std::setw(34) << "median" << std::setw(10) << "99%" << std::setw(10) << "max" << '\n';
+        row("input queue depth",Measured.InputDepth);
+        row("render queue depth",Measured.RenderDepth);
+        row("input wait (us)",Measured.InputWait);
+        row("engine (us)",Measured.Engine);
+        row("render wait (us)",Measured.RenderWait);
+        row("frame (us)",Measured.Frame);
+        row("read to drawn (us)",Measured.Latency);
+    }
+
+    void Stages::Dashboard(const Tiles::View& board) {
+        Update& Next = slot(Update::Kind::Dashboard);
+        Next.Settings = board.getSettings();
+        commit(Next);
+    }
+
+    void Stages::Log(States::Log key, const std::pair<int,int>& tile) {
+        Update& Next = slot(Update::Kind::Log);
+        Next.Key = key;
+        Next.Tile = tile;
+        commit(Next);
+    }
+
+    void Stages::Seed(std::uint64_t seed) {
+        Update& Next = slot(Update::Kind::Seed);
+        Next.Seed = seed;
+        commit(Next);
+    }
+
+    void Stages::Reveal(const Responses::Tap& response) {
+        Update& Next = slot(Update::Kind::Reveal);
+        Next.Tap = response;
+        commit(Next);
+    }
+
+    void Stages::Flag(const std::pair<int,int>& tile, const Responses::Flag& response) {
+        Update& Next = slot(Update::Kind::Flag);
+        Next.Tile = tile;
+        Next.Flag = response;
+        commit(Next);
+    }
+
+    void Stages::Step(const Responses::Step& response) {
+        Update& Next = slot(Update::Kind::Step);
+        Next.Step = response;
+        commit(Next);
+    }
+
+    void Stages::Reset() {
+        commit(slot(Update::Kind::Reset));
+    }
+
+    void Stages::Pan(int rows, int columns) {
+        Update& Next = slot(Update::Kind::Pan);
+        Next.Tile = {rows,columns};
+        commit(Next);
+    }
+
+    void Stages::Centre(const std::pair<int,int>& tile) {
+        Update& Next = slot(Update::Kind::Centre);
+        Next.Tile = tile;
+        commit(Next);
+    }
+
+    void Stages::Follow(const std::pair<int,int>& tile) {
+        Update& Next = slot(Update::Kind::Follow);
+        Next.Tile = tile;
+        commit(Next);
+    }
+
+    void Stages::Quit(const Responses::SessionStats& stats) {
+        Update& Next = slot(Update::Kind::Quit);
+        Next.Stats = stats;
+        commit(Next);
+    }
+
+    void Stages::Flush() {
+        commit(slot(Update::Kind::Flush));
+    }
+
+}
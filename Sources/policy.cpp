@@ -0,0 +1,170 @@
+#include "policy.hpp"
+
+namespace {
+
+    /**
+     * First move of every policy, the middle of the board
+     */
+    inline Policy::Move opening(const Config::Settings& settings) {
+        return {States::Input::Tap,{(settings.Rows + 1)/2,(settings.Columns + 1)/2}};
+    }
+
+    /**
+     * Taps unrevealed, unflagged tiles at random
+     */
+    class Random : public Policy::Base {
+    public:
+        void Start(unsigned seed) override {
+            Rng.seed(seed);
+        }
+
+        Policy::Move Next(const Minesweeper::Game& game) override {
+            const Config::Settings& Settings = game.getSettings();
+            if (!game.Started()) {return opening(Settings);}
+
+            const Tiles::Board& Board = game.getBoard();
+            std::pair<int,int> Tile;
+            do {
+                Tile = {1 + Rng.Below(Settings.Rows),1 + Rng.Below(Settings.Columns)};
+            } while (Board.tileRevealed(Tile) || Board.tileFlagged(Tile));
+
+            return {States::Input::Tap,Tile};
+        }
+
+    private:
+        Prng::Generator Rng;
+    };
+
+    /**
+     * Taps the first unrevealed tile, reading the board left to right, top to bottom
+     */
+    class Scan : public Policy::Base {
+    public:
+        void Start(unsigned seed) override {
+            (void)seed;
+            Cursor = {1,1};
+        }
+
+        Policy::Move Next(const Minesweeper::Game& game) override {
+            const Config::Settings& Settings = game.getSettings();
+            if (!game.Started()) {return opening(Settings);}
+
+            const Tiles::Board& Board = game.getBoard();
+            while (Board.tileRevealed(Cursor)) {
+                if (Cursor.second == Settings.Columns) {
+                    Cursor = {Cursor.first + 1,1};
+                } else {
+                    Cursor.second++;
+                }
+            }
+            return {States::Input::Tap,Cursor};
+        }
+
+    private:
+        std::pair<int,int> Cursor = {1,1};
+    };
+
+    /**
+     * Taps every tile the solver proves safe, and guesses at random among the tiles it could not prove to be mines
+     * when there are none
+     */
+    class Solve : public Policy::Base {
+    public:
+        void Start(unsigned seed) override {
+            Rng.seed(seed);
+            Pending.clear();
+        }
+
+        Policy::Move Next(const Minesweeper::Game& game) override {
+            const Config::Settings& Settings = game.getSettings();
+            if (!game.Started()) {return opening(Settings);}
+
+            // Tiles proven safe stay safe, so the solver only runs again once all of them are tapped
+            const Tiles::Board& Board = game.getBoard();
+            while (!Pending.empty() && Board.tileRevealed(Pending.back())) {Pending.pop_back();}
+            if (Pending.empty()) {
+                const Solver::Result& Result = Solver.Solve(Board);
+                Pending.assign(Result.Safe.rbegin(),Result.Safe.rend());
+                Mines.assign(Settings.Rows*Settings.Columns,false);
+                for (const std::pair<int,int>& Mine : Result.Mines) {
+                    Mines[(Mine.first - 1)*Settings.Columns + Mine.second - 1] = true;
+                }
+            }
+            if (!Pending.empty()) {return {States::Input::Tap,Pending.back()};}
+
+            std::pair<int,int> Tile;
+            do {
+                Tile = {1 + Rng.Below(Settings.Rows),1 + Rng.Below(Settings.Columns)};
+            } while (Board.tileRevealed(Tile) || Mines[(Tile.first - 1)*Settings.Columns + Tile.second - 1]);
+
+            return {States::Input::Tap,Tile};
+        }
+
+    private:
+        Prng::Generator Rng;
+        Solver::Engine Solver;
+        std::vector<std::pair<int,int>> Pending;
+        std::vector<bool> Mines;
+    };
+
+    /**
+     * Taps every tile that is certainly safe, otherwise the tile least likely to be a mine
+     */
+    class Odds : public Policy::Base {
+    public:
+        void Start(unsigned seed) override {
+            (void)seed;
+            Pending.clear();
+        }
+
+        Policy::Move Next(const Minesweeper::Game& game) override {
+            const Config::Settings& Settings = game.getSettings();
+            if (!game.Started()) {return opening(Settings);}
+
+            const Tiles::Board& Board = game.getBoard();
+            while (!Pending.empty() && Board.tileRevealed(Pending.back())) {Pending.pop_back();}
+            if (!Pending.empty()) {return {States::Input::Tap,Pending.back()};}
+
+            const std::vector<double>& Chances = Engine.Compute(Board);
+            int Best = -1;
+            for (int i = 0; i < (int)Chances.size(); i++) {
+                const std::pair<int,int> Tile = {1 + i/Settings.Columns,1 + i%Settings.Columns};
+                if (Board.tileRevealed(Tile)) {continue;}
+                if (Chances[i] == 0) {Pending.push_back(Tile);}
+                if (Best < 0 || Chances[i] < Chances[Best]) {Best = i;}
+            }
+            return {States::Input::Tap,{1 + Best/Settings.Columns,1 + Best%Settings.Columns}};
+        }
+
+    private:
+        Probability::Engine Engine;
+        std::vector<std::pair<int,int>> Pending;
+    };
+
+}
+
+namespace Policy {
+
+    /**
+     * Creates a policy by name
+     *
+     * @param name: One of Names()
+     *
+     * @return The policy, or nullptr if there is no policy with that name
+     */
+    std::unique_ptr<Base> Create(const std::string& name) {
+        if (name == "random") {return std::unique_ptr<Base>(new Random());}
+        if (name == "scan")   {return std::unique_ptr<Base>(new Scan());}
+        if (name == "solver") {return std::unique_ptr<Base>(new Solve());}
+        if (name == "probability") {return std::unique_ptr<Base>(new Odds());}
+        return nullptr;
+    }
+
+    /**
+     * Returns the names of every policy, for usage messages
+     */
+    const char* Names() {
+        return "random, scan, solver, probability";
+    }
+
+}
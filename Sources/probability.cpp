@@ -0,0 +1,619 @@
+#include "probability.hpp"
+
+namespace {
+
+    // Components that take more steps than this to enumerate are left out, their tiles get the average odds
+    constexpr long SEARCH_STEPS = 1L << 24;
+    constexpr long STEP_BATCH = 4096;
+
+    // Components too big to ever enumerate, this also bounds the memory their counts need
+    constexpr int MAX_CELLS = 400;
+
+    // Components with at least this many groups are split between threads, by fixing their first PREFIX_DEPTH groups
+    constexpr int PARALLEL_GROUPS = 24;
+    constexpr int PREFIX_DEPTH = 10;
+
+    // A group shares all of its numbers, so it fits around one of them
+    constexpr int MAX_GROUP = 8;
+
+    /**
+     * Depth first search over the arrangements of mines in a component
+     *
+     * Every constraint keeps how many of its mines are placed and how many of its tiles are still open, so a group
+     * only has to check the constraints it is part of. A group holding v of its n tiles in mines stands for C(n,v)
+     * arrangements.
+     */
+    class Walker {
+    public:
+        Walker(const Probability::Component& component, int most_mines) :
+            Part(component),
+            Groups(component.GroupStart.size() - 1),
+            MostMines(most_mines),
+            Placed(component.Needed.size(),0),
+            Open(component.Needed.size(),0),
+            Value(Groups,-1),
+            Path(Groups + 1,1)
+        {
+            for (size_t k = 0; k < Open.size(); k++) {
+                for (int m = Part.MemberStart[k]; m < Part.MemberStart[k + 1]; m++) {
+                    Open[k] += size(Part.Members[m]);
+                }
+            }
+            for (int n = 0; n <= MAX_GROUP; n++) {
+                Choose[n][0] = 1;
+                for (int v = 1; v <= n; v++) {
+                    Choose[n][v] = Choose[n][v - 1]*(n - v + 1)/v;
+                }
+            }
+            MineList.reserve(Groups);
+        }
+
+        std::vector<double> Weights;
+        std::vector<double> MineWeights;
+
+        const signed char* values() const {return Value.data();}
+
+        // Counts the current arrangement, once every group has a value
+        void count() {
+            const double Ways = Path[Groups];
+            Weights[Mines] += Ways;
+            double* Row = &MineWeights[(size_t)Mines*Groups];
+            for (int Group : MineList) {
+                Row[Group] += Ways*Value[Group];
+            }
+        }
+
+        void clear() {
+            Weights.assign(Part.Cells.size() + 1,0);
+            MineWeights.assign((Part.Cells.size() + 1)*Groups,0);
+        }
+
+        // Gives the first depth groups the values of a prefix found by another walker
+        void fix(const signed char* prefix, int depth) {
+            for (int i = 0; i < depth; i++) {
+                Value[i] = prefix[i];
+                place(i);
+            }
+        }
+
+        void unfix(int depth) {
+            for (int i = depth - 1; i >= 0; i--) {
+                unplace(i);
+                Value[i] = -1;
+            }
+        }
+
+        /**
+         * Tries every value of the groups from first up to last
+         *
+         * @param steps: Steps taken so far by every walker of the component
+         * @param leaf: Called with the walker for every arrangement that fits
+         *
+         * @return False if the search ran out of steps, the walker can't be used again
+         */
+        template <typename Leaf>
+        bool walk(int first, int last, std::atomic<long>& steps, Leaf leaf) {
+            long Local = 0;
+            int i = first;
+            while (i >= first) {
+                if (i == last) {
+                    leaf(*this);
+                    unplace(--i);
+                }
+
+                if (Value[i] == size(i)) {
+                    Value[i] = -1;
+                    if (--i >= first) {unplace(i);}
+                    continue;
+                }
+                if (++Local == STEP_BATCH) {
+                    if (steps.fetch_add(Local) + Local > SEARCH_STEPS) {return false;}
+                    Local = 0;
+                }
+                Value[i]++;
+                if (place(i)) {
+                    i++;
+                } else {
+                    unplace(i);
+                }
+            }
+            steps += Local;
+            return true;
+        }
+
+    private:
+        const Probability::Component& Part;
+        int Groups;
+        int MostMines;
+        int Mines = 0;
+        std::vector<int> Placed;
+        std::vector<int> Open;
+        std::vector<signed char> Value;
+        std::vector<double> Path;   // Arrangements of the groups before each group
+        std::vector<int> MineList;
+        double Choose[MAX_GROUP + 1][MAX_GROUP + 1];
+
+        int size(int group) const {
+            return Part.GroupStart[group + 1] - Part.GroupStart[group];
+        }
+
+        bool place(int group) {
+            const int Size = size(group);
+            const int Held = Value[group];
+            bool Fits = Mines + Held <= MostMines;
+            Mines += Held;
+            Path[group + 1] = Path[group]*Choose[Size][Held];
+            if (Held) {MineList.push_back(group);}
+            for (int l = Part.LinkStart[group]; l < Part.LinkStart[group + 1]; l++) {
+                const int k = Part.Links[l];
+                Open[k] -= Size;
+                Placed[k] += Held;
+                if (Placed[k] > Part.Needed[k] || Placed[k] + Open[k] < Part.Needed[k]) {Fits = false;}
+            }
+            return Fits;
+        }
+
+        void unplace(int group) {
+            const int Size = size(group);
+            const int Held = Value[group];
+            Mines -= Held;
+            if (Held) {MineList.pop_back();}
+            for (int l = Part.LinkStart[group]; l < Part.LinkStart[group + 1]; l++) {
+                Open[Part.Links[l]] += Size;
+                Placed[Part.Links[l]] -= Held;
+            }
+        }
+    };
+
+    /**
+     * Lists the constraints of every tile, or every group, of a component
+     *
+     * @param units: Number of tiles or groups the members of the constraints refer to
+     */
+    void link(Probability::Component& component, int units) {
+        component.LinkStart.assign(units + 1,0);
+        for (int Member : component.Members) {
+            component.LinkStart[Member + 1]++;
+        }
+        for (int i = 0; i < units; i++) {
+            component.LinkStart[i + 1] += component.LinkStart[i];
+        }
+
+        std::vector<int> Next(component.LinkStart.begin(),component.LinkStart.end() - 1);
+        component.Links.resize(component.Members.size());
+        for (size_t k = 0; k + 1 < component.MemberStart.size(); k++) {
+            for (int m = component.MemberStart[k]; m < component.MemberStart[k + 1]; m++) {
+                component.Links[Next[component.Members[m]]++] = k;
+            }
+        }
+    }
+
+    std::vector<double> convolve(const std::vector<double>& a, const std::vector<double>& b) {
+        std::vector<double> Product(a.size() + b.size() - 1,0);
+        for (size_t i = 0; i < a.size(); i++) {
+            if (!a[i]) {continue;}
+            for (size_t j = 0; j < b.size(); j++) {
+                Product[i + j] += a[i]*b[j];
+            }
+        }
+        return Product;
+    }
+
+}
+
+namespace Probability {
+
+    /**
+     * Works out the chance of every tile being a mine
+     *
+     * @param board: Board to look at, only what a player can see of it is used
+     *
+     * @return One chance per tile in row major order, 0 for revealed tiles. Valid until the next call
+     */
+    const std::vector<double>& Engine::Compute(const Tiles::Board& board) {
+        const Config::Settings& Settings = board.getSettings();
+        Rows = Settings.Rows;
+        Columns = Settings.Columns;
+        Threads = Settings.Threads;
+        IsExact = true;
+
+        board.getView(View);
+        Odds.assign(View.size(),0);
+        Known.assign(View.size(),UNKNOWN);
+
+        const Solver::Result& Proven = Solver.Solve(board);
+        for (const std::pair<int,int>& Tile : Proven.Safe) {
+            Known[(Tile.first - 1)*Columns + Tile.second - 1] = SAFE;
+        }
+        for (const std::pair<int,int>& Tile : Proven.Mines) {
+            Known[(Tile.first - 1)*Columns + Tile.second - 1] = MINE;
+            Odds[(Tile.first - 1)*Columns + Tile.second - 1] = 1;
+        }
+        const int RemainingMines = Settings.Mines - Proven.Mines.size();
+
+        findComponents();
+        size_t Kept = 0;
+        for (size_t c = 0; c < Components.size(); c++) {
+            if (enumerate(Components[c],RemainingMines)) {
+                if (Kept != c) {std::swap(Components[Kept],Components[c]);}
+                Kept++;
+            } else {
+                IsExact = false;
+                for (int Index : Components[c].Cells) {
+                    CellAt[Index] = -1;
+                }
+            }
+        }
+        Components.resize(Kept);
+
+        int Interior = 0;
+        for (size_t i = 0; i < View.size(); i++) {
+            if (View[i] < 0 && Known[i] == UNKNOWN && CellAt[i] < 0) {Interior++;}
+        }
+        combine(RemainingMines,Interior);
+        return Odds;
+    }
+
+    // Finds the component of a frontier tile
+    int Engine::root(int cell) {
+        while (Parent[cell] != cell) {
+            Parent[cell] = Parent[Parent[cell]];
+            cell = Parent[cell];
+        }
+        return cell;
+    }
+
+    /**
+     * Splits the unknown tiles next to revealed numbers into components that share no numbers
+     */
+    void Engine::findComponents() {
+        Constraints.clear();
+        Frontier.clear();
+        Parent.clear();
+        CellAt.assign(View.size(),-1);
+
+        for (int Row = 0; Row < Rows; Row++) {
+            for (int Column = 0; Column < Columns; Column++) {
+                const int Index = Row*Columns + Column;
+                if (View[Index] < 0) {continue;}
+
+                Constraint Number = {Index,0,View[Index]};
+                for (int dr = -1; dr <= 1; dr++) {
+                    if (Row + dr < 0 || Row + dr >= Rows) {continue;}
+                    for (int dc = -1; dc <= 1; dc++) {
+                        if (Column + dc < 0 || Column + dc >= Columns) {continue;}
+                        const int Adjacent = Index + dr*Columns + dc;
+                        if (View[Adjacent] >= 0) {continue;}
+
+                        if (Known[Adjacent] == MINE) {
+                            Number.Needed--;
+                        } else if (Known[Adjacent] == UNKNOWN) {
+                            Number.Mask |= 1u << ((dr + 1)*3 + dc + 1);
+                        }
+                    }
+                }
+                if (!Number.Mask) {continue;}
+
+                int First = -1;
+                for (unsigned Mask = Number.Mask; Mask; Mask &= Mask - 1) {
+                    const int Bit = __builtin_ctz(Mask);
+                    const int Adjacent = Index + (Bit/3 - 1)*Columns + (Bit%3 - 1);
+                    if (CellAt[Adjacent] < 0) {
+                        CellAt[Adjacent] = Frontier.size();
+                        Parent.push_back(Frontier.size());
+                        Frontier.push_back(Adjacent);
+                    }
+                    if (First < 0) {
+                        First = root(CellAt[Adjacent]);
+                    } else {
+                        Parent[root(CellAt[Adjacent])] = First;
+                    }
+                }
+                Constraints.push_back(Number);
+            }
+        }
+
+        // Number the components, then give every tile its position within its component
+        std::vector<int> ComponentOf(Frontier.size(),-1);
+        int NumComponents = 0;
+        for (size_t i = 0; i < Frontier.size(); i++) {
+            const int Root = root(i);
+            if (ComponentOf[Root] < 0) {ComponentOf[Root] = NumComponents++;}
+            ComponentOf[i] = ComponentOf[Root];
+        }
+
+        Components.resize(NumComponents);
+        for (Component& Part : Components) {
+            Part.Cells.clear();
+            Part.Needed.clear();
+            Part.MemberStart.assign(1,0);
+            Part.Members.clear();
+        }
+        std::vector<int> ConstraintOf(Constraints.size());
+        for (size_t k = 0; k < Constraints.size(); k++) {
+            const int Bit = __builtin_ctz(Constraints[k].Mask);
+            ConstraintOf[k] = ComponentOf[CellAt[Constraints[k].Index + (Bit/3 - 1)*Columns + (Bit%3 - 1)]];
+        }
+        for (size_t i = 0; i < Frontier.size(); i++) {
+            Component& Part = Components[ComponentOf[i]];
+            CellAt[Frontier[i]] = Part.Cells.size();
+            Part.Cells.push_back(Frontier[i]);
+        }
+
+        for (size_t k = 0; k < Constraints.size(); k++) {
+            const Constraint& Number = Constraints[k];
+            Component& Part = Components[ConstraintOf[k]];
+            Part.Needed.push_back(Number.Needed);
+            for (unsigned Mask = Number.Mask; Mask; Mask &= Mask - 1) {
+                const int Bit = __builtin_ctz(Mask);
+                Part.Members.push_back(CellAt[Number.Index + (Bit/3 - 1)*Columns + (Bit%3 - 1)]);
+            }
+            Part.MemberStart.push_back(Part.Members.size());
+        }
+
+        for (Component& Part : Components) {
+            order(Part);
+        }
+    }
+
+    /**
+     * Groups the tiles of a component that are next to exactly the same numbers, and puts the groups in breadth
+     * first order, so that constraints fill up, and prune, as early as possible
+     */
+    void Engine::order(Component& component) {
+        const int Size = component.Cells.size();
+        link(component,Size);
+
+        // Sorting tiles by their constraints puts every group in one run
+        auto links = [&component](int cell) {
+            return std::make_pair(component.Links.begin() + component.LinkStart[cell],
+                component.Links.begin() + component.LinkStart[cell + 1]);
+        };
+        std::vector<int> Sorted(Size);
+        for (int i = 0; i < Size; i++) {
+            Sorted[i] = i;
+        }
+        std::sort(Sorted.begin(),Sorted.end(),[&links](int a, int b) {
+            const auto A = links(a);
+            const auto B = links(b);
+            return std::lexicographical_compare(A.first,A.second,B.first,B.second);
+        });
+
+        std::vector<int> GroupOf(Size);
+        std::vector<int> Runs = {0};
+        for (int i = 1; i <= Size; i++) {
+            if (i < Size) {
+                const auto A = links(Sorted[i - 1]);
+                const auto B = links(Sorted[i]);
+                if (A.second - A.first == B.second - B.first && std::equal(A.first,A.second,B.first)) {continue;}
+            }
+            Runs.push_back(i);
+        }
+        const int Groups = Runs.size() - 1;
+        for (int g = 0; g < Groups; g++) {
+            for (int i = Runs[g]; i < Runs[g + 1]; i++) {
+                GroupOf[Sorted[i]] = g;
+            }
+        }
+
+        // Constraints now list groups instead of tiles
+        std::vector<int> Members;
+        std::vector<int> Seen(Groups,-1);
+        for (size_t k = 0; k + 1 < component.MemberStart.size(); k++) {
+            const int First = Members.size();
+            for (int m = component.MemberStart[k]; m < component.MemberStart[k + 1]; m++) {
+                const int Group = GroupOf[component.Members[m]];
+                if (Seen[Group] == (int)k) {continue;}
+                Seen[Group] = k;
+                Members.push_back(Group);
+            }
+            component.MemberStart[k] = First;
+        }
+        component.MemberStart.back() = Members.size();
+        component.Members.swap(Members);
+        link(component,Groups);
+
+        std::vector<int> Position(Groups,-1);
+        std::vector<int> Order = {0};
+        Position[0] = 0;
+        for (size_t Head = 0; Head < Order.size(); Head++) {
+            const int Group = Order[Head];
+            for (int l = component.LinkStart[Group]; l < component.LinkStart[Group + 1]; l++) {
+                const int k = component.Links[l];
+                for (int m = component.MemberStart[k]; m < component.MemberStart[k + 1]; m++) {
+                    const int Member = component.Members[m];
+                    if (Position[Member] >= 0) {continue;}
+                    Position[Member] = Order.size();
+                    Order.push_back(Member);
+                }
+            }
+        }
+
+        const std::vector<int> Cells = component.Cells;
+        component.Cells.clear();
+        component.GroupStart.assign(1,0);
+        for (int Group : Order) {
+            for (int i = Runs[Group]; i < Runs[Group + 1]; i++) {
+                CellAt[Cells[Sorted[i]]] = component.Cells.size();
+                component.Cells.push_back(Cells[Sorted[i]]);
+            }
+            component.GroupStart.push_back(component.Cells.size());
+        }
+        for (int& Member : component.Members) {
+            Member = Position[Member];
+        }
+        link(component,Groups);
+    }
+
+    /**
+     * Counts every arrangement of mines in a component, by the number of mines it uses
+     *
+     * @param most_mines: Mines left for the whole board, no arrangement can use more
+     *
+     * @return False if the component is too big to enumerate
+     */
+    bool Engine::enumerate(Component& component, int most_mines) {
+        if ((int)component.Cells.size() > MAX_CELLS) {return false;}
+        const int Size = component.GroupStart.size() - 1;
+
+        std::atomic<long> Steps(0);
+        if (Threads == 1 || Size < PARALLEL_GROUPS) {
+            Walker Search(component,most_mines);
+            Search.clear();
+            if (!Search.walk(0,Size,Steps,[](Walker& walker) {walker.count();})) {return false;}
+
+            component.Weights.swap(Search.Weights);
+            component.MineWeights.swap(Search.MineWeights);
+            return true;
+        }
+
+        // Every arrangement of the first groups is searched separately, by whichever thread is free
+        const int Depth = std::min(Size - 1,PREFIX_DEPTH);
+        std::vector<signed char> Prefixes;
+        Walker Split(component,most_mines);
+        if (!Split.walk(0,Depth,Steps,[&Prefixes,Depth](Walker& walker) {
+            Prefixes.insert(Prefixes.end(),walker.values(),walker.values() + Depth);
+        })) {return false;}
+        const int NumPrefixes = Prefixes.size()/Depth;
+
+        std::vector<Walker> Searches(Threads,Split);
+        std::atomic<int> Next(0);
+        std::atomic<bool> Failed(false);
+        auto work = [&](Walker& search) {
+            search.clear();
+            while (!Failed) {
+                const int Prefix = Next++;
+                if (Prefix >= NumPrefixes) {break;}
+
+                search.fix(&Prefixes[(size_t)Prefix*Depth],Depth);
+                if (!search.walk(Depth,Size,Steps,[](Walker& walker) {walker.count();})) {
+                    Failed = true;
+                    break;
+                }
+                search.unfix(Depth);
+            }
+        };
+
+        std::vector<std::thread> Workers;
+        for (int t = 1; t < Threads; t++) {
+            Workers.emplace_back(work,std::ref(Searches[t]));
+        }
+        work(Searches[0]);
+        for (std::thread& Worker : Workers) {
+            Worker.join();
+        }
+        if (Failed) {return false;}
+
+        component.Weights.swap(Searches[0].Weights);
+        component.MineWeights.swap(Searches[0].MineWeights);
+        for (int t = 1; t < Threads; t++) {
+            for (size_t i = 0; i < component.Weights.size(); i++) {
+                component.Weights[i] += Searches[t].Weights[i];
+            }
+            for (size_t i = 0; i < component.MineWeights.size(); i++) {
+                component.MineWeights[i] += Searches[t].MineWeights[i];
+            }
+        }
+        return true;
+    }
+
+    /**
+     * Combines the counts of every component into chances
+     *
+     * A frontier using s mines leaves C(interior, remaining_mines - s) ways to place the rest, so every count is
+     * weighted by that. Each component's counts are scaled by their largest, and the binomials by the largest one,
+     * as the scales cancel out and keep everything in range of a double.
+     *
+     * @param remaining_mines: Mines not proven by the solver
+     * @param interior: Unknown tiles that are not next to any revealed number
+     */
+    void Engine::combine(int remaining_mines, int interior) {
+        size_t MostFrontierMines = 0;
+        for (Component& Part : Components) {
+            const double Largest = *std::max_element(Part.Weights.begin(),Part.Weights.end());
+            for (double& Weight : Part.Weights) {
+                Weight /= Largest;
+            }
+            for (double& Weight : Part.MineWeights) {
+                Weight /= Largest;
+            }
+            MostFrontierMines += Part.Cells.size();
+        }
+
+        // Ways to place the mines left for the interior, by frontier mines
+        std::vector<double> Ways(MostFrontierMines + 1,0);
+        double Largest = -HUGE_VAL;
+        for (size_t s = 0; s < Ways.size(); s++) {
+            const int Left = remaining_mines - (int)s;
+            if (Left < 0 || Left > interior) {
+                Ways[s] = -HUGE_VAL;
+                continue;
+            }
+            Ways[s] = std::lgamma(interior + 1.0) - std::lgamma(Left + 1.0) - std::lgamma(interior - Left + 1.0);
+            Largest = std::max(Largest,Ways[s]);
+        }
+        for (double& Weight : Ways) {
+            Weight = std::exp(Weight - Largest);
+        }
+
+        // Before[c] combines every component before c, After[c] every component from c on
+        std::vector<std::vector<double>> After(Components.size() + 1,std::vector<double>(1,1.0));
+        for (int c = Components.size() - 1; c >= 0; c--) {
+            After[c] = convolve(Components[c].Weights,After[c + 1]);
+        }
+        const std::vector<double>& Everything = After[0];
+
+        double Total = 0;
+        double InteriorMines = 0;
+        for (size_t s = 0; s < Everything.size(); s++) {
+            Total += Everything[s]*Ways[s];
+            InteriorMines += Everything[s]*Ways[s]*(remaining_mines - (int)s);
+        }
+
+        // Nothing fits the numbers, only possible if the step budget cut something off
+        if (!(Total > 0) || !std::isfinite(Total)) {
+            IsExact = false;
+            const double Average = interior ? std::max(0.0,std::min(1.0,(double)remaining_mines/interior)) : 0;
+            for (size_t i = 0; i < View.size(); i++) {
+                if (View[i] < 0 && Known[i] == UNKNOWN) {Odds[i] = Average;}
+            }
+            return;
+        }
+
+        std::vector<double> Before(1,1.0);
+        for (size_t c = 0; c < Components.size(); c++) {
+            const Component& Part = Components[c];
+            const int Size = Part.Cells.size();
+            const std::vector<double> Others = convolve(Before,After[c + 1]);
+
+            // Weight of every mine count of this component, with everything else around it
+            std::vector<double> Context(Size + 1,0);
+            for (int k = 0; k <= Size; k++) {
+                for (size_t t = 0; t < Others.size() && k + t < Ways.size(); t++) {
+                    Context[k] += Others[t]*Ways[k + t];
+                }
+            }
+
+            // Every tile of a group is as likely to be a mine
+            const int Groups = Part.GroupStart.size() - 1;
+            for (int g = 0; g < Groups; g++) {
+                double Mine = 0;
+                for (int k = 0; k <= Size; k++) {
+                    Mine += Part.MineWeights[(size_t)k*Groups + g]*Context[k];
+                }
+                const double Chance = std::min(1.0,Mine/Total/(Part.GroupStart[g + 1] - Part.GroupStart[g]));
+                for (int i = Part.GroupStart[g]; i < Part.GroupStart[g + 1]; i++) {
+                    Odds[Part.Cells[i]] = Chance;
+                }
+            }
+            Before = convolve(Before,Part.Weights);
+        }
+
+        if (interior) {
+            const double Interior = std::min(1.0,InteriorMines/Total/interior);
+            for (size_t i = 0; i < View.size(); i++) {
+                if (View[i] < 0 && Known[i] == UNKNOWN && CellAt[i] < 0) {Odds[i] = Interior;}
+            }
+        }
+    }
+}
@@ -0,0 +1,102 @@
+#include "render.hpp"
+
+namespace {
+
+    // The dashboard, drawn with ANSI escape codes, see output.cpp
+    class Ansi : public Render::Base {
+    public:
+        void Dashboard(const Tiles::View& board) override {Output::Dashboard(board);}
+        void Log(States::Log key, const std::pair<int,int>& tile) override {Output::Log(key,tile);}
+        void Seed(std::uint64_t seed) override {Output::Seed(seed);}
+        void Reveal(const Responses::Tap& response) override {Output::Reveal(response);}
+        void Flag(const std::pair<int,int>& tile, const Responses::Flag& response) override {
+            Output::Flag(tile,response);
+        }
+        void Step(const Responses::Step& response) override {Output::Step(response);}
+        void Reset() override {Output::Reset();}
+        void Pan(int rows, int columns) override {Output::Pan(rows,columns);}
+        void Centre(const std::pair<int,int>& tile) override {Output::Centre(tile);}
+        void Follow(const std::pair<int,int>& tile) override {Output::Follow(tile);}
+        void Quit(const Responses::SessionStats& stats) override {Output::Quit(stats);}
+        void Cursor(const std::pair<int,int>& tile) override {Output::Cursor(tile);}
+        void Typing(const std::string& text, bool editing) override {Output::Typing(text,editing);}
+        void Clock(long long seconds) override {Output::Clock(seconds);}
+        void Prompt() override {Output::Prompt();}
+        void Flush() override {Output::Flush();}
+    };
+
+    // Shows nothing
+    class Null : public Render::Base {};
+
+    /**
+     * One plain line per thing that happened, for logs and pipes
+     *
+     * Lines only ever go to stdout, so prompts and escape codes never end up in the output
+     */
+    class Text : public Render::Base {
+    public:
+        void Dashboard(const Tiles::View& board) override {
+            const Config::Settings& Settings = board.getSettings();
+            std::cout << "Board " << Settings.Rows << 'x' << Settings.Columns << ", " << Settings.Mines << " mines\n";
+        }
+
+        void Log(States::Log key, const std::pair<int,int>& tile) override {
+            std::cout << Output::Message(key,tile) << '\n';
+        }
+
+        void Seed(std::uint64_t seed) override {
+            std::stringstream ss;
+            ss << "Seed " << std::hex << std::setw(16) << std::setfill('0') << seed << '\n';
+            std::cout << ss.str();
+        }
+
+        // A loss is logged on its own, its tiles are only the mines
+        void Reveal(const Responses::Tap& response) override {
+            if (response.State == States::Game::Lose) {return;}
+            std::cout << "Revealed " << response.Tiles.size() << " tiles, " << response.NumTilesLeft << " left, "
+            << response.NumFlags << " flags\n";
+        }
+
+        void Step(const Responses::Step& response) override {
+            std::cout << "Changed " << response.Tiles.size() << " tiles, " << response.NumTilesLeft << " left, "
+            << response.NumFlags << " flags\n";
+        }
+
+        void Quit(const Responses::SessionStats& stats) override {
+            std::cout
+            << "Boards Played    " << stats.BoardsPlayed << '\n'
+            << "Games Won        " << stats.GamesWon << '\n'
+            << "Games Lost       " << stats.GamesLost << '\n'
+            << "Tiles Revealed   " << stats.TilesRevealed << '\n' << std::flush;
+        }
+
+        void Prompt() override {std::cout << std::flush;}
+        void Flush() override {std::cout << std::flush;}
+    };
+
+}
+
+namespace Render {
+
+    /**
+     * Creates a renderer by name
+     *
+     * @param name: One of Names()
+     *
+     * @return The renderer, or nullptr if there is no renderer with that name
+     */
+    std::unique_ptr<Base> Create(const std::string& name) {
+        if (name == "ansi") {return std::unique_ptr<Base>(new Ansi());}
+        if (name == "null") {return std::unique_ptr<Base>(new Null());}
+        if (name == "text") {return std::unique_ptr<Base>(new Text());}
+        return nullptr;
+    }
+
+    /**
+     * Returns the names of every renderer, for usage messages
+     */
+    const char* Names() {
+        return "ansi, null, text";
+    }
+
+}
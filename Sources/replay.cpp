@@ -0,0 +1,340 @@
+#include "replay.hpp"
+
+namespace {
+
+    constexpr char MAGIC[8] = {'M','I','N','E','P','L','A','Y'};
+    constexpr int KEY_BITS = 3;
+    constexpr std::uint64_t START_BIT = 1 << KEY_BITS;
+    constexpr int DELAY_SHIFT = KEY_BITS + 1;
+
+    // Keys as they are written, fixed whatever order States::Input is in. New keys only ever go on the end
+    enum class Wire : std::uint8_t {
+        Tap = 0,
+        Flag = 1,
+        Reset = 2,
+        Undo = 3,
+        Redo = 4,
+        Count
+    };
+    static_assert((int)Wire::Count <= 1 << KEY_BITS, "Every recorded key has to fit in KEY_BITS");
+
+    /**
+     * @param key: Key of an event
+     * @param wire: Output, the key as it is written
+     *
+     * @return If the key is one that gets recorded
+     */
+    bool encode(States::Input key, Wire& wire) {
+        switch (key) {
+            case States::Input::Tap:    wire = Wire::Tap; return true;
+            case States::Input::Flag:   wire = Wire::Flag; return true;
+            case States::Input::Reset:  wire = Wire::Reset; return true;
+            case States::Input::Undo:   wire = Wire::Undo; return true;
+            case States::Input::Redo:   wire = Wire::Redo; return true;
+            default:                    return false;
+        }
+    }
+
+    /**
+     * @param value: Key as it was written
+     * @param key: Output, the key
+     *
+     * @return If it is a key that gets recorded
+     */
+    bool decode(std::uint64_t value, States::Input& key) {
+        switch ((Wire)value) {
+            case Wire::Tap:     key = States::Input::Tap; return true;
+            case Wire::Flag:    key = States::Input::Flag; return true;
+            case Wire::Reset:   key = States::Input::Reset; return true;
+            case Wire::Undo:    key = States::Input::Undo; return true;
+            case Wire::Redo:    key = States::Input::Redo; return true;
+            default:            return false;
+        }
+    }
+
+    void putVarint(std::vector<unsigned char>& out, std::uint64_t value) {
+        while (value >= 0x80) {
+            out.push_back((value & 0x7F) | 0x80);
+            value >>= 7;
+        }
+        out.push_back(value);
+    }
+
+    void putFixed(std::vector<unsigned char>& out, std::uint64_t value, int bytes) {
+        for (int i = 0; i < bytes; i++) {
+            out.push_back(value >> 8*i);
+        }
+    }
+
+    // splitmix64's finaliser, every input bit affects every output bit
+    inline std::uint64_t mix(std::uint64_t value) {
+        value = (value ^ (value >> 30))*0xBF58476D1CE4E5B9;
+        value = (value ^ (value >> 27))*0x94D049BB133111EB;
+        return value ^ (value >> 31);
+    }
+
+    /**
+     * Fingerprints a list of tiles along with the state of the game
+     *
+     * Tiles are summed rather than chained, since a cascade finished in parallel lists them in no fixed order
+     */
+    std::uint32_t fingerprint(
+        const std::vector<std::pair<std::pair<int,int>,int>>& tiles,
+        States::Game state, int num_tiles_left, int num_flags
+    ) {
+        std::uint64_t Sum = 0;
+        for (const auto& Tile : tiles) {
+            const std::uint64_t Row = Tile.first.first, Column = Tile.first.second;
+            Sum += mix(Row << 40 | Column << 8 | (Tile.second & 0xFF));
+        }
+        const std::uint64_t Counts = (std::uint64_t)state << 62 | (std::uint64_t)num_tiles_left << 31 | num_flags;
+        return mix(Sum ^ mix(Counts)) >> 32;
+    }
+
+}
+
+namespace Replay {
+
+    std::uint32_t Fingerprint(const Responses::Tap& response) {
+        return fingerprint(response.Tiles,response.State,response.NumTilesLeft,response.NumFlags);
+    }
+
+    std::uint32_t Fingerprint(const Responses::Flag& response) {
+        return mix((std::uint64_t)response.State << 32 | (std::uint32_t)response.NumFlags) >> 32;
+    }
+
+    std::uint32_t Fingerprint(const Responses::Step& response) {
+        return fingerprint(response.Tiles,response.State,response.NumTilesLeft,response.NumFlags);
+    }
+
+    /**
+     * Plays an event on a game
+     *
+     * @param game: Game to play on
+     * @param event: Event to play
+     * @param tap: Output, filled in by a tap
+     * @param step: Output, filled in by an undo or redo
+     *
+     * @return Fingerprint of the response, 0 for a reset. An event the game can't take (a tap once the game is
+     * over, nothing to undo...) isn't played and gets the fingerprint of a flag with -1 flags, which can't be recorded
+     */
+    std::uint32_t Apply(Minesweeper::Game& game, const Event& event, Responses::Tap& tap, Responses::Step& step) {
+        Responses::Flag Failed;
+        Failed.State = States::Flag::Nothing;
+        Failed.NumFlags = -1;
+
+        switch (event.Key) {
+            case States::Input::Tap: {
+                if (game.Over()) {break;}
+                if (event.Starts) {game.Reset(event.Seed);}
+                game.Tap(event.Tile,tap);
+                return Fingerprint(tap);
+            }
+
+            case States::Input::Flag: {
+                if (game.Over() || !game.Started()) {break;}
+                return Fingerprint(game.Flag(event.Tile));
+            }
+
+            case States::Input::Reset: {
+                game.Reset();
+                return 0;
+            }
+
+            case States::Input::Undo: {
+                if (!game.Undo(step)) {break;}
+                return Fingerprint(step);
+            }
+
+            case States::Input::Redo: {
+                if (!game.Redo(step)) {break;}
+                return Fingerprint(step);
+            }
+
+            default: {
+                break;
+            }
+        }
+        return Fingerprint(Failed);
+    }
+
+    /**
+     * Starts a recording, replacing the file if it exists
+     *
+     * @param path: File to record to
+     * @param settings: Board settings
+     * @param seed: Seed the game starts from
+     */
+    Recorder::Recorder(const std::string& path, const Config::Settings& settings, std::uint64_t seed) :
+        Out(path,std::ios::binary | std::ios::trunc),
+        Last(std::chrono::steady_clock::now())
+    {
+        Buffer.assign(MAGIC,MAGIC + sizeof(MAGIC));
+        putVarint(Buffer,VERSION);
+        putVarint(Buffer,settings.Rows);
+        putVarint(Buffer,settings.Columns);
+        putVarint(Buffer,settings.Mines);
+        Buffer.push_back(settings.NoGuess);
+        putFixed(Buffer,seed,8);
+        Out.write(reinterpret_cast<const char*>(Buffer.data()),Buffer.size());
+        Out.flush();
+    }
+
+    /**
+     * Appends an event, timing it against the one before
+     *
+     * Every event is flushed straight away, so a session that ends badly still has everything up to that point. Only
+     * taps, flags, resets, undos and redos are recorded, anything else is skipped
+     *
+     * @param event: Event to record, its delay is filled in here
+     */
+    void Recorder::Record(Event event) {
+        const std::chrono::steady_clock::time_point Now = std::chrono::steady_clock::now();
+        const long long Elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(Now - Last).count();
+        event.Delay = std::min<long long>(Elapsed,UINT32_MAX);
+        Last = Now;
+
+        Wire Key;
+        if (!encode(event.Key,Key)) {return;}
+        Buffer.clear();
+        putVarint(Buffer,(std::uint64_t)event.Delay << DELAY_SHIFT | (event.Starts ? START_BIT : 0) | (int)Key);
+        if (event.Key == States::Input::Tap || event.Key == States::Input::Flag) {
+            putVarint(Buffer,event.Tile.first);
+            putVarint(Buffer,event.Tile.second);
+        }
+        if (event.Starts) {putVarint(Buffer,event.Seed);}
+        if (event.Key != States::Input::Reset) {putFixed(Buffer,event.Check,4);}
+
+        Out.write(reinterpret_cast<const char*>(Buffer.data()),Buffer.size());
+        Out.flush();
+    }
+
+    /**
+     * Maps a recording and reads its header
+     *
+     * @param path: File to read
+     */
+    Reader::Reader(const std::string& path) {
+        const int Descriptor = open(path.c_str(),O_RDONLY);
+        if (Descriptor < 0) {return;}
+
+        struct stat Info;
+        if (fstat(Descriptor,&Info) == 0 && Info.st_size >= (off_t)sizeof(MAGIC)) {
+            void* Mapped = mmap(nullptr,Info.st_size,PROT_READ,MAP_PRIVATE,Descriptor,0);
+            if (Mapped != MAP_FAILED) {
+                madvise(Mapped,Info.st_size,MADV_SEQUENTIAL);
+                Data = static_cast<const unsigned char*>(Mapped);
+                Bytes = Info.st_size;
+            }
+        }
+        close(Descriptor);
+        if (!Data || !std::equal(MAGIC,MAGIC + sizeof(MAGIC),Data)) {return;}
+        Position = sizeof(MAGIC);
+
+        std::uint64_t Version, Rows, Columns, Mines;
+        if (!varint(Version) || Version != VERSION) {return;}
+        if (!varint(Rows) || !varint(Columns) || !varint(Mines) || Bytes - Position < 9) {return;}
+        if (!Config::ValidBoard(Rows,Columns,Mines)) {return;}
+
+        Settings.Rows = Rows;
+        Settings.Columns = Columns;
+        Settings.Mines = Mines;
+        Settings.NoGuess = Data[Position++] != 0;
+        for (int i = 0; i < 8; i++) {
+            Seed |= (std::uint64_t)Data[Position++] << 8*i;
+        }
+        Good = true;
+    }
+
+    Reader::~Reader() {
+        if (Data) {munmap(const_cast<unsigned char*>(Data),Bytes);}
+    }
+
+    /**
+     * Reads the next event
+     *
+     * @param event: Output, the event
+     *
+     * @return False at the end of the recording, or at an event that is cut short or can't be right, reading stops
+     * there for good
+     */
+    bool Reader::Next(Event& event) {
+        if (!Good || Done()) {return false;}
+        const std::size_t Start = Position;
+
+        event = Event();
+        std::uint64_t Head;
+        Good = varint(Head) && decode(Head & (START_BIT - 1),event.Key);
+        if (Good) {
+            event.Starts = Head & START_BIT;
+            event.Delay = std::min<std::uint64_t>(Head >> DELAY_SHIFT,UINT32_MAX);
+        }
+
+        if (Good && (event.Key == States::Input::Tap || event.Key == States::Input::Flag)) {
+            std::uint64_t Row = 0, Column = 0;
+            Good = varint(Row) && varint(Column) && Row >= 1 && Column >= 1 &&
+                   Row <= (std::uint64_t)Settings.Rows && Column <= (std::uint64_t)Settings.Columns;
+            event.Tile = {(int)Row,(int)Column};
+        }
+        if (Good && event.Starts) {
+            Good = event.Key == States::Input::Tap && varint(event.Seed);
+        }
+        if (Good && event.Key != States::Input::Reset) {
+            Good = Bytes - Position >= 4;
+            for (int i = 0; Good && i < 4; i++) {
+                event.Check |= (std::uint32_t)Data[Position++] << 8*i;
+            }
+        }
+
+        if (!Good) {Position = Start;}
+        return Good;
+    }
+
+    /**
+     * Reads a LEB128 varint
+     *
+     * @param value: Output, the number
+     *
+     * @return False if the data ends first or the number doesn't fit in 64 bits
+     */
+    bool Reader::varint(std::uint64_t& value) {
+        value = 0;
+        for (int Shift = 0; Shift < 64 && Position < Bytes; Shift += 7) {
+            const unsigned char Byte = Data[Position++];
+            value |= (std::uint64_t)(Byte & 0x7F) << Shift;
+            if (!(Byte & 0x80)) {return true;}
+        }
+        return false;
+    }
+
+    /**
+     * Plays a recording back as fast as possible, checking that every event gives the response it was recorded
+     * with
+     *
+     * @param path: Recording to check
+     * @param threads: Threads used for large cascades and generating no-guess boards
+     */
+    Report Verify(const std::string& path, int threads) {
+        Reader In(path);
+        Report Result;
+        Result.Valid = In.Valid();
+        if (!Result.Valid) {return Result;}
+
+        Config::Settings Settings = In.getSettings();
+        Settings.Threads = threads;
+        Minesweeper::Game Game(Settings,In.getSeed());
+        Responses::Tap Tap;
+        Responses::Step Step;
+
+        Event Next;
+        while (In.Next(Next)) {
+            if (Apply(Game,Next,Tap,Step) != Next.Check) {
+                if (!Result.Mismatches++) {Result.FirstMismatch = Result.Events;}
+            }
+            Result.Events++;
+        }
+        Result.Complete = In.Done();
+        return Result;
+    }
+
+}
@@ -0,0 +1,276 @@
+#include "screen.hpp"
+
+namespace {
+
+    constexpr char RESET[] = "\033[0m";
+    constexpr char CLEAR[] = "\033[2J";
+
+    void appendNumber(std::string& out, int n) {
+        char Digits[12];
+        int Length = 0;
+        do {
+            Digits[Length++] = '0' + n%10;
+            n /= 10;
+        } while (n);
+        while (Length) {
+            out += Digits[--Length];
+        }
+    }
+
+    inline int numberLength(int n) {
+        int Length = 1;
+        while (n >= 10) {
+            n /= 10;
+            Length++;
+        }
+        return Length;
+    }
+
+    // Length in bytes of the UTF-8 character starting with this byte
+    inline int charLength(unsigned char lead) {
+        if (lead < 0xC0) {return 1;}
+        if (lead < 0xE0) {return 2;}
+        if (lead < 0xF0) {return 3;}
+        return 4;
+    }
+
+    inline std::uint32_t pack(const char* glyph, int length) {
+        std::uint32_t Packed = 0;
+        for (int i = 0; i < length && glyph[i]; i++) {
+            Packed |= (std::uint32_t)(unsigned char)glyph[i] << 8*i;
+        }
+        return Packed;
+    }
+
+}
+
+namespace Screen {
+
+    /**
+     * Creates a blank screen, the first frame clears the terminal and draws all of it
+     *
+     * @param rows: Rows of the screen
+     * @param columns: Columns of the screen
+     */
+    Buffer::Buffer(int rows, int columns) :
+        Rows(rows),
+        Columns(columns),
+        Front(rows*columns,{' ',DEFAULT}),
+        Back(rows*columns,{' ',DEFAULT}),
+        Dirty(rows,0)
+    {}
+
+    inline bool Buffer::visible(int row, int column) const {
+        return row >= 1 && row <= Rows && column >= 1 && column <= Columns;
+    }
+
+    /**
+     * Draws a single character, anything off the screen is dropped
+     *
+     * @param row: Row, from 1
+     * @param column: Column, from 1
+     * @param glyph: One UTF-8 character
+     * @param colour: 256 colour palette index, or DEFAULT
+     */
+    void Buffer::Put(int row, int column, const char* glyph, int colour) {
+        if (!visible(row,column)) {return;}
+        Back[(row - 1)*Columns + column - 1] = {pack(glyph,charLength(*glyph)),colour};
+        Dirty[row - 1] = 1;
+    }
+
+    /**
+     * Draws text from a position to the right, one character per cell, clipped to the screen
+     *
+     * @param row: Row, from 1
+     * @param column: Column of the first character, from 1
+     * @param text: UTF-8 text
+     * @param colour: 256 colour palette index, or DEFAULT
+     *
+     * @return Number of characters in the text
+     */
+    int Buffer::Print(int row, int column, const std::string& text, int colour) {
+        int Count = 0;
+        if (row >= 1 && row <= Rows) {Dirty[row - 1] = 1;}
+        for (std::size_t i = 0; i < text.size(); Count++) {
+            const int Length = charLength(text[i]);
+            if (visible(row,column + Count)) {
+                Back[(row - 1)*Columns + column + Count - 1] = {pack(&text[i],Length),colour};
+            }
+            i += Length;
+        }
+        return Count;
+    }
+
+    /**
+     * Moves the cells of a rectangle up, blanking the lines that come in at the bottom
+     *
+     * @param cells: Front or back buffer
+     * @param region: Top, bottom, left and right of the rectangle
+     * @param lines: Lines to move it by
+     */
+    void Buffer::shift(std::vector<Cell>& cells, const int region[4], int lines) {
+        const int Width = region[3] - region[2] + 1;
+        for (int Row = region[0]; Row <= region[1]; Row++) {
+            Cell* To = &cells[(Row - 1)*Columns + region[2] - 1];
+            if (Row + lines <= region[1]) {
+                std::copy(To + lines*Columns,To + lines*Columns + Width,To);
+            } else {
+                std::fill(To,To + Width,Cell{' ',DEFAULT});
+            }
+        }
+    }
+
+    /**
+     * Scrolls a rectangle up a line, leaving its last line blank
+     *
+     * Only one rectangle a frame is left to the terminal to scroll, any other is drawn
+     *
+     * @param top: First row, from 1
+     * @param bottom: Last row
+     * @param left: First column, from 1
+     * @param right: Last column
+     */
+    void Buffer::Scroll(int top, int bottom, int left, int right) {
+        const int Rectangle[4] = {std::max(top,1),std::min(bottom,Rows),std::max(left,1),std::min(right,Columns)};
+        if (Rectangle[0] > Rectangle[1] || Rectangle[2] > Rectangle[3]) {return;}
+        shift(Back,Rectangle,1);
+        std::fill(Dirty.begin() + Rectangle[0] - 1,Dirty.begin() + Rectangle[1],1);
+
+        if (!Margins || Full || (Scrolls && !std::equal(Rectangle,Rectangle + 4,Region))) {return;}
+        std::copy(Rectangle,Rectangle + 4,Region);
+        Scrolls++;
+    }
+
+    /**
+     * Forgets what the terminal shows, so the next frame clears it and draws everything
+     */
+    void Buffer::Invalidate() {
+        Full = true;
+    }
+
+    /**
+     * Sets where the cursor is left after every frame, e.g. where input is typed
+     *
+     * @param row: Row, from 1, 0 leaves the cursor wherever the frame ended
+     * @param column: Column, from 1
+     */
+    void Buffer::Park(int row, int column) {
+        ParkRow = row;
+        ParkColumn = column;
+    }
+
+    void Buffer::moveTo(int row, int column) {
+        Frame += "\033[";
+        appendNumber(Frame,row);
+        Frame += ';';
+        appendNumber(Frame,column);
+        Frame += 'H';
+    }
+
+    /**
+     * Adds a cell to the frame, setting its colour first if it isn't the current one
+     *
+     * @param cell: Cell to draw
+     * @param colour: Current colour of the terminal, updated
+     */
+    void Buffer::append(const Cell& cell, int& colour) {
+        if (cell.Colour != colour) {
+            if (cell.Colour == DEFAULT) {
+                Frame += RESET;
+            } else {
+                Frame += "\033[38;5;";
+                appendNumber(Frame,cell.Colour);
+                Frame += 'm';
+            }
+            colour = cell.Colour;
+        }
+        for (std::uint32_t Glyph = cell.Glyph; Glyph; Glyph >>= 8) {
+            Frame += (char)(Glyph & 0xFF);
+        }
+    }
+
+    /**
+     * Sends everything drawn since the last frame to the terminal in one write
+     *
+     * @param descriptor: File descriptor of the terminal
+     *
+     * @return Bytes written, 0 if nothing changed
+     */
+    std::size_t Buffer::Flush(int descriptor) {
+        const std::chrono::steady_clock::time_point Start = std::chrono::steady_clock::now();
+        Frame.clear();
+        long long Drawn = 0;
+        int Colour = DEFAULT;
+        if (Full) {
+            // After a clear the terminal is blank, so only what isn't needs drawing
+            Frame += CLEAR;
+            std::fill(Front.begin(),Front.end(),Cell{' ',DEFAULT});
+        } else if (Scrolls && Scrolls <= Region[1] - Region[0]) {
+            // Margins around the rectangle, scroll it, then margins back around the whole screen
+            Frame += "\033[?69h\033[";
+            appendNumber(Frame,Region[0]);
+            Frame += ';';
+            appendNumber(Frame,Region[1]);
+            Frame += "r\033[";
+            appendNumber(Frame,Region[2]);
+            Frame += ';';
+            appendNumber(Frame,Region[3]);
+            Frame += "s\033[";
+            appendNumber(Frame,Scrolls);
+            Frame += "S\033[r\033[s\033[?69l";
+            shift(Front,Region,Scrolls);
+        }
+        Scrolls = 0;
+
+        for (int Row = 0; Row < Rows; Row++) {
+            if (!Dirty[Row] && !Full) {continue;}
+            Dirty[Row] = 0;
+            const int First = Row*Columns;
+            int Cursor = -1;    // Column the terminal's cursor is at, if it is in this row
+            for (int Column = 0; Column < Columns; Column++) {
+                const int Index = First + Column;
+                if (Back[Index] == Front[Index]) {continue;}
+
+                // Redraw the unchanged cells since the last change if that's shorter than moving past them
+                int Bridge = Cursor < 0 ? -1 : 0;
+                for (int i = Cursor; Bridge >= 0 && i < Column; i++) {
+                    Bridge = Back[First + i].Colour == Colour ? Bridge + charLength(Back[First + i].Glyph & 0xFF) : -1;
+                }
+                if (Bridge >= 0 && Bridge < 4 + numberLength(Row + 1) + numberLength(Column + 1)) {
+                    for (int i = Cursor; i < Column; i++) {
+                        append(Back[First + i],Colour);
+                        Drawn++;
+                    }
+                } else {
+                    moveTo(Row + 1,Column + 1);
+                }
+
+                append(Back[Index],Colour);
+                Front[Index] = Back[Index];
+                Cursor = Column + 1;
+                Drawn++;
+            }
+        }
+
+        if (!Frame.empty() && Colour != DEFAULT) {Frame += RESET;}
+        if (!Frame.empty() && ParkRow) {moveTo(ParkRow,ParkColumn);}
+        Full = false;
+
+        for (std::size_t Written = 0; Written < Frame.size();) {
+            const ssize_t Result = write(descriptor,Frame.data() + Written,Frame.size() - Written);
+            if (Result <= 0) {break;}
+            Written += Result;
+        }
+
+        const double Seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - Start).count();
+        Usage.Frames++;
+        Usage.Bytes += Frame.size();
+        Usage.Cells += Drawn;
+        Usage.LastBytes = Frame.size();
+        Usage.LastCells = Drawn;
+        Usage.Seconds += Seconds;
+        Usage.LastSeconds = Seconds;
+        return Frame.size();
+    }
+
+}
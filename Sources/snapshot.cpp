@@ -0,0 +1,118 @@
+#include "snapshot.hpp"
+
+namespace {
+
+    constexpr char MAGIC[8] = {'M','I','N','E','S','N','A','P'};
+
+    /**
+     * Folds a run of bytes into a checksum, eight at a time
+     *
+     * @param hash: Checksum so far
+     * @param data: Bytes to add
+     * @param bytes: Number of bytes
+     */
+    std::uint64_t checksum(std::uint64_t hash, const void* data, std::size_t bytes) {
+        const unsigned char* Bytes = static_cast<const unsigned char*>(data);
+        const auto mix = [&hash](std::uint64_t word) {
+            hash ^= word*0x9E3779B97F4A7C15;
+            hash = ((hash << 31) | (hash >> 33))*0xBF58476D1CE4E5B9;
+        };
+
+        std::size_t i = 0;
+        for (; i + 8 <= bytes; i += 8) {
+            std::uint64_t Word;
+            std::memcpy(&Word,Bytes + i,8);
+            mix(Word);
+        }
+        std::uint64_t Tail = 0;
+        std::memcpy(&Tail,Bytes + i,bytes - i);
+        mix(Tail ^ (std::uint64_t)bytes << 56);
+        return hash;
+    }
+
+    /**
+     * Checksums a whole snapshot, the header's own checksum counts as 0
+     */
+    std::uint64_t checksum(Snapshot::Header header, const int* mines, const unsigned char* cells) {
+        header.Checksum = 0;
+        std::uint64_t Hash = checksum(0,&header,sizeof(header));
+        Hash = checksum(Hash,mines,sizeof(int)*header.Mines);
+        return checksum(Hash,cells,(std::size_t)header.Rows*header.Columns);
+    }
+
+}
+
+namespace Snapshot {
+
+    /**
+     * Writes a snapshot, the magic, version, size and checksum are filled in here
+     *
+     * The file is written next to the path and then renamed over it, so an existing snapshot is never left half
+     * written
+     *
+     * @param path: File to write
+     * @param header: Board, game and session stats
+     * @param mines: Grid positions of every mine
+     * @param cells: Every cell of the board
+     *
+     * @return False if the file couldn't be written
+     */
+    bool Save(const std::string& path, Header header, const int* mines, const unsigned char* cells) {
+        std::memcpy(header.Magic,MAGIC,sizeof(MAGIC));
+        header.Version = VERSION;
+        header.Size = sizeof(Header);
+        header.Checksum = checksum(header,mines,cells);
+
+        const std::string Temporary = path + ".tmp";
+        {
+            std::ofstream Out(Temporary,std::ios::binary | std::ios::trunc);
+            Out.write(reinterpret_cast<const char*>(&header),sizeof(header));
+            Out.write(reinterpret_cast<const char*>(mines),sizeof(int)*header.Mines);
+            Out.write(reinterpret_cast<const char*>(cells),(std::size_t)header.Rows*header.Columns);
+            Out.close();
+            if (!Out) {
+                std::remove(Temporary.c_str());
+                return false;
+            }
+        }
+        return std::rename(Temporary.c_str(),path.c_str()) == 0;
+    }
+
+    /**
+     * Maps a snapshot, leaving it invalid if it can't be read or fails any check
+     *
+     * @param path: File to map
+     */
+    File::File(const std::string& path) {
+        const int Descriptor = open(path.c_str(),O_RDONLY);
+        if (Descriptor < 0) {return;}
+
+        struct stat Info;
+        if (fstat(Descriptor,&Info) == 0 && Info.st_size >= (off_t)sizeof(Header)) {
+            void* Mapped = mmap(nullptr,Info.st_size,PROT_READ,MAP_PRIVATE,Descriptor,0);
+            if (Mapped != MAP_FAILED) {
+                Data = static_cast<const unsigned char*>(Mapped);
+                Bytes = Info.st_size;
+            }
+        }
+        close(Descriptor);
+        if (!Data) {return;}
+
+        const Header& Head = getHeader();
+        const bool Sized = std::memcmp(Head.Magic,MAGIC,sizeof(MAGIC)) == 0
+            && Head.Version == VERSION
+            && Head.Size == sizeof(Header)
+            && Head.Rows > 0 && Head.Columns > 0 && Head.Mines >= 0
+            && (long long)Head.Mines < (long long)Head.Rows*Head.Columns
+            && Bytes == sizeof(Header) + sizeof(int)*Head.Mines + (std::size_t)Head.Rows*Head.Columns;
+        if (!Sized || checksum(Head,getMines(),getCells()) != Head.Checksum) {
+            munmap(const_cast<unsigned char*>(Data),Bytes);
+            Data = nullptr;
+        }
+    }
+
+    File::~File() {
+        if (Data) {munmap(const_cast<unsigned char*>(Data),Bytes);}
+    }
+
+}
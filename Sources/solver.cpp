@@ -0,0 +1,373 @@
+#include "solver.hpp"
+
+namespace {
+
+    // Frontier components that take more steps than this to search are left unsolved
+    constexpr long SEARCH_STEPS = 1 << 20;
+
+    // Width of the frame that neighbouring constraints are compared in, 7x7 bits covers two tiles up to two apart
+    constexpr int FRAME = 7;
+
+    inline int popcount(unsigned long long mask) {
+        return __builtin_popcountll(mask);
+    }
+
+    /**
+     * Moves a 3x3 neighbour mask into the frame around another tile
+     *
+     * @param mask: Neighbour mask of a tile
+     * @param dr: Rows from the centre of the frame to that tile
+     * @param dc: Columns from the centre of the frame to that tile
+     */
+    inline unsigned long long frame(unsigned mask, int dr, int dc) {
+        unsigned long long Framed = 0;
+        for (int i = 0; i < 3; i++) {
+            Framed |= (unsigned long long)((mask >> 3*i) & 7) << ((i + 2 + dr)*FRAME + 2 + dc);
+        }
+        return Framed;
+    }
+
+}
+
+namespace Solver {
+
+    /**
+     * Finds every hidden tile that is provably safe or provably a mine
+     *
+     * @param board: Board to solve, only what a player can see of it is used
+     *
+     * @return Tiles that were proven, valid until the next call
+     */
+    const Result& Engine::Solve(const Tiles::Board& board) {
+        const Config::Settings& Settings = board.getSettings();
+        Rows = Settings.Rows;
+        Columns = Settings.Columns;
+        TotalMines = Settings.Mines;
+        Answer.Safe.clear();
+        Answer.Mines.clear();
+        Answer.Searched = false;
+        Answer.Complete = true;
+
+        board.getView(View);
+        Known.assign(View.size(),UNKNOWN);
+        ConstraintAt.assign(View.size(),-1);
+        CellAt.assign(View.size(),-1);
+        findConstraints();
+        Queued.assign(Constraints.size(),true);
+
+        // Searching is only worth it once the cheap rules stop finding anything
+        while (true) {
+            applyRules();
+            Progress = false;
+            applyTotal();
+            if (Progress) {continue;}
+            search();
+            if (!Progress) {break;}
+        }
+        return Answer;
+    }
+
+    /**
+     * Records a proven tile
+     *
+     * @param index: Grid position of a hidden tile
+     * @param value: SAFE or MINE
+     */
+    void Engine::deduce(int index, unsigned char value) {
+        if (Known[index] != UNKNOWN) {return;}
+        Known[index] = value;
+        std::pair<int,int> Tile = {1 + index/Columns,1 + index%Columns};
+        if (value == MINE) {
+            Answer.Mines.push_back(Tile);
+        } else {
+            Answer.Safe.push_back(Tile);
+        }
+        Progress = true;
+
+        // Take the tile out of the numbers around it, and have them looked at again
+        const int Row = index/Columns;
+        const int Column = index%Columns;
+        for (int r = std::max(0,Row - 1); r <= std::min(Rows - 1,Row + 1); r++) {
+            for (int c = std::max(0,Column - 1); c <= std::min(Columns - 1,Column + 1); c++) {
+                const int k = ConstraintAt[r*Columns + c];
+                if (k < 0) {continue;}
+
+                Constraints[k].Mask &= ~(1u << ((Row - r + 1)*3 + Column - c + 1));
+                if (value == MINE) {Constraints[k].Count--;}
+                if (!Queued[k]) {
+                    Queued[k] = true;
+                    Queue.push_back(k);
+                }
+            }
+        }
+    }
+
+    /**
+     * Records every tile of a frame
+     *
+     * @param index: Grid position of the tile at the centre of the frame
+     * @param framed: Frame mask of hidden tiles
+     * @param value: SAFE or MINE
+     */
+    void Engine::deduceFrame(int index, unsigned long long framed, unsigned char value) {
+        while (framed) {
+            const int Bit = __builtin_ctzll(framed);
+            framed &= framed - 1;
+            deduce(index + (Bit/FRAME - 3)*Columns + (Bit%FRAME - 3),value);
+        }
+    }
+
+    /**
+     * Collects every revealed number that still has hidden neighbours
+     */
+    void Engine::findConstraints() {
+        Constraints.clear();
+        Queue.clear();
+        for (int Row = 0; Row < Rows; Row++) {
+            for (int Column = 0; Column < Columns; Column++) {
+                const int Index = Row*Columns + Column;
+                if (View[Index] < 0) {continue;}
+
+                unsigned Hidden = 0;
+                for (int dr = -1; dr <= 1; dr++) {
+                    if (Row + dr < 0 || Row + dr >= Rows) {continue;}
+                    for (int dc = -1; dc <= 1; dc++) {
+                        if (Column + dc < 0 || Column + dc >= Columns) {continue;}
+                        if (View[Index + dr*Columns + dc] < 0) {Hidden |= 1u << ((dr + 1)*3 + dc + 1);}
+                    }
+                }
+                if (!Hidden) {continue;}
+
+                ConstraintAt[Index] = Constraints.size();
+                Queue.push_back(Constraints.size());
+                Constraints.push_back({Index,Hidden,View[Index]});
+            }
+        }
+    }
+
+    /**
+     * Applies the single tile and pairwise rules until neither finds anything new
+     *
+     * A number whose count is zero, or equal to its hidden tiles, settles all of them. For two overlapping numbers
+     * A and B, if B needs exactly as many more mines than A as it has tiles that A does not, those tiles are all mines
+     * and A's tiles outside of B are all safe. This covers the usual subset rule as well. Only numbers next to newly
+     * proven tiles are looked at again.
+     */
+    void Engine::applyRules() {
+        while (!Queue.empty()) {
+            Constraint& A = Constraints[Queue.back()];
+            Queued[Queue.back()] = false;
+            Queue.pop_back();
+            if (!A.Mask) {continue;}
+
+            const int Hidden = popcount(A.Mask);
+            if (A.Count == 0 || A.Count == Hidden) {
+                deduceFrame(A.Index,frame(A.Mask,0,0),A.Count ? MINE : SAFE);
+                continue;
+            }
+
+            const int Row = A.Index/Columns;
+            const int Column = A.Index%Columns;
+            const unsigned long long FramedA = frame(A.Mask,0,0);
+            for (int dr = -2; dr <= 2; dr++) {
+                if (Row + dr < 0 || Row + dr >= Rows) {continue;}
+                for (int dc = -2; dc <= 2; dc++) {
+                    if ((!dr && !dc) || Column + dc < 0 || Column + dc >= Columns) {continue;}
+                    const int Other = ConstraintAt[A.Index + dr*Columns + dc];
+                    if (Other < 0 || !Constraints[Other].Mask) {continue;}
+
+                    const Constraint& B = Constraints[Other];
+                    const unsigned long long FramedB = frame(B.Mask,dr,dc);
+                    if (!(FramedA & FramedB)) {continue;}
+
+                    const unsigned long long OnlyA = FramedA & ~FramedB;
+                    const unsigned long long OnlyB = FramedB & ~FramedA;
+                    if (B.Count - A.Count == popcount(OnlyB)) {
+                        deduceFrame(A.Index,OnlyB,MINE);
+                        deduceFrame(A.Index,OnlyA,SAFE);
+                    } else if (A.Count - B.Count == popcount(OnlyA)) {
+                        deduceFrame(A.Index,OnlyA,MINE);
+                        deduceFrame(A.Index,OnlyB,SAFE);
+                    }
+                }
+            }
+        }
+    }
+
+    /**
+     * Settles every unknown tile once the number of mines left rules it out or forces it
+     */
+    void Engine::applyTotal() {
+        int Unknown = 0;
+        for (size_t i = 0; i < View.size(); i++) {
+            if (View[i] < 0 && Known[i] == UNKNOWN) {Unknown++;}
+        }
+        RemainingMines = TotalMines - Answer.Mines.size();
+        if (!Unknown) {return;}
+
+        if (RemainingMines == 0 || RemainingMines == Unknown) {
+            const unsigned char Value = RemainingMines ? MINE : SAFE;
+            for (size_t i = 0; i < View.size(); i++) {
+                if (View[i] < 0) {deduce(i,Value);}
+            }
+        }
+    }
+
+    // Finds the component of a frontier tile
+    int Engine::root(int cell) {
+        while (Parent[cell] != cell) {
+            Parent[cell] = Parent[Parent[cell]];
+            cell = Parent[cell];
+        }
+        return cell;
+    }
+
+    /**
+     * Splits the frontier into independent components and tries every arrangement of mines in each of them
+     */
+    void Engine::search() {
+        Cells.clear();
+        Parent.clear();
+        for (const Constraint& A : Constraints) {
+            int First = -1;
+            for (unsigned Mask = A.Mask; Mask; Mask &= Mask - 1) {
+                const int Bit = __builtin_ctz(Mask);
+                const int Index = A.Index + (Bit/3 - 1)*Columns + (Bit%3 - 1);
+                if (CellAt[Index] < 0) {
+                    CellAt[Index] = Cells.size();
+                    Parent.push_back(Cells.size());
+                    Cells.push_back(Index);
+                }
+                if (First < 0) {
+                    First = root(CellAt[Index]);
+                } else {
+                    Parent[root(CellAt[Index])] = First;
+                }
+            }
+        }
+        if (Cells.empty()) {return;}
+        Answer.Searched = true;
+
+        // Lay every component out in one run, in row major order
+        Grouped.clear();
+        for (size_t i = 0; i < Cells.size(); i++) {
+            Grouped.push_back({root(i),Cells[i]});
+        }
+        std::sort(Grouped.begin(),Grouped.end());
+        for (size_t i = 0; i < Cells.size(); i++) {
+            Cells[i] = Grouped[i].second;
+            CellAt[Cells[i]] = i;
+        }
+
+        // Constraints touching every frontier tile
+        LinkStart.assign(Cells.size() + 1,0);
+        Needed.resize(Constraints.size());
+        Placed.assign(Constraints.size(),0);
+        Open.resize(Constraints.size());
+        for (size_t k = 0; k < Constraints.size(); k++) {
+            const Constraint& A = Constraints[k];
+            Needed[k] = A.Count;
+            Open[k] = popcount(A.Mask);
+            for (unsigned Mask = A.Mask; Mask; Mask &= Mask - 1) {
+                const int Bit = __builtin_ctz(Mask);
+                LinkStart[CellAt[A.Index + (Bit/3 - 1)*Columns + (Bit%3 - 1)] + 1]++;
+            }
+        }
+        for (size_t i = 0; i < Cells.size(); i++) {
+            LinkStart[i + 1] += LinkStart[i];
+        }
+        Links.resize(LinkStart.back());
+        std::vector<int> Next(LinkStart.begin(),LinkStart.end() - 1);
+        for (size_t k = 0; k < Constraints.size(); k++) {
+            const Constraint& A = Constraints[k];
+            for (unsigned Mask = A.Mask; Mask; Mask &= Mask - 1) {
+                const int Bit = __builtin_ctz(Mask);
+                Links[Next[CellAt[A.Index + (Bit/3 - 1)*Columns + (Bit%3 - 1)]]++] = k;
+            }
+        }
+
+        for (size_t First = 0; First < Cells.size();) {
+            size_t Last = First;
+            while (Last < Cells.size() && Grouped[Last].first == Grouped[First].first) {Last++;}
+            searchComponent(First,Last);
+            First = Last;
+        }
+
+        for (int Index : Cells) {
+            CellAt[Index] = -1;
+        }
+    }
+
+    /**
+     * Depth first search over every arrangement of mines in one frontier component
+     *
+     * A tile that is a mine in none of the arrangements is safe, one that is a mine in all of them is a mine.
+     *
+     * @param first: Position of the component's first tile in Cells
+     * @param last: One past the position of its last tile
+     */
+    void Engine::searchComponent(int first, int last) {
+        const int Size = last - first;
+        Value.assign(Size,-1);
+        Seen.assign(Size,0);    // 1 if the tile was safe in some arrangement, 2 if it was a mine, 3 if both
+        int Undecided = Size;
+        int Mines = 0;
+        long Steps = 0;
+
+        // Tiles before i have a value, i's value is the last one tried
+        auto place = [&](int cell, int value) {
+            bool Fits = Mines + value <= RemainingMines;
+            Mines += value;
+            for (int l = LinkStart[cell]; l < LinkStart[cell + 1]; l++) {
+                const int k = Links[l];
+                Open[k]--;
+                Placed[k] += value;
+                if (Placed[k] > Needed[k] || Placed[k] + Open[k] < Needed[k]) {Fits = false;}
+            }
+            return Fits;
+        };
+        auto unplace = [&](int cell, int value) {
+            Mines -= value;
+            for (int l = LinkStart[cell]; l < LinkStart[cell + 1]; l++) {
+                Open[Links[l]]++;
+                Placed[Links[l]] -= value;
+            }
+        };
+
+        int i = 0;
+        while (i >= 0) {
+            if (i == Size) {
+                for (int j = 0; j < Size; j++) {
+                    const unsigned char Bit = Value[j] ? 2 : 1;
+                    if (Seen[j] & Bit) {continue;}
+                    Seen[j] |= Bit;
+                    if (Seen[j] == 3) {Undecided--;}
+                }
+                if (!Undecided) {return;}
+                i--;
+                unplace(first + i,Value[i]);
+            }
+
+            if (Value[i] == 1) {
+                Value[i] = -1;
+                if (--i >= 0) {unplace(first + i,Value[i]);}
+                continue;
+            }
+            if (++Steps > SEARCH_STEPS) {
+                Answer.Complete = false;
+                return;
+            }
+            Value[i]++;
+            if (place(first + i,Value[i])) {
+                i++;
+            } else {
+                unplace(first + i,Value[i]);
+            }
+        }
+
+        for (int j = 0; j < Size; j++) {
+            if (Seen[j] == 1) {deduce(Cells[first + j],SAFE);}
+            if (Seen[j] == 2) {deduce(Cells[first + j],MINE);}
+        }
+    }
+}
@@ -2,278 +2,671 @@
 
 namespace {
 
-    // Constants
-    const int CHAR_OFFSET = 64;
-    const int ROWS = 26;
-    const int COLUMNS = 26;
-    const int TOTAL_TILES = 676;
-    const int NUM_MINES = 100;
-
-    // Macros
-    inline bool IN_BOUNDS(int Row, int Column, int i) {
-        return (Row > 0 && Row <= ROWS) && (Column > 0 && Column <= COLUMNS) && (i != 5);
-    }
-
-    struct {
-        std::map<std::pair<char,char>,int> Tiles;
-        std::set<std::pair<char,char>> Mines;
-        std::set<std::pair<char,char>> Revealed;
-        std::set<std::pair<char,char>> Flagged;
-
-        /**
-        * Cleans board data
-        */
-        void clean() {
-            Tiles.clear();
-            Mines.clear();
-            Revealed.clear();
-            Flagged.clear();
+    // Cascades that reveal more tiles than this are finished in parallel, when more than one thread is configured
+    constexpr int PARALLEL_BUDGET = 1 << 16;
+    constexpr int MIN_CHUNK_ROWS = 16;
+    constexpr int CHUNKS_PER_THREAD = 8;
+
+    // Room for alignment and the odd cascade that needs a deep stack, on top of what every board is known to need
+    constexpr int ARENA_SLACK = 1024;
+
+    // Cell layout, every tile is a single byte
+    constexpr unsigned char COUNT_MASK = 0x0F;      // Number of adjacent mines (0-8)
+    constexpr unsigned char MINE_BIT = 0x10;
+    constexpr unsigned char REVEALED_BIT = 0x20;
+    constexpr unsigned char FLAGGED_BIT = 0x40;
+    constexpr int MINE = 9;
+
+    /**
+     * Checks a board read from somewhere else, e.g. a snapshot, before any of it is used
+     *
+     * Mines have to be on the board, sorted and listed once, and match the mine bits. Every number has to be the
+     * count of the mines around it, no mine can be revealed or tile be both revealed and flagged, and the totals
+     * have to match the cells
+     *
+     * @param cells: Every cell, row major order
+     * @param mines: Grid positions of every mine
+     * @param settings: Board settings
+     * @param revealed: Number of revealed tiles
+     * @param flagged: Number of flagged tiles
+     *
+     * @return If the board is one the game could have left
+     */
+    bool consistent(const unsigned char* cells, const int* mines, const Config::Settings& settings, int revealed,
+                    int flagged) {
+        const int Rows = settings.Rows;
+        const int Columns = settings.Columns;
+        const long long TotalTiles = (long long)Rows*Columns;
+        for (int i = 0; i < settings.Mines; i++) {
+            if (mines[i] < 0 || mines[i] >= TotalTiles || (i && mines[i] <= mines[i - 1])) {return false;}
+            if (!(cells[mines[i]] & MINE_BIT)) {return false;}
         }
 
-        /**
-         * Randomly assigns tiles to be mines
-         *
-         * @param all_tiles: All the tiles on the board
-         * @param safe_tiles: Tiles that cannot be a mines
-         *
-         */
-        void generateMines(
-            std::vector<std::pair<char,char>>& all_tiles,
-            const std::set<std::pair<char,char>>& safe_tiles
-        ) {
-            int Converted = 0;
-
-            std::random_device rd;
-            std::mt19937 g(rd());
-            std::shuffle(all_tiles.begin(),all_tiles.end(),g);
-
-            for (const auto Tile : all_tiles) {
-                if (safe_tiles.find(Tile) == safe_tiles.end()) {
-                    Mines.insert(Tile);
-                    Converted++;
+        // Mines around each column of the row, then across three columns of those
+        std::vector<int> Around(Columns + 2);
+        long long Mines = 0, Revealed = 0, Flagged = 0;
+        for (int Row = 0; Row < Rows; Row++) {
+            const unsigned char* Line = cells + (long long)Row*Columns;
+            for (int Column = 0; Column < Columns; Column++) {
+                int Sum = 0;
+                for (int Near = std::max(Row - 1,0); Near <= std::min(Row + 1,Rows - 1); Near++) {
+                    Sum += (cells[(long long)Near*Columns + Column] & MINE_BIT) != 0;
                 }
-                if (Converted == NUM_MINES) {break;}
+                Around[Column + 1] = Sum;
             }
-        }
 
-        /**
-         * Assigns every tile a number based on how many mines are adjacent to it
-         *
-         * 0 indicates no adjacent mines
-         *
-         * 9 indicates tile itself is a mine
-         *
-         * @param all_tiles: All the tiles on the board
-         */
-        void setTiles(const std::vector<std::pair<char,char>>& all_tiles) {
-            for (const auto& Tile : all_tiles) {
-
-                // If tile itself is a mine
-                if (Mines.find(Tile) != Mines.end()) {
-                    Tiles[Tile] = 9;
-                    continue;
+            for (int Column = 0; Column < Columns; Column++) {
+                const unsigned char Cell = Line[Column];
+                const bool Mine = Cell & MINE_BIT;
+                const int Count = Around[Column] + Around[Column + 1] + Around[Column + 2] - Mine;
+                if ((Cell & ~(COUNT_MASK | MINE_BIT | REVEALED_BIT | FLAGGED_BIT)) || (Cell & COUNT_MASK) != Count) {
+                    return false;
                 }
+                if ((Cell & REVEALED_BIT) && (Mine || (Cell & FLAGGED_BIT))) {return false;}
+                Mines += Mine;
+                Revealed += (Cell & REVEALED_BIT) != 0;
+                Flagged += (Cell & FLAGGED_BIT) != 0;
+            }
+        }
+        return Mines == settings.Mines && Revealed == revealed && Flagged == flagged;
+    }
 
-                int MinesFound = 0;
-                int Row = (Tile.first - CHAR_OFFSET) - 1;       // -1 so that it starts at the top left
-                int Column = (Tile.second - CHAR_OFFSET) - 1;   // adjacent tile
-                for (int i = 1; i <= 9; i++) {
-                    if (IN_BOUNDS(Row,Column,i)) {
+}
 
-                        const std::pair<char,char> AdjacentTile = {CHAR_OFFSET + Row,CHAR_OFFSET + Column};
-                        if (Mines.find(AdjacentTile) != Mines.end()) {
-                            MinesFound++;
-                        }
-                    }
-                    if (i%3==0) {
-                        Column -= 2;
-                        Row++;
-                    } else {
-                        Column++;
-                    }
-                }
+namespace Tiles {
 
-                Tiles[Tile] = MinesFound;
-            }
-        }
+    /**
+     * Creates an empty board, nothing can be tapped until generateBoard is called
+     *
+     * @param settings: Board settings, assumed to already be validated by Config::Parse
+     */
+    Board::Board(const Config::Settings& settings) :
+        Settings(settings),
+        TotalTiles(settings.Rows*settings.Columns),
+        Arena(2*(std::size_t)TotalTiles + sizeof(int)*(settings.Mines + 2*settings.Columns) + settings.Columns + ARENA_SLACK),
+        Cells(Memory::Allocator<unsigned char>(Arena)),
+        Plane(Memory::Allocator<unsigned char>(Arena)),
+        Mines(Memory::Allocator<int>(Arena)),
+        Seeds(Memory::Allocator<int>(Arena)),
+        Sums(Memory::Allocator<unsigned char>(Arena))
+    {
+        clean();
+    }
 
-        /**
-         * Searches the entire board, starting at the input tile, for all tiles. If a tile found in the search is
-         * blank (0 adjacent mines), the tile will be added to the return vector as well as a search stack where
-         * further searches will occur. If the tile found is adjacent to at least 1 mine, it will be added to the
-         * return vector but not the search stack.
-         *
-         * Since searches only apply to blank tiles, no mines will be encountered
-         *
-         * @param starting_tile: Input blank tile where the search starts
-         *
-         * @return Vector containing individual tile data which includes the tile itself and the number of 
-         * adjacent mines
-         *
-         */
-        std::vector<std::pair<std::pair<char,char>,int>> findAllAdjacent(
-            const std::pair<char,char>& starting_tile
-        ) {
-            std::vector<std::pair<std::pair<char,char>,int>> ret;
-
-            // Fixes situations where the input tile isn't adjacent to any
-            // other blank tile
-            ret.push_back({starting_tile,Tiles[starting_tile]});
-
-            std::stack<std::pair<char,char>,std::vector<std::pair<char,char>>> Stack;
-            Stack.push(starting_tile);
-
-            do {
-                auto CurrentTile = Stack.top();
-                Stack.pop();
-
-                int Row = (CurrentTile.first - CHAR_OFFSET) - 1;
-                int Column = (CurrentTile.second - CHAR_OFFSET) - 1;
-
-                for (int i=1; i<=9; i++) {
-                    if (IN_BOUNDS(Row,Column,i)) {
-                        std::pair<char,char> AdjacentTile = {CHAR_OFFSET + Row,CHAR_OFFSET + Column};
-
-                        if (Revealed.find(AdjacentTile) == Revealed.end()) {
-                            Revealed.insert(AdjacentTile);
-
-                            const int AdjacentMines = Tiles[AdjacentTile];
-                            ret.push_back({AdjacentTile,AdjacentMines});
-                            if (AdjacentMines == 0) {
-                                Stack.push(AdjacentTile);
-                            }
-
-                            // For situations where there is a false flag
-                            Flagged.erase(AdjacentTile);
-                        }
-                    }
-                    if (i%3==0) {
-                        Row++;
-                        Column -= 2;
-                    } else {
-                        Column++;
-                    }
-                }
+    /**
+     * Copies a board into a fresh arena of its own
+     *
+     * @param other: Board to copy
+     */
+    Board::Board(const Board& other) :
+        Board(other.Settings)
+    {
+        *this = other;
+    }
 
-            } while (!Stack.empty());
+    /**
+     * Copies a board, reusing this board's arena
+     *
+     * @param other: Board to copy
+     */
+    Board& Board::operator=(const Board& other) {
+        if (this == &other) {return *this;}
+
+        Settings = other.Settings;
+        TotalTiles = other.TotalTiles;
+        clean();
+        Cells = other.Cells;
+        Plane = other.Plane;
+        Mines = other.Mines;
+        Moves = other.Moves;
+        Deltas = other.Deltas;
+        Played = other.Played;
+        NumRevealed = other.NumRevealed;
+        NumFlagged = other.NumFlagged;
+        return *this;
+    }
 
-            return ret;
-        }
+    // Converts a tile into its position in the grid
+    inline int Board::index(const std::pair<int,int>& tile) const {
+        return (tile.first - 1)*Settings.Columns + (tile.second - 1);
+    }
 
-        // idk why i have some getter functions even though i could just directly get these values
-        // would make more sense to make this a class rather than a struct
-        // too lazy to change now
-
-        /**
-         * Returns the number of adjacent mines to a given tile
-         *
-         * @param tile: Input tile
-         *
-         */
-        inline int getNumAdjacentMines(const std::pair<char,char>& tile) {
-            return Tiles[tile];
+    // Converts a position in the grid back into a tile
+    inline std::pair<int,int> Board::tile(int index) const {
+        return {1 + index/Settings.Columns,1 + index%Settings.Columns};
+    }
+
+    /**
+     * Cleans board data
+     *
+     * Empties the arena and carves every buffer out of it again, so after the first few boards this is only the
+     * cost of zeroing the grid and the mine plane
+     */
+    void Board::clean() {
+        Arena.Reset();
+        const Memory::Allocator<int> Allocator(Arena);
+        Cells = Memory::Buffer<unsigned char>(TotalTiles,0,Allocator);
+        Plane = Memory::Buffer<unsigned char>(TotalTiles,0,Allocator);
+        Sums = Memory::Buffer<unsigned char>(Settings.Columns + 2,0,Allocator);
+        Mines = Memory::Buffer<int>(Allocator);
+        Mines.reserve(Settings.Mines);
+        Seeds = Memory::Buffer<int>(Allocator);
+        Seeds.reserve(2*Settings.Columns);
+        Moves.clear();
+        Deltas.clear();
+        Played = 0;
+        NumRevealed = 0;
+        NumFlagged = 0;
+    }
+
+    /**
+     * Randomly assigns tiles to be mines
+     *
+     * Uses Floyd's sampling, which picks Settings.Mines distinct tiles with exactly that many draws no matter how big
+     * the board is. Tiles in the safe area are left out by numbering only the other tiles, and skipping over the
+     * safe ones when converting a number back into a grid position.
+     *
+     * @param safe_tile: Starting tile, all tiles adjacent and including cannot be a mine
+     * @param rng: Random number generator to draw with
+     */
+    void Board::generateMines(const std::pair<int,int>& safe_tile, Prng::Generator& rng) {
+        // Grid positions of the safe area in increasing order, smaller near edges
+        int Safe[9];
+        int NumSafe = 0;
+        const int LastRow = std::min(Settings.Rows,safe_tile.first + 1);
+        const int LastColumn = std::min(Settings.Columns,safe_tile.second + 1);
+        for (int Row = std::max(1,safe_tile.first - 1); Row <= LastRow; Row++) {
+            for (int Column = std::max(1,safe_tile.second - 1); Column <= LastColumn; Column++) {
+                Safe[NumSafe++] = index({Row,Column});
+            }
         }
+        const auto Position = [&](int n) {
+            for (int i = 0; i < NumSafe && Safe[i] <= n; i++) {n++;}
+            return n;
+        };
+
+        // Each step adds either a new random tile from the first Candidate + 1 tiles, or Candidate itself if that
+        // one was already picked, which keeps every set of mines equally likely
+        const int Candidates = TotalTiles - NumSafe;
+        for (int Candidate = Candidates - Settings.Mines; Candidate < Candidates; Candidate++) {
+            int Index = Position(rng.Below(Candidate + 1));
+            if (Plane[Index]) {Index = Position(Candidate);}
+            Plane[Index] = 1;
+            Mines.push_back(Index);
+        }
+        std::sort(Mines.begin(),Mines.end());
+    }
 
-        /**
-         * Returns if given tile is currently flagged
-         *
-         * @param tile: Input tile
-         *
-         */
-        inline bool tileFlagged(const std::pair<char,char>& tile) {
-            return Flagged.find(tile) != Flagged.end();
+    /**
+     * Assigns every tile a number based on how many mines are adjacent to it
+     *
+     * Counted over the whole mine plane at once, see counts.cpp
+     */
+    void Board::setTiles() {
+        Counts::Compute(Plane.data(),Cells.data(),Settings.Rows,Settings.Columns,Counts::Best(),Sums.data());
+        for (const int Mine : Mines) {
+            Cells[Mine] |= MINE_BIT;
         }
+    }
+
+    /**
+     * Marks a tile as revealed, clearing any (false) flag on it
+     *
+     * @param index: Grid position of the tile
+     */
+    inline void Board::reveal(int index) {
+        unsigned char& Cell = Cells[index];
+        if (Cell & FLAGGED_BIT) {NumFlagged--;}
+        Cell = (Cell & ~FLAGGED_BIT) | REVEALED_BIT;
+        NumRevealed++;
+    }
+
+    /**
+     * Returns if a tile is an unrevealed blank tile (0 adjacent mines), the only kind of tile a cascade
+     * spreads through
+     *
+     * @param index: Grid position of the tile
+     */
+    inline bool Board::blank(int index) const {
+        return !(Cells[index] & (REVEALED_BIT | MINE_BIT | COUNT_MASK));
+    }
 
-        /**
-         * Returns if given tile is currently revealed
-         *
-         * @param tile: Input tile
-         *
-         */
-        inline bool tileRevealed(const std::pair<char,char>& tile) {
-            return Revealed.find(tile) != Revealed.end();
+    /**
+     * Reveals a tile as part of a cascade, clearing any (false) flag on it
+     *
+     * Counters are kept in the fill rather than on the board so cascades can run on several threads
+     *
+     * @param index: Grid position of the tile
+     * @param fill: Where the tile is listed
+     */
+    inline void Board::revealInto(int index, Fill& fill) {
+        unsigned char& Cell = Cells[index];
+        logRun(index,fill);
+        if (Cell & FLAGGED_BIT) {
+            fill.Unflagged++;
+            fill.Deltas->push_back(index);
+            fill.Deltas->push_back(0);
         }
+        Cell = (Cell & ~FLAGGED_BIT) | REVEALED_BIT;
+        fill.Revealed++;
+        if (index != fill.Skip) {fill.Tiles.push_back({tile(index),Cell & COUNT_MASK});}
+    }
 
-        /**
-         * Returns the number of unrevealed tiles
-         */
-        inline int getRemaining() {
-            return TOTAL_TILES - Revealed.size();
+    /**
+     * Logs a revealed tile, growing the last run of the current move if the tile comes straight after it. Spans of a
+     * cascade are revealed left to right, so each one takes a single run
+     *
+     * @param index: Grid position of the tile
+     * @param fill: Fill whose log the tile goes in
+     */
+    inline void Board::logRun(int index, Fill& fill) {
+        Memory::Buffer<int>& Log = *fill.Deltas;
+        const size_t Size = Log.size();
+        if (Size >= fill.From + 2 && Log[Size - 1] && Log[Size - 2] + Log[Size - 1] == index) {
+            Log[Size - 1]++;
+        } else {
+            Log.push_back(index);
+            Log.push_back(1);
         }
+    }
 
-    } Board;
+    /**
+     * Scans a run of tiles within one row that borders revealed blank tiles. Numbered tiles are revealed
+     * straight away and every run of blank tiles becomes a single seed
+     *
+     * @param from: Grid position of the first tile
+     * @param to: Grid position of the last tile
+     * @param seeds: Where new seeds are added
+     * @param fill: Where revealed tiles are listed
+     */
+    template <typename Stack>
+    inline void Board::scanRun(int from, int to, Stack& seeds, Fill& fill) {
+        bool InRun = false;
+        for (int Index = from; Index <= to; Index++) {
+            if (Cells[Index] & REVEALED_BIT) {
+                InRun = false;
+            } else if (blank(Index)) {
+                if (!InRun) {seeds.push_back(Index);}
+                InRun = true;
+            } else {
+                revealInto(Index,fill);
+                InRun = false;
+            }
+        }
+    }
 
     /**
-     * Creates vector containing every tile
+     * Reveals every blank tile connected to the seeds, along with the numbered tiles bordering them
      *
-     * could be done hard coded tbh since output is always the same
+     * Works a row at a time: each seed is grown left and right into a span of blank tiles which are all
+     * revealed together, then the rows above and below the span (plus one tile either side, since diagonals
+     * count) are scanned once.
      *
-     * @return All the tiles on the board
+     * Only rows [first_row, last_row] are touched, runs in the rows just outside are handed to `outside`
+     * instead. This is what lets separate bands of rows be flooded on separate threads.
+     *
+     * Since cascades only spread through blank tiles, no mines will be encountered
+     *
+     * @param first_row: First row that may be touched
+     * @param last_row: Last row that may be touched
+     * @param seeds: Blank tiles to grow from, whatever is left over when the budget runs out stays here
+     * @param fill: Where revealed tiles are listed
+     * @param outside: Called with (row, first grid position, last grid position) for runs outside the rows
+     * @param budget: Stops once this many tiles have been revealed into the fill
      */
-    std::vector<std::pair<char,char>> getAllTiles() {
-        std::vector<std::pair<char,char>> AllTiles;
-        AllTiles.reserve(TOTAL_TILES);
+    template <typename Stack, typename Outside>
+    void Board::flood(
+        int first_row, int last_row,
+        Stack& seeds, Fill& fill,
+        Outside outside, int budget
+    ) {
+        const int Columns = Settings.Columns;
+        while (!seeds.empty() && fill.Revealed < budget) {
+            const int Seed = seeds.back();
+            seeds.pop_back();
+
+            // Already filled by another span
+            if (!blank(Seed)) {continue;}
+
+            const int Row = Seed/Columns;
+            const int RowStart = Row*Columns;
+            int Left = Seed%Columns;
+            int Right = Left;
+            while (Left > 0 && blank(RowStart + Left - 1)) {Left--;}
+            while (Right < Columns - 1 && blank(RowStart + Right + 1)) {Right++;}
+
+            for (int Column = Left; Column <= Right; Column++) {
+                revealInto(RowStart + Column,fill);
+            }
 
-        int Row = 1;
-        int Column = 1;
-        for (int i = 1; i <= TOTAL_TILES; i++) {
-            const std::pair<char,char> Tile = {CHAR_OFFSET + Row,CHAR_OFFSET + Column};
-            AllTiles.push_back(Tile);
+            // Numbered tiles at either end of the span
+            const int From = std::max(Left - 1,0);
+            const int To = std::min(Right + 1,Columns - 1);
+            if (!(Cells[RowStart + From] & REVEALED_BIT)) {revealInto(RowStart + From,fill);}
+            if (!(Cells[RowStart + To] & REVEALED_BIT)) {revealInto(RowStart + To,fill);}
 
-            if (i%COLUMNS==0) {
-                Row++;
-                Column = 1;
-            } else {
-                Column++;
+            for (int Adjacent = Row - 1; Adjacent <= Row + 1; Adjacent += 2) {
+                if (Adjacent < 0 || Adjacent >= Settings.Rows) {continue;}
+
+                if (Adjacent < first_row || Adjacent > last_row) {
+                    outside(Adjacent,Adjacent*Columns + From,Adjacent*Columns + To);
+                } else {
+                    scanRun(Adjacent*Columns + From,Adjacent*Columns + To,seeds,fill);
+                }
             }
         }
-        return AllTiles;
     }
 
     /**
-     * Gets all tiles that cannot be a mine
+     * Finishes a cascade on several threads
+     *
+     * The board is split into bands of rows (chunks). A chunk is only ever flooded by one worker at a time, and
+     * runs that spill over into a neighbouring chunk are posted to that chunk's inbox, scheduling it on the
+     * posting worker's queue if it isn't already. Workers take from the back of their own queue and steal from
+     * the front of everyone else's when they run dry.
      *
-     * @param safe_tile: Given safe tile
+     * Since every chunk is flooded with the same span rules, the tiles revealed are the same as a serial
+     * cascade, only the order they are listed in differs
      *
-     * @return All tiles adjacent to and including the safe tile
+     * @param seeds: Blank tiles left over from the serial part of the cascade
+     * @param fill: Where revealed tiles are listed
      */
-    std::set<std::pair<char,char>> getSafeTiles(const std::pair<char,char> safe_tile) {
-        std::set<std::pair<char,char>> SafeTiles = {safe_tile};
-        int Row = (safe_tile.first - CHAR_OFFSET) - 1;
-        int Column = (safe_tile.second - CHAR_OFFSET) - 1;
-        for (int i = 1; i <= 9; i++) {
-            if (IN_BOUNDS(Row,Column,i)) {
-                const std::pair<char,char> SafeTile = {CHAR_OFFSET + Row,CHAR_OFFSET + Column};
-                SafeTiles.insert(SafeTile);
+    void Board::parallelFlood(Memory::Buffer<int>& seeds, Fill& fill) {
+        struct Chunk {
+            std::mutex Lock;
+            std::vector<std::pair<int,int>> Inbox;  // Runs of tiles (first, last grid position) to scan
+            bool Scheduled = false;
+        };
+
+        struct Worker {
+            std::mutex Lock;
+            std::deque<int> Tasks;
+            Fill Result;
+            Memory::Buffer<int> Deltas;
+        };
+
+        const int Threads = Settings.Threads;
+        const int ChunkRows = std::max(MIN_CHUNK_ROWS,Settings.Rows/(Threads*CHUNKS_PER_THREAD));
+        const int NumChunks = (Settings.Rows + ChunkRows - 1)/ChunkRows;
+        std::vector<Chunk> Chunks(NumChunks);
+        std::vector<Worker> Workers(Threads);
+        for (Worker& Each : Workers) {
+            Each.Result.Deltas = &Each.Deltas;
+        }
+        std::atomic<int> Pending(0);
+
+        auto post = [&](int worker, int row, int from, int to) {
+            Chunk& Target = Chunks[row/ChunkRows];
+            bool Schedule = false;
+            {
+                std::lock_guard<std::mutex> Guard(Target.Lock);
+                Target.Inbox.push_back({from,to});
+                Schedule = !Target.Scheduled;
+                Target.Scheduled = true;
             }
-            if (i%3==0) {
-                Row++;
-                Column -= 2;
-            } else {
-                Column++;
+            if (Schedule) {
+                Pending++;
+                std::lock_guard<std::mutex> Guard(Workers[worker].Lock);
+                Workers[worker].Tasks.push_back(row/ChunkRows);
+            }
+        };
+
+        auto run = [&](int worker, int chunk) {
+            Chunk& Current = Chunks[chunk];
+            const int FirstRow = chunk*ChunkRows;
+            const int LastRow = std::min(FirstRow + ChunkRows,Settings.Rows) - 1;
+
+            std::vector<std::pair<int,int>> Runs;
+            std::vector<int> Seeds;
+            while (true) {
+                {
+                    std::lock_guard<std::mutex> Guard(Current.Lock);
+                    if (Current.Inbox.empty()) {
+                        Current.Scheduled = false;
+                        break;
+                    }
+                    Runs.swap(Current.Inbox);
+                }
+
+                for (const auto& Run : Runs) {
+                    scanRun(Run.first,Run.second,Seeds,Workers[worker].Result);
+                }
+                Runs.clear();
+
+                flood(FirstRow,LastRow,Seeds,Workers[worker].Result,
+                    [&](int row, int from, int to) {post(worker,row,from,to);},
+                    std::numeric_limits<int>::max());
+            }
+            Pending--;
+        };
+
+        auto work = [&](int worker) {
+            while (true) {
+                int Task = -1;
+                {
+                    std::lock_guard<std::mutex> Guard(Workers[worker].Lock);
+                    if (!Workers[worker].Tasks.empty()) {
+                        Task = Workers[worker].Tasks.back();
+                        Workers[worker].Tasks.pop_back();
+                    }
+                }
+                for (int i = 1; i < Threads && Task < 0; i++) {
+                    Worker& Victim = Workers[(worker + i)%Threads];
+                    std::lock_guard<std::mutex> Guard(Victim.Lock);
+                    if (!Victim.Tasks.empty()) {
+                        Task = Victim.Tasks.front();
+                        Victim.Tasks.pop_front();
+                    }
+                }
+
+                if (Task >= 0) {
+                    run(worker,Task);
+                } else if (Pending == 0) {
+                    return;
+                } else {
+                    std::this_thread::yield();
+                }
             }
+        };
+
+        for (size_t i = 0; i < seeds.size(); i++) {
+            post(i%Threads,seeds[i]/Settings.Columns,seeds[i],seeds[i]);
+        }
+        seeds.clear();
+
+        std::vector<std::thread> Pool;
+        for (int i = 1; i < Threads; i++) {
+            Pool.emplace_back(work,i);
+        }
+        work(0);
+        for (auto& Thread : Pool) {
+            Thread.join();
+        }
+
+        for (const auto& Worker : Workers) {
+            fill.Tiles.insert(fill.Tiles.end(),Worker.Result.Tiles.begin(),Worker.Result.Tiles.end());
+            fill.Deltas->insert(fill.Deltas->end(),Worker.Deltas.begin(),Worker.Deltas.end());
+            fill.Revealed += Worker.Result.Revealed;
+            fill.Unflagged += Worker.Result.Unflagged;
         }
-        return SafeTiles;
     }
 
-}
+    /**
+     * Reveals every blank tile connected to the input tile, along with the numbered tiles bordering them
+     *
+     * Large cascades are handed over to parallelFlood once they pass PARALLEL_BUDGET tiles
+     *
+     * @param starting_tile: Input blank tile where the search starts
+     * @param tiles: Output, individual tile data which includes the tile itself and the number of adjacent mines,
+     * starting with the input tile. Added to, so that its memory can be reused between taps
+     */
+    void Board::findAllAdjacent(
+        const std::pair<int,int>& starting_tile,
+        std::vector<std::pair<std::pair<int,int>,int>>& tiles
+    ) {
+        tiles.push_back({starting_tile,0});
+
+        const int Start = index(starting_tile);
+        if (Cells[Start] & REVEALED_BIT) {return;}
+
+        Fill Result;
+        Result.Tiles.swap(tiles);
+        Result.Skip = Start;
+        Result.Deltas = &Deltas;
+        Result.From = Deltas.size();
+
+        Seeds.assign(1,Start);
+        const int Budget = Settings.Threads > 1 ? PARALLEL_BUDGET : std::numeric_limits<int>::max();
+        flood(0,Settings.Rows - 1,Seeds,Result,[](int, int, int) {},Budget);
+        if (!Seeds.empty()) {
+            parallelFlood(Seeds,Result);
+        }
 
-namespace Tiles {
+        NumRevealed += Result.Revealed;
+        NumFlagged -= Result.Unflagged;
+        tiles.swap(Result.Tiles);
+    }
+
+    /**
+     * Returns the number of adjacent mines to a given tile
+     *
+     * @param tile: Input tile
+     *
+     * @return 0-8, or 9 if the tile itself is a mine
+     */
+    inline int Board::getNumAdjacentMines(const std::pair<int,int>& tile) const {
+        const unsigned char Cell = Cells[index(tile)];
+        return (Cell & MINE_BIT) ? MINE : (Cell & COUNT_MASK);
+    }
+
+    /**
+     * Returns if given tile is currently flagged
+     *
+     * @param tile: Input tile
+     *
+     */
+    bool Board::tileFlagged(const std::pair<int,int>& tile) const {
+        return Cells[index(tile)] & FLAGGED_BIT;
+    }
+
+    /**
+     * Returns if given tile is currently revealed
+     *
+     * @param tile: Input tile
+     *
+     */
+    bool Board::tileRevealed(const std::pair<int,int>& tile) const {
+        return Cells[index(tile)] & REVEALED_BIT;
+    }
+
+    /**
+     * Returns the number shown on a tile
+     *
+     * @param tile: Input tile
+     *
+     * @return Number of adjacent mines if the tile is revealed, -1 otherwise
+     */
+    int Board::getNumber(const std::pair<int,int>& tile) const {
+        const unsigned char Cell = Cells[index(tile)];
+        return (Cell & REVEALED_BIT) ? (Cell & COUNT_MASK) : -1;
+    }
+
+    /**
+     * Returns what a player sees of a tile
+     *
+     * @param tile: Input tile
+     *
+     * @return The tile's number if it is revealed, otherwise HIDDEN or FLAGGED
+     */
+    signed char Board::getShown(const std::pair<int,int>& tile) const {
+        return shown(index(tile));
+    }
+
+    /**
+     * Returns if given tile is a mine
+     *
+     * @param tile: Input tile
+     *
+     */
+    bool Board::tileMine(const std::pair<int,int>& tile) const {
+        return Cells[index(tile)] & MINE_BIT;
+    }
+
+    /**
+     * Copies what a player can see of the whole board
+     *
+     * @param view: Output, one value per tile in row major order. The tile's number if it is revealed, otherwise
+     * HIDDEN or FLAGGED
+     */
+    void Board::getView(std::vector<signed char>& view) const {
+        view.resize(TotalTiles);
+        for (int i = 0; i < TotalTiles; i++) {
+            view[i] = shown(i);
+        }
+    }
+
+    /**
+     * Returns what a player sees of a tile, its number if revealed, FLAGGED or HIDDEN if not
+     *
+     * @param index: Grid position of the tile
+     */
+    inline signed char Board::shown(int index) const {
+        const unsigned char Cell = Cells[index];
+        if (Cell & REVEALED_BIT) {return Cell & COUNT_MASK;}
+        return (Cell & FLAGGED_BIT) ? FLAGGED : HIDDEN;
+    }
 
     /**
      * Generates a new Minesweeper board
      *
+     * The same settings, seed and starting tile always give the same board
+     *
      * @param safe_tile: Starting tile, all tiles adjacent and including will not be a mine
+     * @param seed: Seed for the random number generator that places the mines
      */
-    void generateBoard(const std::pair<char,char>& safe_tile) {
-        Board.clean();
+    void Board::generateBoard(const std::pair<int,int>& safe_tile, std::uint64_t seed) {
+        clean();
+        Prng::Generator Rng(seed);
+        generateMines(safe_tile,Rng);
+        setTiles();
+    }
 
-        // auto cause i'm lazy
-        auto AllTiles = getAllTiles();
-        auto SafeTiles = getSafeTiles(safe_tile);
+    /**
+     * Sets up a board from a known layout, e.g. one generated ahead of time by another board
+     *
+     * @param mines: Grid positions of every mine, in row major order
+     */
+    void Board::loadBoard(const std::vector<int>& mines) {
+        clean();
+        Mines.assign(mines.begin(),mines.end());
+        for (const int Mine : Mines) {
+            Plane[Mine] = 1;
+        }
+        setTiles();
+    }
 
-        Board.generateMines(AllTiles,SafeTiles);
-        Board.setTiles(AllTiles);
+    /**
+     * Picks up a board exactly where it was left, e.g. from a snapshot. Both arrays are checked, then copied as they
+     * are, there is nothing to work out again
+     *
+     * The move history starts over, moves made before the board was saved can't be undone
+     *
+     * @param cells: Every cell, as returned by getCells
+     * @param mines: Grid positions of every mine, in row major order
+     * @param revealed: Number of revealed tiles
+     * @param flagged: Number of flagged tiles
+     *
+     * @return False if the board isn't one the game could have left, the board is then left as it was
+     */
+    bool Board::loadState(const unsigned char* cells, const int* mines, int revealed, int flagged) {
+        if (!consistent(cells,mines,Settings,revealed,flagged)) {return false;}
+
+        clean();
+        std::copy(cells,cells + TotalTiles,Cells.begin());
+        Mines.assign(mines,mines + Settings.Mines);
+        NumRevealed = revealed;
+        NumFlagged = flagged;
+        return true;
     }
 
     /**
@@ -281,51 +674,73 @@ namespace Tiles {
      *
      * @param tapped_tile: Input tile
      *
-     * @return WIP
+     * @return Revealed tiles along with the state of the game
      */
-    Responses::Tap Tap(const std::pair<char,char>& tapped_tile) {
-
+    Responses::Tap Board::Tap(const std::pair<int,int>& tapped_tile) {
         Responses::Tap Response;
+        Tap(tapped_tile,Response);
+        return Response;
+    }
+
+    /**
+     * Handles which tiles should be revealed based on tile input, filling in a response owned by the caller
+     *
+     * The response's tiles are cleared rather than freed, so tapping into the same response every time only
+     * allocates when a tap reveals more tiles than it has room for. Reserving room for every tile up front means
+     * it never does.
+     *
+     * @param tapped_tile: Input tile
+     * @param response: Output, revealed tiles along with the state of the game
+     */
+    void Board::Tap(const std::pair<int,int>& tapped_tile, Responses::Tap& response) {
+
+        response.Tiles.clear();
 
         // Do nothing pretty much
-        if (Board.tileFlagged(tapped_tile)) {
-            Response.State = States::Game::Playon;
-            Response.NumTilesLeft = Board.getRemaining();
-            Response.NumFlags = Board.Flagged.size();
-            return Response;
+        if (tileFlagged(tapped_tile)) {
+            response.State = States::Game::Playon;
+            response.NumTilesLeft = getRemaining();
+            response.NumFlags = NumFlagged;
+            return;
         }
 
-        const int AdjacentMines = Board.getNumAdjacentMines(tapped_tile);
+        // Tapping a revealed tile changes nothing, anything else is logged so that it can be undone
+        const int AdjacentMines = getNumAdjacentMines(tapped_tile);
+        const bool Changes = !tileRevealed(tapped_tile);
+        if (Changes) {record(index(tapped_tile),false);}
 
         switch (AdjacentMines) {
-            case 9: { // Tile is a mine
-                for (const auto& Mine : Board.Mines) {
-                    Response.Tiles.push_back({Mine,9});
+            case MINE: { // Tile is a mine
+                response.Tiles.reserve(Mines.size());
+                for (const int Mine : Mines) {
+                    response.Tiles.push_back({tile(Mine),MINE});
                 }
-                Response.State = States::Game::Lose;
-                Response.NumTilesLeft = Board.getRemaining();
-                Response.NumFlags = Board.Flagged.size();
-                return Response;
+                response.State = States::Game::Lose;
+                response.NumTilesLeft = getRemaining();
+                response.NumFlags = NumFlagged;
+                return;
             }
 
             case 0: { // Tile is blank (0 adjacent mines)
-                Response.Tiles = Board.findAllAdjacent(tapped_tile);
-                Response.NumTilesLeft = Board.getRemaining();
-                Response.NumFlags = Board.Flagged.size();
+                findAllAdjacent(tapped_tile,response.Tiles);
                 break;
             }
 
             default: { // Tile has at least 1 adjacent mine
-                Board.Revealed.insert(tapped_tile);
-                Response.Tiles.push_back({tapped_tile,AdjacentMines});
+                if (Changes) {
+                    reveal(index(tapped_tile));
+                    Deltas.push_back(index(tapped_tile));
+                    Deltas.push_back(1);
+                }
+                response.Tiles.push_back({tapped_tile,AdjacentMines});
                 break;
             }
         }
+        if (Changes) {Moves.back().End = Deltas.size();}
 
-        Response.State = Board.getRemaining() == NUM_MINES ? States::Game::Win : States::Game::Playon;
-        Response.NumTilesLeft = Board.getRemaining();
-        Response.NumFlags = Board.Flagged.size();
-        return Response;
+        response.State = getRemaining() == Settings.Mines ? States::Game::Win : States::Game::Playon;
+        response.NumTilesLeft = getRemaining();
+        response.NumFlags = NumFlagged;
     }
 
     /**
@@ -340,31 +755,151 @@ namespace Tiles {
      * @param flagged_tile: Input Tile
      *
      * @return
-     * true: If the input tile is not already flagged
+     * Add: If the input tile is not already flagged
+     *
+     * Remove: If the input tile is already flagged
      *
-     * false: If the input tile is already flagged or revealed
+     * Nothing: If the input tile is revealed
      *
      */
-    Responses::Flag Flag(const std::pair<char,char>& flagged_tile) {
+    Responses::Flag Board::Flag(const std::pair<int,int>& flagged_tile) {
 
         Responses::Flag Response;
 
-        if (Board.tileRevealed(flagged_tile)) {     // Tile is revealed
+        if (tileRevealed(flagged_tile)) {           // Tile is revealed
             Response.State = States::Flag::Nothing;
         }
 
-        else if (Board.tileFlagged(flagged_tile)) { // Tile is currently flagged
-            Board.Flagged.erase(flagged_tile);
+        else if (tileFlagged(flagged_tile)) {       // Tile is currently flagged
+            Cells[index(flagged_tile)] &= ~FLAGGED_BIT;
+            NumFlagged--;
+            record(index(flagged_tile),true);
             Response.State = States::Flag::Remove;
         }
 
         else {                                      // Tile is not currently flagged
-            Board.Flagged.insert(flagged_tile);
+            Cells[index(flagged_tile)] |= FLAGGED_BIT;
+            NumFlagged++;
+            record(index(flagged_tile),true);
             Response.State = States::Flag::Add;
         }
 
-        Response.NumFlags = Board.Flagged.size();
+        Response.NumFlags = NumFlagged;
         return Response;
     };
 
-}
\ No newline at end of file
+    /**
+     * Takes back the last move that was not undone yet
+     *
+     * Only the tiles the move changed are touched, so undoing a move costs about as much as making it did
+     *
+     * @param step: Output, tiles whose view changed along with what they show now and the new state of the game
+     *
+     * @return False if there is no move to undo
+     */
+    bool Board::Undo(Responses::Step& step) {
+
+        step.Tiles.clear();
+        if (!Played) {return false;}
+        const Move& Last = Moves[--Played];
+
+        if (Last.Flag) {
+            Cells[Last.Tile] ^= FLAGGED_BIT;
+            NumFlagged += (Cells[Last.Tile] & FLAGGED_BIT) ? 1 : -1;
+            step.Tiles.push_back({tile(Last.Tile),shown(Last.Tile)});
+        }
+
+        else if (Cells[Last.Tile] & MINE_BIT) {     // Losing tap, the mines it showed are covered up again
+            step.Tiles.reserve(Mines.size());
+            for (const int Mine : Mines) {
+                step.Tiles.push_back({tile(Mine),shown(Mine)});
+            }
+        }
+
+        else {
+            // Flags go back first, so that the tiles listed below show them
+            for (int i = Last.Begin; i < Last.End; i += 2) {
+                if (!Deltas[i + 1]) {
+                    Cells[Deltas[i]] |= FLAGGED_BIT;
+                    NumFlagged++;
+                }
+            }
+            for (int i = Last.Begin; i < Last.End; i += 2) {
+                const int First = Deltas[i], Count = Deltas[i + 1];
+                for (int Index = First; Index < First + Count; Index++) {
+                    Cells[Index] &= ~REVEALED_BIT;
+                    step.Tiles.push_back({tile(Index),shown(Index)});
+                }
+                NumRevealed -= Count;
+            }
+        }
+
+        step.State = States::Game::Playon;
+        step.NumTilesLeft = getRemaining();
+        step.NumFlags = NumFlagged;
+        return true;
+    }
+
+    /**
+     * Makes the last undone move again
+     *
+     * @param step: Output, tiles whose view changed along with what they show now and the new state of the game
+     *
+     * @return False if there is no undone move, any new move drops the undone ones
+     */
+    bool Board::Redo(Responses::Step& step) {
+
+        step.Tiles.clear();
+        if (Played == (int)Moves.size()) {return false;}
+        const Move& Next = Moves[Played++];
+
+        if (Next.Flag) {
+            Cells[Next.Tile] ^= FLAGGED_BIT;
+            NumFlagged += (Cells[Next.Tile] & FLAGGED_BIT) ? 1 : -1;
+            step.Tiles.push_back({tile(Next.Tile),shown(Next.Tile)});
+        }
+
+        else if (Cells[Next.Tile] & MINE_BIT) {
+            step.Tiles.reserve(Mines.size());
+            for (const int Mine : Mines) {
+                step.Tiles.push_back({tile(Mine),MINE});
+            }
+            step.State = States::Game::Lose;
+            step.NumTilesLeft = getRemaining();
+            step.NumFlags = NumFlagged;
+            return true;
+        }
+
+        else {
+            for (int i = Next.Begin; i < Next.End; i += 2) {
+                const int First = Deltas[i], Count = Deltas[i + 1];
+                if (!Count) {NumFlagged--;}
+                for (int Index = First; Index < First + Count; Index++) {
+                    Cells[Index] = (Cells[Index] & ~FLAGGED_BIT) | REVEALED_BIT;
+                    step.Tiles.push_back({tile(Index),Cells[Index] & COUNT_MASK});
+                }
+                NumRevealed += Count;
+            }
+        }
+
+        step.State = getRemaining() == Settings.Mines ? States::Game::Win : States::Game::Playon;
+        step.NumTilesLeft = getRemaining();
+        step.NumFlags = NumFlagged;
+        return true;
+    }
+
+    /**
+     * Starts logging a move, dropping every undone move since they can't be redone after it
+     *
+     * @param index: Grid position tapped or flagged
+     * @param flag: If the move is a flag
+     */
+    void Board::record(int index, bool flag) {
+        const int Begin = Played ? Moves[Played - 1].End : 0;
+        Moves.resize(Played);
+        Deltas.resize(Begin);
+        Moves.push_back({index,flag,Begin,Begin});
+        Played++;
+    }
+
+}
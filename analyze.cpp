@@ -0,0 +1,211 @@
+#include "analytics.hpp"
+#include "coords.hpp"
+
+#include <iostream>
+#include <iomanip>
+#include <cstdlib>
+#include <cstring>
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <string>
+
+#include <dirent.h>
+#include <sys/stat.h>
+
+// Reads any number of replays on every core and prints what happened in them
+// clang++ -std=c++11 -O2 -pthread -IHeaders -o binary/minesweeper-analyze analyze.cpp Sources/analytics.cpp Sources/replay.cpp Sources/game.cpp Sources/snapshot.cpp Sources/noguess.cpp Sources/solver.cpp Sources/tiles.cpp Sources/memory.cpp Sources/counts.cpp Sources/coords.cpp Sources/config.cpp
+
+namespace {
+
+    struct Options {
+        long long Jobs = std::max(1u,std::thread::hardware_concurrency());
+        long long Top = 5;          // Openings listed at each end
+        long long MinBoards = 30;   // Boards an opening needs to be listed
+        std::vector<std::string> Paths;
+    };
+
+    void usage(const char* program) {
+        std::cerr
+        << "Usage: " << program << " [-j JOBS] [--top N] [--min-boards N] PATH...\n"
+        << "  Every path is a recording, or a directory whose files are all recordings\n";
+    }
+
+    /**
+     * Reads the options, everything that isn't one is a path
+     *
+     * @return If every option was valid and there is at least one path
+     */
+    bool parseOptions(int argc, char* argv[], Options& options) {
+        for (int i = 1; i < argc; i++) {
+            const char* Arg = argv[i];
+            const char* Value = (i + 1 < argc) ? argv[i + 1] : nullptr;
+
+            long long* Target;
+            if (!std::strcmp(Arg,"-j") || !std::strcmp(Arg,"--jobs")) {Target = &options.Jobs;}
+            else if (!std::strcmp(Arg,"--top"))                          {Target = &options.Top;}
+            else if (!std::strcmp(Arg,"--min-boards"))                   {Target = &options.MinBoards;}
+            else {
+                options.Paths.push_back(Arg);
+                continue;
+            }
+
+            char* End;
+            if (Value == nullptr) {return false;}
+            *Target = std::strtoll(Value,&End,10);
+            if (*Value == '\0' || *End != '\0' || *Target < 0) {return false;}
+            i++;
+        }
+        return options.Jobs >= 1 && !options.Paths.empty();
+    }
+
+    /**
+     * Hands out recordings to the jobs one at a time, listing directories as it goes rather than up front, so
+     * memory doesn't grow with the number of recordings
+     */
+    class Source {
+    public:
+        explicit Source(const std::vector<std::string>& paths) : Paths(paths) {}
+        ~Source() {
+            if (Directory) {closedir(Directory);}
+        }
+
+        bool Next(std::string& path) {
+            std::lock_guard<std::mutex> Guard(Lock);
+            while (true) {
+                if (Directory) {
+                    const dirent* Entry = readdir(Directory);
+                    if (Entry) {
+                        path = Folder + '/' + Entry->d_name;
+                        struct stat Info;
+                        if (stat(path.c_str(),&Info) == 0 && S_ISREG(Info.st_mode)) {return true;}
+                        continue;
+                    }
+                    closedir(Directory);
+                    Directory = nullptr;
+                }
+                if (Index == Paths.size()) {return false;}
+
+                path = Paths[Index++];
+                Directory = opendir(path.c_str());
+                if (!Directory) {return true;}
+                Folder = path;
+            }
+        }
+
+    private:
+        const std::vector<std::string>& Paths;
+        std::size_t Index = 0;
+        DIR* Directory = nullptr;
+        std::string Folder;
+        std::mutex Lock;
+    };
+
+    void printHistogram(const char* label, const Analytics::Histogram& histogram, double scale) {
+        std::cout << label;
+        if (!histogram.Count()) {
+            std::cout << "none\n";
+            return;
+        }
+        std::cout
+        << "mean " << histogram.Mean()/scale
+        << ", p50 " << histogram.Percentile(50)/scale
+        << ", p90 " << histogram.Percentile(90)/scale
+        << ", p99 " << histogram.Percentile(99)/scale
+        << ", max " << histogram.Max()/scale
+        << " (" << histogram.Count() << ")\n";
+    }
+
+    inline double percent(long long part, long long whole) {
+        return whole ? 100.0*part/whole : 0;
+    }
+
+    /**
+     * Prints the win rate of corner, edge and inner openings, then the openings that did best and worst
+     */
+    void printOpenings(const Analytics::Summary& summary, const Options& options) {
+        Analytics::Opening Kinds[3];
+        const char* KIND_NAMES[3] = {"Corner","Edge","Inner"};
+        std::vector<std::pair<double,std::array<int,4>>> Listed;
+        for (const auto& Entry : summary.Openings) {
+            const std::array<int,4>& Key = Entry.first;
+            const int Sides = (Key[2] == 1 || Key[2] == Key[0]) + (Key[3] == 1 || Key[3] == Key[1]);
+            Analytics::Opening& Kind = Kinds[Sides == 2 ? 0 : Sides == 1 ? 1 : 2];
+            Kind.Boards += Entry.second.Boards;
+            Kind.Won += Entry.second.Won;
+            if (Entry.second.Boards >= options.MinBoards) {
+                Listed.push_back({percent(Entry.second.Won,Entry.second.Boards),Key});
+            }
+        }
+        for (int i = 0; i < 3; i++) {
+            std::cout << "Openings " << std::left << std::setw(8) << KIND_NAMES[i] << std::right
+            << Kinds[i].Boards << " boards, " << percent(Kinds[i].Won,Kinds[i].Boards) << "% won\n";
+        }
+
+        std::sort(Listed.begin(),Listed.end(),[](
+            const std::pair<double,std::array<int,4>>& a, const std::pair<double,std::array<int,4>>& b
+        ) {return a.first > b.first;});
+        const auto list = [&](const char* label, std::size_t from, std::size_t to) {
+            for (std::size_t i = from; i < to; i++) {
+                const std::array<int,4>& Key = Listed[i].second;
+                const Analytics::Opening& Cell = summary.Openings.at(Key);
+                std::cout << label << Key[0] << 'x' << Key[1] << ' ' << Coords::Format({Key[2],Key[3]})
+                << ", " << Cell.Boards << " boards, " << Listed[i].first << "% won\n";
+            }
+        };
+        const std::size_t Top = std::min<std::size_t>(options.Top,Listed.size());
+        list("Best opening     ",0,Top);
+        list("Worst opening    ",std::max(Top,Listed.size() - Top),Listed.size());
+    }
+
+}
+
+int main(int argc, char* argv[]) {
+    Options Options;
+    if (!parseOptions(argc,argv,Options)) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    Source Recordings(Options.Paths);
+    std::vector<Analytics::Summary> PerJob(Options.Jobs);
+    std::vector<std::thread> Jobs;
+
+    const auto Start = std::chrono::steady_clock::now();
+    for (int j = 0; j < Options.Jobs; j++) {
+        Jobs.emplace_back([&Recordings,&PerJob,j]() {
+            std::string Path;
+            while (Recordings.Next(Path)) {
+                Analytics::Analyze(Path,PerJob[j]);
+            }
+        });
+    }
+    for (auto& Job : Jobs) {
+        Job.join();
+    }
+    const double Seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - Start).count();
+
+    Analytics::Summary Total;
+    for (const Analytics::Summary& Job : PerJob) {
+        Total.Merge(Job);
+    }
+
+    const Responses::SessionStats& Stats = Total.Stats;
+    std::cout << std::fixed << std::setprecision(2)
+    << "Recordings       " << Total.Recordings << " (" << Total.Unreadable << " unreadable, "
+    << Total.Damaged << " damaged)\n"
+    << "Events           " << Total.Events << '\n'
+    << "Jobs             " << Options.Jobs << '\n'
+    << "Seconds          " << Seconds << '\n'
+    << "Events/sec       " << Total.Events/std::max(Seconds,1e-9) << '\n'
+    << "Boards Played    " << Stats.BoardsPlayed << '\n'
+    << "Games Won        " << Stats.GamesWon << " (" << percent(Stats.GamesWon,Stats.BoardsPlayed) << "%)\n"
+    << "Games Lost       " << Stats.GamesLost << '\n'
+    << "Tiles Revealed   " << Stats.TilesRevealed << '\n';
+    printHistogram("Tiles per tap    ",Total.TilesPerTap,1);
+    printHistogram("Moves per board  ",Total.MovesPerBoard,1);
+    printHistogram("Board seconds    ",Total.BoardMillis,1000);
+    printHistogram("First loss secs  ",Total.FirstLossMillis,1000);
+    printOpenings(Total,Options);
+}
@@ -0,0 +1,275 @@
+#include "tiles.hpp"
+
+#include <algorithm>
+#include <iostream>
+#include <iomanip>
+#include <utility>
+#include <random>
+#include <chrono>
+#include <vector>
+#include <stack>
+#include <map>
+#include <set>
+
+// clang++ -std=c++11 -O2 -pthread -IHeaders -o binary/bench_board benchmarks/bench_board.cpp Sources/tiles.cpp Sources/memory.cpp Sources/counts.cpp && ./binary/bench_board
+
+namespace Legacy {
+
+    // The map/set board that tiles.cpp used before the flat grid, kept as the baseline
+
+    struct {
+        std::map<std::pair<char,char>,int> Tiles;
+        std::set<std::pair<char,char>> Mines;
+        std::set<std::pair<char,char>> Revealed;
+        std::set<std::pair<char,char>> Flagged;
+    } Board;
+
+    std::mt19937 Rng(175);
+
+    std::vector<std::pair<char,char>> getAllTiles() {
+        std::vector<std::pair<char,char>> AllTiles;
+        AllTiles.reserve(676);
+        for (int Row = 1; Row <= 26; Row++) {
+            for (int Column = 1; Column <= 26; Column++) {
+                AllTiles.push_back({64 + Row,64 + Column});
+            }
+        }
+        return AllTiles;
+    }
+
+    void generateBoard(const std::pair<int,int>& safe) {
+        const std::pair<char,char> safe_tile = {64 + safe.first,64 + safe.second};
+        Board.Tiles.clear();
+        Board.Mines.clear();
+        Board.Revealed.clear();
+        Board.Flagged.clear();
+
+        auto AllTiles = getAllTiles();
+        std::set<std::pair<char,char>> SafeTiles;
+        for (int r = -1; r <= 1; r++) {
+            for (int c = -1; c <= 1; c++) {
+                const int Row = safe_tile.first - 64 + r;
+                const int Column = safe_tile.second - 64 + c;
+                if (Row > 0 && Row <= 26 && Column > 0 && Column <= 26) {
+                    SafeTiles.insert({64 + Row,64 + Column});
+                }
+            }
+        }
+
+        std::shuffle(AllTiles.begin(),AllTiles.end(),Rng);
+        int Converted = 0;
+        for (const auto& Tile : AllTiles) {
+            if (SafeTiles.find(Tile) == SafeTiles.end()) {
+                Board.Mines.insert(Tile);
+                Converted++;
+            }
+            if (Converted == 100) {break;}
+        }
+
+        for (const auto& Tile : AllTiles) {
+            if (Board.Mines.find(Tile) != Board.Mines.end()) {
+                Board.Tiles[Tile] = 9;
+                continue;
+            }
+            int MinesFound = 0;
+            for (int r = -1; r <= 1; r++) {
+                for (int c = -1; c <= 1; c++) {
+                    const int Row = Tile.first - 64 + r;
+                    const int Column = Tile.second - 64 + c;
+                    if ((r != 0 || c != 0) && Row > 0 && Row <= 26 && Column > 0 && Column <= 26 &&
+                        Board.Mines.find({64 + Row,64 + Column}) != Board.Mines.end()) {
+                        MinesFound++;
+                    }
+                }
+            }
+            Board.Tiles[Tile] = MinesFound;
+        }
+    }
+
+    Responses::Tap Tap(const std::pair<int,int>& tapped) {
+        const std::pair<char,char> tapped_tile = {64 + tapped.first,64 + tapped.second};
+        Responses::Tap Response;
+        Response.State = States::Game::Playon;
+        if (Board.Flagged.find(tapped_tile) != Board.Flagged.end()) {return Response;}
+
+        const int AdjacentMines = Board.Tiles[tapped_tile];
+        if (AdjacentMines == 9) {
+            for (const auto& Mine : Board.Mines) {
+                Response.Tiles.push_back({{Mine.first - 64,Mine.second - 64},9});
+            }
+            Response.State = States::Game::Lose;
+            return Response;
+        }
+
+        Response.Tiles.push_back({tapped,AdjacentMines});
+        Board.Revealed.insert(tapped_tile);
+        if (AdjacentMines == 0) {
+            std::stack<std::pair<char,char>,std::vector<std::pair<char,char>>> Stack;
+            Stack.push(tapped_tile);
+            do {
+                const auto CurrentTile = Stack.top();
+                Stack.pop();
+                for (int r = -1; r <= 1; r++) {
+                    for (int c = -1; c <= 1; c++) {
+                        const int Row = CurrentTile.first - 64 + r;
+                        const int Column = CurrentTile.second - 64 + c;
+                        if (Row <= 0 || Row > 26 || Column <= 0 || Column > 26) {continue;}
+
+                        const std::pair<char,char> AdjacentTile = {64 + Row,64 + Column};
+                        if (Board.Revealed.find(AdjacentTile) == Board.Revealed.end()) {
+                            Board.Revealed.insert(AdjacentTile);
+                            const int Mines = Board.Tiles[AdjacentTile];
+                            Response.Tiles.push_back({{Row,Column},Mines});
+                            if (Mines == 0) {Stack.push(AdjacentTile);}
+                            Board.Flagged.erase(AdjacentTile);
+                        }
+                    }
+                }
+            } while (!Stack.empty());
+        }
+
+        Response.NumTilesLeft = 676 - Board.Revealed.size();
+        Response.NumFlags = Board.Flagged.size();
+        if (Response.NumTilesLeft == 100) {Response.State = States::Game::Win;}
+        return Response;
+    }
+
+    Responses::Flag Flag(const std::pair<int,int>& flagged) {
+        const std::pair<char,char> flagged_tile = {64 + flagged.first,64 + flagged.second};
+        Responses::Flag Response;
+        if (Board.Revealed.find(flagged_tile) != Board.Revealed.end()) {
+            Response.State = States::Flag::Nothing;
+        } else if (Board.Flagged.erase(flagged_tile)) {
+            Response.State = States::Flag::Remove;
+        } else {
+            Board.Flagged.insert(flagged_tile);
+            Response.State = States::Flag::Add;
+        }
+        Response.NumFlags = Board.Flagged.size();
+        return Response;
+    }
+
+}
+
+/**
+ * Plays the same scripted sequence of moves against an engine
+ *
+ * Every game starts with a tap on the safe tile, followed by flagging/unflagging and tapping random tiles
+ * until the game is over
+ *
+ * @return Nanoseconds per game
+ */
+template <typename Generate, typename TapFn, typename FlagFn>
+double benchGames(int games, Generate generate, TapFn tap, FlagFn flag) {
+    std::mt19937 Moves(2024);
+    std::uniform_int_distribution<int> Letter(1,26);
+    long long Revealed = 0;
+
+    const auto Start = std::chrono::steady_clock::now();
+    for (int g = 0; g < games; g++) {
+        const std::pair<int,int> SafeTile = {Letter(Moves),Letter(Moves)};
+        generate(SafeTile);
+
+        Responses::Tap TR = tap(SafeTile);
+        Revealed += TR.Tiles.size();
+
+        for (int i = 0; i < 40; i++) {
+            const std::pair<int,int> Tile = {Letter(Moves),Letter(Moves)};
+            flag(Tile);
+            flag(Tile);
+        }
+
+        while (TR.State == States::Game::Playon) {
+            TR = tap({Letter(Moves),Letter(Moves)});
+            Revealed += TR.Tiles.size();
+        }
+    }
+    const auto End = std::chrono::steady_clock::now();
+
+    // Keeps the work from being optimised away
+    if (Revealed == 0) {std::cout << "";}
+    return std::chrono::duration<double,std::nano>(End - Start).count()/games;
+}
+
+/**
+ * Times the cascade from a single tap on a large, sparsely mined board
+ *
+ * Only the tap itself is timed, not generating the board
+ *
+ * @return Million tiles revealed per second
+ */
+double benchCascade(int rows, int columns, int mines, int threads) {
+    Config::Settings Settings;
+    Settings.Rows = rows;
+    Settings.Columns = columns;
+    Settings.Mines = mines;
+    Settings.Threads = threads;
+    Tiles::Board Board(Settings);
+    std::mt19937 Rng(175);
+
+    long long Revealed = 0;
+    double Seconds = 0;
+    for (int i = 0; i < 5; i++) {
+        Board.generateBoard({rows/2,columns/2},Rng());
+
+        const auto Start = std::chrono::steady_clock::now();
+        Revealed += Board.Tap({rows/2,columns/2}).Tiles.size();
+        const auto End = std::chrono::steady_clock::now();
+        Seconds += std::chrono::duration<double>(End - Start).count();
+    }
+    return Revealed/Seconds/1e6;
+}
+
+/**
+ * Times generating boards, placing the mines and counting them
+ *
+ * @return Nanoseconds per board
+ */
+double benchGenerate(int rows, int columns, int mines, int boards) {
+    Config::Settings Settings;
+    Settings.Rows = rows;
+    Settings.Columns = columns;
+    Settings.Mines = mines;
+    Tiles::Board Board(Settings);
+
+    long long Placed = 0;
+    const auto Start = std::chrono::steady_clock::now();
+    for (int b = 0; b < boards; b++) {
+        Board.generateBoard({1 + b%rows,1 + b%columns},b);
+        Placed += Board.getMines().back();
+    }
+    const auto End = std::chrono::steady_clock::now();
+
+    if (Placed == 0) {std::cout << "";}
+    return std::chrono::duration<double,std::nano>(End - Start).count()/boards;
+}
+
+int main() {
+    const int GAMES = 20000;
+
+    const double Before = benchGames(GAMES,Legacy::generateBoard,Legacy::Tap,Legacy::Flag);
+    Tiles::Board Board((Config::Settings()));
+    std::mt19937 Rng(175);
+    const double After = benchGames(GAMES,
+        [&](const std::pair<int,int>& tile) {Board.generateBoard(tile,Rng());},
+        [&](const std::pair<int,int>& tile) {return Board.Tap(tile);},
+        [&](const std::pair<int,int>& tile) {return Board.Flag(tile);});
+
+    std::cout << std::fixed << std::setprecision(0)
+    << "map/set board  : " << Before << " ns/game\n"
+    << "flat grid      : " << After << " ns/game\n"
+    << std::setprecision(2)
+    << "speedup        : " << Before/After << "x\n";
+
+    std::cout
+    << "generate 26x26      : " << benchGenerate(26,26,100,200000) << " ns/board\n"
+    << "generate 1000x1000  : " << benchGenerate(1000,1000,1000,200) << " ns/board\n";
+
+    std::cout << std::setprecision(1)
+    << "cascade 1000x1000   : " << benchCascade(1000,1000,1000,1) << " million tiles/s\n";
+
+    for (int Threads = 1; Threads <= 8; Threads *= 2) {
+        std::cout << "cascade 4000x4000, " << Threads << " thread(s) : "
+        << benchCascade(4000,4000,16000,Threads) << " million tiles/s\n";
+    }
+}
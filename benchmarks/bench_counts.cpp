@@ -0,0 +1,84 @@
+#include "counts.hpp"
+
+#include <algorithm>
+#include <iostream>
+#include <iomanip>
+#include <random>
+#include <chrono>
+#include <vector>
+
+// clang++ -std=c++11 -O2 -IHeaders -o binary/bench_counts benchmarks/bench_counts.cpp Sources/counts.cpp && ./binary/bench_counts
+
+/**
+ * The per tile neighbour probe setTiles used to do, kept as the baseline
+ */
+void probeCounts(const unsigned char* mines, unsigned char* counts, int rows, int columns) {
+    for (int Row = 0; Row < rows; Row++) {
+        for (int Column = 0; Column < columns; Column++) {
+            int MinesFound = 0;
+            for (int r = Row - 1; r <= Row + 1; r++) {
+                for (int c = Column - 1; c <= Column + 1; c++) {
+                    if ((r != Row || c != Column) && r >= 0 && r < rows && c >= 0 && c < columns) {
+                        MinesFound += mines[r*columns + c];
+                    }
+                }
+            }
+            counts[Row*columns + Column] = MinesFound;
+        }
+    }
+}
+
+/**
+ * Times a counting function over a board, repeating it until at least ~100M tiles have been counted
+ *
+ * @return Million tiles counted per second
+ */
+template <typename Fn>
+double benchCounts(int rows, int columns, Fn count) {
+    std::mt19937 g(99);
+    std::vector<unsigned char> Mines((long long)rows*columns);
+    std::vector<unsigned char> Counts((long long)rows*columns);
+    for (auto& Mine : Mines) {
+        Mine = g()%100 < 15;  // Classic density, 100/676
+    }
+
+    const long long Tiles = (long long)rows*columns;
+    const int Repeats = std::max<long long>(1,100000000/Tiles);
+
+    const auto Start = std::chrono::steady_clock::now();
+    for (int i = 0; i < Repeats; i++) {
+        count(Mines.data(),Counts.data(),rows,columns);
+    }
+    const auto End = std::chrono::steady_clock::now();
+
+    const double Seconds = std::chrono::duration<double>(End - Start).count();
+    return Tiles*Repeats/Seconds/1e6;
+}
+
+int main() {
+    const int Sizes[][2] = {{26,26},{100,100},{1000,1000},{4000,4000},{10000,10000}};
+
+    std::cout << std::left << std::setw(14) << "board" << std::setw(12) << "probe";
+    for (int k = 0; k <= 2; k++) {
+        std::cout << std::setw(12) << Counts::Name((Counts::Kernel)k);
+    }
+    std::cout << "(million tiles/s)\n" << std::fixed << std::setprecision(0);
+
+    for (const auto& Size : Sizes) {
+        const std::string Board = std::to_string(Size[0]) + 'x' + std::to_string(Size[1]);
+        std::cout << std::setw(14) << Board << std::setw(12) << benchCounts(Size[0],Size[1],probeCounts);
+
+        for (int k = 0; k <= 2; k++) {
+            const Counts::Kernel Kernel = (Counts::Kernel)k;
+            if (!Counts::Supported(Kernel)) {
+                std::cout << std::setw(12) << "-";
+                continue;
+            }
+            std::cout << std::setw(12) << benchCounts(Size[0],Size[1],
+                [Kernel](const unsigned char* mines, unsigned char* counts, int rows, int columns) {
+                    Counts::Compute(mines,counts,rows,columns,Kernel);
+                });
+        }
+        std::cout << '\n';
+    }
+}
@@ -0,0 +1,196 @@
+#include "input.hpp"
+
+#include <algorithm>
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <cstdlib>  // For malloc, free
+#include <cctype>
+#include <random>
+#include <chrono>
+#include <string>
+#include <vector>
+#include <new>
+#include <map>
+
+// clang++ -std=c++11 -O2 -IHeaders -o binary/bench_input benchmarks/bench_input.cpp Sources/input.cpp Sources/coords.cpp && ./binary/bench_input
+
+long long Allocations = 0;
+
+void* operator new(std::size_t size) {
+    Allocations++;
+    if (void* Memory = std::malloc(size ? size : 1)) {return Memory;}
+    throw std::bad_alloc();
+}
+
+void operator delete(void* memory) noexcept {
+    std::free(memory);
+}
+
+namespace Legacy {
+
+    // The split() based parser input.cpp had before it read words in place, kept as the baseline
+
+    std::vector<std::string> split(std::string& s, const char delimiter = ' ') {
+        std::vector<std::string> Strings;
+        size_t Position = 0;
+        std::string Str;
+        while ((Position = s.find(delimiter)) != std::string::npos) {
+            Str = s.substr(0,Position);
+            if (Str.size() >= 1) {
+                std::transform(Str.begin(),Str.end(),Str.begin(),[](unsigned char c){return std::tolower(c);});
+                Strings.push_back(Str);
+            }
+            s.erase(0,Position + 1);
+        }
+        if (s.size() >= 1) {
+            std::transform(s.begin(),s.end(),s.begin(),[](unsigned char c){return std::tolower(c);});
+            Strings.push_back(s);
+        }
+        return Strings;
+    }
+
+    std::string splitPath(const std::string& input, std::string& path) {
+        const size_t Start = input.find_first_not_of(' ');
+        if (Start == std::string::npos) {return "";}
+        const size_t End = input.find(' ',Start);
+        std::string Key = input.substr(Start,End - Start);
+        std::transform(Key.begin(),Key.end(),Key.begin(),[](unsigned char c){return std::tolower(c);});
+        const size_t First = End == std::string::npos ? End : input.find_first_not_of(' ',End);
+        const size_t Last = input.find_last_not_of(' ');
+        path = First == std::string::npos ? "" : input.substr(First,Last + 1 - First);
+        return Key;
+    }
+
+    std::pair<int,int> parseTile(std::string& tile, const Config::Settings& settings) {
+        std::vector<std::string> Tokens = split(tile,':');
+        if (Tokens.size() != 2) {
+            Tokens = split(tile,';');
+            if (Tokens.size() != 2) {return {0,0};}
+        }
+        const int Row = Coords::Parse(Tokens[0]);
+        const int Column = Coords::Parse(Tokens[1]);
+        if ((Row >= 1 && Row <= settings.Rows) && (Column >= 1 && Column <= settings.Columns)) {return {Row,Column};}
+        return {0,0};
+    }
+
+    Responses::Input Parse(std::string input, const Config::Settings& settings) {
+        const std::map<std::string,std::pair<int,int>> DIRECTIONS = {
+            {"up", {-1,0}}, {"down", {1,0}}, {"left", {0,-1}}, {"right", {0,1}},
+        };
+        Responses::Input Response;
+        const std::string Command = splitPath(input,Response.Path);
+        if (Command == "save" || Command == "load") {
+            Response.Key = Response.Path.empty() ? States::Input::Bad
+                : Command == "save" ? States::Input::Save : States::Input::Load;
+            return Response;
+        }
+        std::vector<std::string> Tokens = split(input);
+        Response.Key = States::Input::Bad;
+        if (Tokens.size() == 1) {
+            const std::string& Key = Tokens[0];
+            if (Key == "quit" || Key == "q") {Response.Key = States::Input::Quit;}
+            else if (Key == "reset" || Key == "r") {Response.Key = States::Input::Reset;}
+            else if (Key == "undo" || Key == "u") {Response.Key = States::Input::Undo;}
+            else if (Key == "redo") {Response.Key = States::Input::Redo;}
+            else if (DIRECTIONS.count(Key)) {
+                Response.Key = States::Input::Pan;
+                Response.Tile = {DIRECTIONS.at(Key).first*13,DIRECTIONS.at(Key).second*13};
+            }
+        } else if (Tokens.size() == 2) {
+            const std::string& Key = Tokens[0];
+            if (DIRECTIONS.count(Key)) {
+                const int Count = std::isdigit((unsigned char)Tokens[1][0]) ? Coords::Parse(Tokens[1]) : 0;
+                Response.Key = Count ? States::Input::Pan : States::Input::Bad;
+                Response.Tile = {DIRECTIONS.at(Key).first*Count,DIRECTIONS.at(Key).second*Count};
+                return Response;
+            }
+            const std::pair<int,int> Tile = parseTile(Tokens[1],settings);
+            if (Tile == std::pair<int,int>(0,0)) {return Response;}
+            if (Key == "tap" || Key == "t") {Response.Key = States::Input::Tap;}
+            else if (Key == "flag" || Key == "f") {Response.Key = States::Input::Flag;}
+            else if (Key == "view" || Key == "v") {Response.Key = States::Input::View;}
+            if (Response.Key != States::Input::Bad) {Response.Tile = Tile;}
+        }
+        return Response;
+    }
+
+}
+
+/**
+ * Parses every line over and over, until at least ~20M characters have been read
+ *
+ * @param allocations: Output, allocations per line
+ *
+ * @return Average nanoseconds per line
+ */
+template <typename ParseFn>
+double benchParse(const std::vector<std::string>& lines, double& allocations, ParseFn parse) {
+    long long Characters = 0;
+    for (const std::string& Line : lines) {
+        Characters += Line.size();
+    }
+    const int Repeats = std::max<long long>(1,20000000/Characters);
+    const long long Before = Allocations;
+    long long Keys = 0;     // Kept so the parsing isn't optimised away
+
+    const auto Start = std::chrono::steady_clock::now();
+    for (int i = 0; i < Repeats; i++) {
+        for (const std::string& Line : lines) {
+            Keys += (int)parse(Line).Key;
+        }
+    }
+    const auto End = std::chrono::steady_clock::now();
+
+    const double Count = (double)Repeats*lines.size();
+    allocations = (Allocations - Before)/Count;
+    if (Keys < 0) {std::cout << Keys;}
+    return std::chrono::duration<double,std::nano>(End - Start).count()/Count;
+}
+
+int main() {
+    Config::Settings Settings;
+    Settings.Rows = 1000;
+    Settings.Columns = 1000;
+    std::mt19937 Rng(175);
+
+    // What gets typed, tiles in either form and either case, pans and one word commands
+    std::vector<std::string> Typed;
+    for (int i = 0; i < 1000; i++) {
+        const std::string Row = Coords::Label(1 + Rng()%1000);
+        const std::string Column = std::to_string(1 + Rng()%1000);
+        switch (Rng()%6) {
+            case 0: Typed.push_back("tap " + Row + ':' + Column); break;
+            case 1: Typed.push_back("F " + Column + ';' + Row); break;
+            case 2: Typed.push_back("  View   " + Row + ':' + Row + "  "); break;
+            case 3: Typed.push_back("down " + std::to_string(1 + Rng()%50)); break;
+            case 4: Typed.push_back(Rng()%2 ? "undo" : "R"); break;
+            default: Typed.push_back("taP " + Column + ':' + Column + " oops"); break;
+        }
+    }
+
+    // Pasted junk, where splitting off one word at a time gets slow
+    std::vector<std::string> Long;
+    for (const int Length : {100,1000,10000}) {
+        std::string Line;
+        while ((int)Line.size() < Length) {
+            Line += Rng()%3 ? "ab " : "  ";
+        }
+        Long.push_back(Line);
+    }
+
+    std::cout << std::left << std::setw(16) << "lines" << std::setw(26) << "split" << "in place\n";
+    const auto row = [&](const std::string& name, const std::vector<std::string>& lines) {
+        double Before, After;
+        const double Old = benchParse(lines,Before,[&](const std::string& line) {return Legacy::Parse(line,Settings);});
+        const double New = benchParse(lines,After,[&](const std::string& line) {return Input::Parse(line,Settings);});
+        std::stringstream Split;
+        Split << std::fixed << std::setprecision(1) << Old << " ns, " << Before << " allocs";
+        std::cout << std::fixed << std::setprecision(1) << std::setw(16) << name << std::setw(26) << Split.str()
+        << New << " ns, " << After << " allocs, " << Old/New << "x\n";
+    };
+    row("typed",Typed);
+    for (const std::string& Line : Long) {
+        row(std::to_string(Line.size()) + " chars",std::vector<std::string>(1,Line));
+    }
+}
@@ -0,0 +1,242 @@
+#include "output.hpp"
+#include "tiles.hpp"
+
+#include <iostream>
+#include <iomanip>
+#include <utility>
+#include <random>
+#include <chrono>
+#include <string>
+#include <vector>
+#include <queue>
+#include <map>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+// clang++ -std=c++11 -O2 -pthread -IHeaders -o binary/bench_output benchmarks/bench_output.cpp Sources/output.cpp Sources/screen.cpp Sources/tiles.cpp Sources/memory.cpp Sources/counts.cpp Sources/coords.cpp && ./binary/bench_output
+
+namespace Legacy {
+
+    // The per tile std::cout drawing output.cpp did before the screen model, kept as the baseline
+
+    const std::map<int,std::string> TILE_COLOURS = {
+        {1, "\033[38;5;26m"},
+        {2, "\033[38;5;22m"},
+        {3, "\033[38;5;196m"},
+        {4, "\033[38;5;226m"},
+        {5, "\033[38;5;126m"},
+        {6, "\033[38;5;6m"},
+        {7, "\033[38;5;99m"},
+        {8, "\033[38;5;245m"},
+    };
+
+    long long Bytes = 0;
+
+    inline std::string setCursor(int y, int x) {
+        return "\033[" + std::to_string(y) + ';' + std::to_string(x) + 'H';
+    }
+
+    // Writes like std::cout did, counting what went out
+    void put(const std::string& s) {
+        std::cout << s;
+        Bytes += s.size();
+    }
+
+    void Reset() {
+        for (int Row = 1; Row <= 26; Row++) {
+            for (int Column = 1; Column <= 26; Column++) {
+                put(setCursor(3 + Row,29 + Column*2));
+                put("-");
+            }
+        }
+        std::cout << std::flush;
+    }
+
+    void Reveal(const Responses::Tap& response) {
+        for (const auto& TileData : response.Tiles) {
+            put(setCursor(3 + TileData.first.first,29 + TileData.first.second*2));
+            if (TileData.second == 9)      {put("\033[38;5;196m▇\033[0m");}
+            else if (TileData.second == 0) {put("\033[38;5;245m.\033[0m");}
+            else {put(TILE_COLOURS.at(TileData.second) + std::to_string(TileData.second) + "\033[0m");}
+        }
+        std::cout << std::flush;
+    }
+
+    // The queue the log panel was redrawn from on every line once full
+    void Log(const std::string& message) {
+        static std::queue<std::string> Logs;
+
+        const char* FILLER = "                     ";
+        Logs.push(message);
+        if (Logs.size() > 22) {
+            Logs.pop();
+            std::queue<std::string> Temp = Logs;
+            while (!Temp.empty()) {
+                const std::string CursorPos = setCursor((22 - Temp.size()) + 1 + 8,3);
+                put(CursorPos + FILLER + CursorPos + Temp.front());
+                Temp.pop();
+            }
+        } else {
+            put(setCursor(Logs.size() + 8,3) + message);
+        }
+        std::cout << std::flush;
+    }
+
+}
+
+/**
+ * Logs alternating lines into a full log panel, a frame per line
+ *
+ * @param bytes: Output, bytes written per line
+ *
+ * @return Average microseconds per line
+ */
+template <typename LogFn>
+double benchLog(int lines, long long& bytes, LogFn log) {
+    for (int i = 0; i < 22; i++) {
+        log(States::Log::Tap);
+    }
+    bytes = 0;
+    const auto Start = std::chrono::steady_clock::now();
+    for (int i = 0; i < lines; i++) {
+        bytes += log(i%2 ? States::Log::Tap : States::Log::Bad);
+    }
+    bytes /= lines;
+    return std::chrono::duration<double,std::micro>(std::chrono::steady_clock::now() - Start).count()/lines;
+}
+
+/**
+ * Taps the middle of boards with few mines, so most taps open a large cascade, and draws each board being reset
+ * and then revealed
+ *
+ * @return Average microseconds per frame
+ */
+template <typename ResetFn, typename RevealFn>
+double benchFrames(int boards, long long& frames, ResetFn reset, RevealFn reveal) {
+    Config::Settings Settings;
+    Settings.Mines = 40;
+    Tiles::Board Board(Settings);
+    std::mt19937 Rng(175);
+
+    std::vector<Responses::Tap> Taps;
+    for (int i = 0; i < boards; i++) {
+        Board.generateBoard({13,13},Rng());
+        Taps.push_back(Board.Tap({13,13}));
+    }
+
+    frames = 0;
+    const auto Start = std::chrono::steady_clock::now();
+    for (const Responses::Tap& Tap : Taps) {
+        reset();
+        reveal(Tap);
+        frames += 2;
+    }
+    return std::chrono::duration<double,std::micro>(std::chrono::steady_clock::now() - Start).count()/frames;
+}
+
+/**
+ * Opens most of a board with one tap, then pans the window around it a frame at a time
+ *
+ * @param reveal: Output, microseconds to draw the tap
+ * @param bytes: Output, bytes per pan
+ *
+ * @return Average microseconds per pan
+ */
+double benchViewport(int rows, int columns, double& reveal, double& bytes) {
+    Config::Settings Settings;
+    Settings.Rows = rows;
+    Settings.Columns = columns;
+    Settings.Mines = (long long)rows*columns/1000 + 10;
+    Tiles::Board Board(Settings);
+    Board.generateBoard({rows/2,columns/2},175);
+    const Responses::Tap Tap = Board.Tap({rows/2,columns/2});
+
+    Output::Dashboard(Board);
+    Output::Flush();
+    auto Start = std::chrono::steady_clock::now();
+    Output::Follow({rows/2,columns/2});
+    Output::Reveal(Tap);
+    Output::Flush();
+    reveal = std::chrono::duration<double,std::micro>(std::chrono::steady_clock::now() - Start).count();
+
+    const int PANS = 20000;
+    const long long Before = Output::getMetrics().Bytes;
+    Start = std::chrono::steady_clock::now();
+    for (int i = 0; i < PANS; i++) {
+        Output::Pan(i%8 < 4 ? 1 : -1,i%16 < 8 ? 1 : -1);
+        Output::Flush();
+    }
+    bytes = (double)(Output::getMetrics().Bytes - Before)/PANS;
+    return std::chrono::duration<double,std::micro>(std::chrono::steady_clock::now() - Start).count()/PANS;
+}
+
+int main() {
+    const int BOARDS = 20000;
+    Config::Settings Settings;
+    Settings.Mines = 40;
+
+    // Frames go to /dev/null, results to the real stdout once they are done
+    const int Stdout = dup(STDOUT_FILENO);
+    const int Null = open("/dev/null",O_WRONLY);
+    dup2(Null,STDOUT_FILENO);
+
+    long long LegacyFrames;
+    const double Before = benchFrames(BOARDS,LegacyFrames,Legacy::Reset,Legacy::Reveal);
+    const long long LegacyBytes = Legacy::Bytes;
+
+    const Tiles::Board Classic(Settings);
+    Output::Dashboard(Classic);
+    Output::Flush();
+    const Screen::Metrics Dashboard = Output::getMetrics();
+    long long Frames;
+    const double After = benchFrames(BOARDS,Frames,
+        [] {Output::Reset(); Output::Flush();},
+        [](const Responses::Tap& tap) {Output::Reveal(tap); Output::Flush();});
+    const Screen::Metrics Metrics = Output::getMetrics();
+
+    const int LINES = 200000;
+    long long LogBytes[3];
+    const double LogTimes[3] = {
+        benchLog(LINES,LogBytes[0],[](States::Log key) {
+            const long long Before = Legacy::Bytes;
+            Legacy::Log(key == States::Log::Tap ? "Tapped Tile 'M:M'" : "Bad Input");
+            return Legacy::Bytes - Before;
+        }),
+        benchLog(LINES,LogBytes[1],[](States::Log key) {
+            Output::Log(key,{13,13});
+            return Output::Flush(), Output::getMetrics().LastBytes;
+        }),
+        benchLog(LINES,LogBytes[2],[](States::Log key) {
+            Output::Margins(true);
+            Output::Log(key,{13,13});
+            return Output::Flush(), Output::getMetrics().LastBytes;
+        }),
+    };
+
+    const int SIZES[3] = {100,1000,4000};
+    double PanTimes[3], RevealTimes[3], PanBytes[3];
+    for (int i = 0; i < 3; i++) {
+        PanTimes[i] = benchViewport(SIZES[i],SIZES[i],RevealTimes[i],PanBytes[i]);
+    }
+
+    dup2(Stdout,STDOUT_FILENO);
+    close(Null);
+    close(Stdout);
+
+    const long long Bytes = Metrics.Bytes - Dashboard.Bytes;
+    std::cout << std::fixed << std::setprecision(2)
+    << "per tile cout  : " << Before << " us/frame, " << (double)LegacyBytes/LegacyFrames << " bytes/frame\n"
+    << "frame diff     : " << After << " us/frame, " << (double)Bytes/Frames << " bytes/frame, "
+    << (double)(Metrics.Cells - Dashboard.Cells)/Frames << " cells/frame\n"
+    << "building+write : " << (Metrics.Seconds - Dashboard.Seconds)*1e6/Frames << " us/frame in Flush\n"
+    << "dashboard      : " << Dashboard.LastBytes << " bytes\n"
+    << "bytes saved    : " << 100 - 100.0*Bytes/LegacyBytes << "%\n"
+    << "log, queue     : " << LogTimes[0] << " us/line, " << LogBytes[0] << " bytes/line\n"
+    << "log, redrawn   : " << LogTimes[1] << " us/line, " << LogBytes[1] << " bytes/line\n"
+    << "log, scrolled  : " << LogTimes[2] << " us/line, " << LogBytes[2] << " bytes/line\n";
+    for (int i = 0; i < 3; i++) {
+        std::cout << "window " << std::setw(4) << SIZES[i] << 'x' << std::left << std::setw(4) << SIZES[i] << std::right
+        << ": " << PanTimes[i] << " us/pan, " << PanBytes[i] << " bytes/pan, tap drawn in " << RevealTimes[i] << " us\n";
+    }
+}
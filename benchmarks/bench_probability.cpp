@@ -0,0 +1,75 @@
+#include "probability.hpp"
+#include "tiles.hpp"
+
+#include <algorithm>
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <random>
+#include <chrono>
+
+// clang++ -std=c++11 -O2 -pthread -IHeaders -o binary/bench_probability benchmarks/bench_probability.cpp Sources/probability.cpp Sources/solver.cpp Sources/tiles.cpp Sources/memory.cpp Sources/counts.cpp && ./binary/bench_probability
+
+/**
+ * Plays boards by always tapping the tile least likely to be a mine, timing every computation
+ *
+ * @param boards: Number of boards to play
+ */
+void benchProbability(int rows, int columns, int mines, int threads, int boards) {
+    Config::Settings Settings;
+    Settings.Rows = rows;
+    Settings.Columns = columns;
+    Settings.Mines = mines;
+    Settings.Threads = threads;
+
+    std::mt19937 g(7);
+    Probability::Engine Engine;
+    long long Calls = 0;
+    int Won = 0;
+    double Seconds = 0;
+    double Slowest = 0;
+
+    for (int b = 0; b < boards; b++) {
+        Tiles::Board Board(Settings);
+        const std::pair<int,int> Start = {(rows + 1)/2,(columns + 1)/2};
+        Board.generateBoard(Start,g());
+        Responses::Tap TR = Board.Tap(Start);
+
+        while (TR.State == States::Game::Playon) {
+            const auto Begin = std::chrono::steady_clock::now();
+            const std::vector<double>& Chances = Engine.Compute(Board);
+            const double Taken = std::chrono::duration<double>(std::chrono::steady_clock::now() - Begin).count();
+            Seconds += Taken;
+            Slowest = std::max(Slowest,Taken);
+            Calls++;
+
+            int Best = -1;
+            for (int i = 0; i < rows*columns; i++) {
+                if (Board.tileRevealed({1 + i/columns,1 + i%columns})) {continue;}
+                if (Best < 0 || Chances[i] < Chances[Best]) {Best = i;}
+            }
+            TR = Board.Tap({1 + Best/columns,1 + Best%columns});
+        }
+        Won += TR.State == States::Game::Win;
+    }
+
+    const std::string Name = std::to_string(rows) + 'x' + std::to_string(columns) + '/' + std::to_string(mines);
+    std::cout << std::setw(14) << Name
+        << std::setw(10) << threads
+        << std::setw(10) << Calls
+        << std::setw(12) << std::setprecision(1) << Seconds/Calls*1e6
+        << std::setw(12) << std::setprecision(2) << Slowest*1e3
+        << std::setw(10) << std::setprecision(0) << 100.0*Won/boards << '\n';
+}
+
+int main() {
+    std::cout << std::left << std::fixed << std::setw(14) << "board" << std::setw(10) << "threads"
+        << std::setw(10) << "calls" << std::setw(12) << "us/call" << std::setw(12) << "max ms"
+        << std::setw(10) << "% won" << '\n';
+
+    for (int Threads : {1,4}) {
+        benchProbability(9,9,10,Threads,500);
+        benchProbability(16,30,99,Threads,100);
+        benchProbability(26,26,100,Threads,100);
+    }
+}
@@ -0,0 +1,65 @@
+#include "solver.hpp"
+#include "tiles.hpp"
+
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <random>
+#include <chrono>
+
+// clang++ -std=c++11 -O2 -pthread -IHeaders -o binary/bench_solver benchmarks/bench_solver.cpp Sources/solver.cpp Sources/tiles.cpp Sources/memory.cpp Sources/counts.cpp && ./binary/bench_solver
+
+/**
+ * Solves boards from the first tap until the solver gets stuck, solving again after every safe tile it finds
+ *
+ * @param boards: Number of boards to play
+ */
+void benchSolver(int rows, int columns, int mines, int boards) {
+    Config::Settings Settings;
+    Settings.Rows = rows;
+    Settings.Columns = columns;
+    Settings.Mines = mines;
+
+    std::mt19937 g(7);
+    Solver::Engine Solver;
+    long long Calls = 0;
+    long long Searched = 0;
+    int Cleared = 0;
+    double Seconds = 0;
+
+    for (int b = 0; b < boards; b++) {
+        Tiles::Board Board(Settings);
+        const std::pair<int,int> Start = {(rows + 1)/2,(columns + 1)/2};
+        Board.generateBoard(Start,g());
+        Board.Tap(Start);
+
+        while (true) {
+            const auto Begin = std::chrono::steady_clock::now();
+            const Solver::Result& Result = Solver.Solve(Board);
+            Seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - Begin).count();
+            Calls++;
+            Searched += Result.Searched;
+            if (Result.Safe.empty()) {break;}
+
+            Board.Tap(Result.Safe.front());
+        }
+        Cleared += Board.getRemaining() == mines;
+    }
+
+    const std::string Name = std::to_string(rows) + 'x' + std::to_string(columns) + '/' + std::to_string(mines);
+    std::cout << std::setw(14) << Name
+        << std::setw(10) << Calls
+        << std::setw(12) << std::setprecision(1) << Seconds/Calls*1e6
+        << std::setw(12) << std::setprecision(0) << 100.0*Searched/Calls
+        << std::setw(12) << 100.0*Cleared/boards << '\n';
+}
+
+int main() {
+    std::cout << std::left << std::fixed << std::setw(14) << "board" << std::setw(10) << "solves"
+        << std::setw(12) << "us/solve" << std::setw(12) << "% searched" << std::setw(12) << "% cleared" << '\n';
+
+    benchSolver(9,9,10,2000);
+    benchSolver(16,30,99,200);
+    benchSolver(26,26,100,200);
+    benchSolver(100,100,1500,5);
+}
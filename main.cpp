@@ -1,49 +1,282 @@
 #include "responses.hpp"
 #include "output.hpp"
+#include "render.hpp"
 #include "input.hpp"
-#include "tiles.hpp"
+#include "keyboard.hpp"
+#include "config.hpp"
+#include "game.hpp"
+#include "noguess.hpp"
+#include "replay.hpp"
+#include "pipeline.hpp"
 
-int main() {
-    Output::Dashboard();
-    Responses::SessionStats SessionStats = Responses::SessionStats();
+#include <iostream>
+#include <iomanip>
+#include <random>
+#include <memory>
+#include <chrono>
+#include <cstring>
+#include <thread>
+#include <string>
+#include <vector>
 
-    bool NewGame = true;
-    States::Game GameState = States::Game::Playon;
+namespace {
 
+    struct Options {
+        std::string Record;     // Recording to write the session to
+        std::string Replay;     // Recording to play back before taking input
+        std::string Renderer = "ansi";
+        bool Margins = false;   // The terminal supports left/right margins
+        bool Batch = false;     // Commands come from a script, not a player
+        bool Keys = false;      // Moves are made a key at a time, in raw mode
+        bool Pipeline = false;  // Input, the game and drawing each run on a thread of their own
+    };
+
+    void usage(const char* program) {
+        std::cerr
+        << "Usage: " << program
+        << " [--record FILE] [--replay FILE] [--render NAME] [--margins] [--batch | --keys] [--pipeline]\n"
+        << "  [board options]\n"
+        << "  --record writes every move to FILE, --replay plays FILE back at the speed it was played\n"
+        << "  --render picks how the game is shown (" << Render::Names() << ", default ansi)\n"
+        << "  --margins lets a terminal with left/right margins (DECLRMM) scroll the log itself, without it every new\n"
+        << "    log line repaints the whole log panel\n"
+        << "  --batch runs the commands on stdin back to back, draws only where they end up and prints commands/s\n"
+        << "  --keys plays with a cursor moved by the arrow keys, a key per move, and prints how long keys took\n"
+        << "  --pipeline reads, runs and draws commands on separate threads, and prints how long each stage took\n"
+        << "  A replay uses the board size it was recorded with\n";
+        Config::Usage(program);
+    }
+
+    /**
+     * Splits the game's own options from the board options, which are left for Config::Parse
+     *
+     * @return If every game option was valid
+     */
+    bool parseOptions(int argc, char* argv[], Options& options, std::vector<char*>& board_args) {
+        board_args.push_back(argv[0]);
+        for (int i = 1; i < argc; i++) {
+            const char* Arg = argv[i];
+            const char* Value = (i + 1 < argc) ? argv[i + 1] : nullptr;
+
+            std::string* Target;
+            if (!std::strcmp(Arg,"--margins")) {
+                options.Margins = true;
+                continue;
+            }
+            if (!std::strcmp(Arg,"--batch")) {
+                options.Batch = true;
+                continue;
+            }
+            if (!std::strcmp(Arg,"--keys")) {
+                options.Keys = true;
+                continue;
+            }
+            if (!std::strcmp(Arg,"--pipeline")) {
+                options.Pipeline = true;
+                continue;
+            }
+            if (!std::strcmp(Arg,"--record"))       {Target = &options.Record;}
+            else if (!std::strcmp(Arg,"--replay"))  {Target = &options.Replay;}
+            else if (!std::strcmp(Arg,"--render"))  {Target = &options.Renderer;}
+            else {
+                board_args.push_back(argv[i]);
+                continue;
+            }
+
+            if (Value == nullptr) {return false;}
+            *Target = Value;
+            i++;
+        }
+        // Keys are read from a terminal, a batch from a script. Keys draw the cursor as they are read, which the input
+        // stage of a pipeline can't
+        return !(options.Batch && options.Keys) && !(options.Pipeline && options.Keys);
+    }
+
+    /**
+     * Prints how fast a batch ran, to stderr so it stays out of what was drawn
+     *
+     * @param commands: Commands run
+     * @param start: When the first one was read
+     */
+    void report(long long commands, std::chrono::steady_clock::time_point start) {
+        const double Seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        std::cerr << commands << " commands in " << std::fixed << std::setprecision(3) << Seconds << " s, "
+        << std::setprecision(0) << commands/Seconds << " commands/s\n";
+    }
+
+    /**
+     * Prints how long keys took to show up on screen, from reading them to the end of the frame that showed them
+     *
+     * @param latency: Microseconds per key
+     */
+    void reportKeys(const Analytics::Histogram& latency) {
+        std::cerr << latency.Count() << " keys, drawn in " << latency.Percentile(50) << " us (median), "
+        << latency.Percentile(99) << " us (99%), " << latency.Max() << " us (max)\n";
+    }
+
+}
+
+int main(int argc, char* argv[]) {
+    Options Options;
+    std::vector<char*> BoardArgs;
+    Config::Settings Settings;
+    if (!parseOptions(argc,argv,Options,BoardArgs) || !Config::Parse(BoardArgs.size(),BoardArgs.data(),Settings)) {
+        usage(argv[0]);
+        return 1;
+    }
+    const std::unique_ptr<Render::Base> Backend = Render::Create(Options.Renderer);
+    if (!Backend) {
+        usage(argv[0]);
+        return 1;
+    }
+    if (Options.Keys && !isatty(STDIN_FILENO)) {
+        std::cerr << "--keys needs a terminal to read keys from\n";
+        return 1;
+    }
+
+    // A replay brings its own board, and the seed every board came from
+    std::unique_ptr<Replay::Reader> Playback;
+    if (!Options.Replay.empty()) {
+        Playback.reset(new Replay::Reader(Options.Replay));
+        if (!Playback->Valid()) {
+            std::cerr << "Can't read recording " << Options.Replay << '\n';
+            return 1;
+        }
+        const int Threads = Settings.Threads;
+        Settings = Playback->getSettings();
+        Settings.Threads = Threads;
+        Settings.Seed = Playback->getSeed();
+    }
+
+    Minesweeper::Game Game(Settings);
+    if (Settings.Seed || Playback) {Game.Reset(Settings.Seed);}
+
+    std::unique_ptr<Replay::Recorder> Recorder;
+    if (!Options.Record.empty()) {
+        Recorder.reset(new Replay::Recorder(Options.Record,Settings,Game.getSeed()));
+        if (!Recorder->Valid()) {
+            std::cerr << "Can't write recording " << Options.Record << '\n';
+            return 1;
+        }
+    }
+
+    // Boards are generated ahead of time, checking that they can be solved takes a while. Replayed boards come from
+    // their recorded seeds, so they don't need it
+    std::unique_ptr<NoGuess::Pool> Pool;
+    if (Settings.NoGuess && !Playback) {
+        Pool.reset(new NoGuess::Pool(Settings,std::random_device()()));
+        Game.usePool(Pool.get());
+    }
+
+    // A batch is only drawn once it has run, the screen model keeps just where every cell ended up
+    std::unique_ptr<Input::Reader> Script;
+    if (Options.Batch) {Script.reset(new Input::Reader(STDIN_FILENO));}
+    const std::chrono::steady_clock::time_point Start = std::chrono::steady_clock::now();
+    long long Commands = 0;
+
+    // Between keys the clock keeps ticking, timers run while the keyboard waits
+    std::unique_ptr<Keyboard::Commands> Keys;
+    std::chrono::steady_clock::time_point BoardStart;   // First tap of the board being played
+    if (Options.Keys) {
+        Keys.reset(new Keyboard::Commands(STDIN_FILENO,Settings));
+        Keys->getLoop().Every(std::chrono::milliseconds(250),[&] {
+            const auto Elapsed = std::chrono::steady_clock::now() - BoardStart;
+            if (!Game.Started()) {Backend->Clock(0);}
+            else if (!Game.Over()) {Backend->Clock(std::chrono::duration_cast<std::chrono::seconds>(Elapsed).count());}
+            Backend->Flush();
+        });
+    }
+
+    // Recorded moves come first, then the player or script takes over
+    const auto read = [&](Pipeline::Command& command, Render::Base& prompt) {
+        Replay::Event Next;
+        if (Playback && Playback->Next(Next)) {
+            if (!Script) {std::this_thread::sleep_for(std::chrono::milliseconds(Next.Delay));}
+            command.Starts = Next.Starts;
+            command.Seed = Next.Seed;
+            command.Input.Key = Next.Key;
+            command.Input.Tile = Next.Tile;
+        } else if (Keys) {
+            command.Input = Keys->Get(prompt);
+        } else if (Script) {
+            command.End = !Script->Next(Settings,command.Input);
+        } else {
+            command.Input = Input::Get(Settings,prompt);
+        }
+    };
+
+    // The engine stays on this thread. Prompts are drawn by the render thread, whenever it catches up
+    Render::Base Quiet;
+    std::unique_ptr<Pipeline::Stages> Pipe;
+    Render::Base* Renderer = Backend.get();
+    if (Options.Pipeline) {
+        Pipe.reset(new Pipeline::Stages(*Backend,[&](Pipeline::Command& command) {read(command,Quiet);},!Script));
+        Renderer = Pipe.get();
+    }
+
+    Output::Margins(Options.Margins);
+    Renderer->Dashboard(Game.getBoard());
     do {
-        const Responses::Input Response = Input::Get();
-        const std::pair<char,char> Tile = Response.Tile;
+        Pipeline::Command Command;
+        if (Pipe) {
+            Command = Pipe->Next();
+        } else {
+            if (!Script) {Renderer->Flush();}
+            read(Command,*Renderer);
+        }
+        if (Command.End) {
+            Renderer->Flush();
+            if (Pipe) {
+                Pipe->Stop();
+                Pipe->Report(std::cerr);
+            }
+            report(Commands,Start);
+            return 0;
+        }
+        if (Command.Starts) {Game.Reset(Command.Seed);}
+        Commands++;
+        const Responses::Input& Response = Command.Input;
+        const std::pair<int,int> Tile = Response.Tile;
         const States::Input Key = Response.Key;
 
-        if ((GameState != States::Game::Playon) && !(Key == States::Input::Reset || Key == States::Input::Quit)) {
-            Output::Log(States::Log::Failed,Tile);
+        // What gets recorded, for moves that changed the game
+        Replay::Event Event;
+        Event.Key = Key;
+        Event.Tile = Tile;
+        bool Record = false;
+
+        const bool Allowed = Key == States::Input::Reset || Key == States::Input::Undo
+            || Key == States::Input::Save || Key == States::Input::Load || Key == States::Input::Quit
+            || Key == States::Input::Pan || Key == States::Input::View;
+        if (Game.Over() && !Allowed) {
+            Renderer->Log(States::Log::Failed,Tile);
             continue;
         }
 
+        // A command that fails changes nothing, so it goes straight on to the next one without reporting the game again
         switch (Key) {
             case States::Input::Tap: {
-                if (NewGame) {
-                    NewGame = false;
-                    SessionStats.BoardsPlayed++;
-                    Tiles::generateBoard(Tile);
-                }
+                Event.Starts = !Game.Started();
+                if (Event.Starts) {BoardStart = std::chrono::steady_clock::now();}
+                const Responses::Tap TR = Game.Tap(Tile);
+                Renderer->Follow(Tile);
+                Renderer->Reveal(TR);
+                Renderer->Log(States::Log::Tap,Tile);
+                if (Event.Starts && Game.NeedsGuess()) {Renderer->Log(States::Log::Guess,Tile);}
 
-                const Responses::Tap TR = Tiles::Tap(Tile);
-                SessionStats.TilesRevealed += TR.Tiles.size();
-                GameState = TR.State;
-
-                Output::Reveal(TR);
-                Output::Log(States::Log::Tap,Tile);
+                Event.Seed = Game.getSeed();
+                Event.Check = Replay::Fingerprint(TR);
+                Record = true;
                 break;
             }
 
             case States::Input::Flag: {
-                if (NewGame) {
-                    Output::Log(States::Log::Failed,Tile);
-                    break;
+                if (!Game.Started()) {
+                    Renderer->Log(States::Log::Failed,Tile);
+                    continue;
                 }
 
-                const Responses::Flag FR = Tiles::Flag(Tile);
+                const Responses::Flag FR = Game.Flag(Tile);
 
                 States::Log LogState;
                 if (FR.State == States::Flag::Add) {
@@ -54,51 +287,114 @@ int main() {
                     LogState = States::Log::Flagfail;
                 }
 
-                Output::Flag(Tile,FR);
-                Output::Log(LogState,Tile);
+                Renderer->Follow(Tile);
+                Renderer->Flag(Tile,FR);
+                Renderer->Log(LogState,Tile);
+
+                Event.Check = Replay::Fingerprint(FR);
+                Record = true;
                 break;
             }
 
             case States::Input::Reset: {
-                if (NewGame) {
-                    Output::Log(States::Log::Failed,Tile);
-                    break;
+                if (!Game.Started()) {
+                    Renderer->Log(States::Log::Failed,Tile);
+                    continue;
+                }
+                if (!Game.Over()) {Renderer->Seed(Game.getSeed());}
+                Game.Reset();
+
+                Renderer->Reset();
+                Renderer->Log(States::Log::Reset,Tile);
+                Record = true;
+                break;
+            }
+
+            case States::Input::Undo:
+            case States::Input::Redo: {
+                Responses::Step SR;
+                const bool Undo = Key == States::Input::Undo;
+                if (!(Undo ? Game.Undo(SR) : Game.Redo(SR))) {
+                    Renderer->Log(States::Log::Failed,Tile);
+                    continue;
+                }
+
+                Renderer->Step(SR);
+                Renderer->Log(Undo ? States::Log::Undo : States::Log::Redo,Tile);
+
+                Event.Check = Replay::Fingerprint(SR);
+                Record = true;
+                break;
+            }
+
+            case States::Input::Save: {
+                Renderer->Log(Game.Save(Response.Path) ? States::Log::Save : States::Log::Failed,Tile);
+                break;
+            }
+
+            case States::Input::Load: {
+                Responses::Step SR;
+                if (!Game.Load(Response.Path,SR)) {
+                    Renderer->Log(States::Log::Failed,Tile);
+                    continue;
                 }
-                NewGame = true;
-                GameState = States::Game::Playon;
 
-                Output::Reset();
-                Output::Log(States::Log::Reset,Tile);
+                Renderer->Reset();
+                Renderer->Step(SR);
+                Renderer->Log(States::Log::Load,Tile);
+                BoardStart = std::chrono::steady_clock::now();
+
+                // What follows can't be replayed without the file, so the recording ends here
+                Recorder.reset();
+                break;
+            }
+
+            case States::Input::Pan: {
+                Renderer->Pan(Tile.first,Tile.second);
+                break;
+            }
+
+            case States::Input::View: {
+                Renderer->Centre(Tile);
                 break;
             }
 
             case States::Input::Bad: {
-                Output::Log(States::Log::Bad,Tile);
+                Renderer->Log(States::Log::Bad,Tile);
                 break;
             }
 
             case States::Input::Quit: {
-                Output::Quit(SessionStats);
+                Renderer->Quit(Game.getStats());
+                if (Pipe) {
+                    Pipe->Stop();
+                    Pipe->Report(std::cerr);
+                }
+                if (Script) {report(Commands,Start);}
+                if (Keys) {reportKeys(Keys->getLatency());}
                 return 0;
             }
         }
 
-        if (NewGame) {continue;}
+        if (Recorder && Record) {Recorder->Record(Event);}
+        if (!Game.Started() || Key == States::Input::Save || Key == States::Input::Pan || Key == States::Input::View) {
+            continue;
+        }
 
-        switch (GameState) {
+        switch (Game.getState()) {
             case States::Game::Playon: {
                 break; // Do nothing
             }
 
             case States::Game::Win: {
-                SessionStats.GamesWon++;
-                Output::Log(States::Log::Win,Tile);
+                Renderer->Log(States::Log::Win,Tile);
+                Renderer->Seed(Game.getSeed());
                 break;
             }
 
             case States::Game::Lose: {
-                SessionStats.GamesLost++;
-                Output::Log(States::Log::Lose,Tile);
+                Renderer->Log(States::Log::Lose,Tile);
+                Renderer->Seed(Game.getSeed());
                 break;
             }
         }
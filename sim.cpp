@@ -0,0 +1,206 @@
+#include "responses.hpp"
+#include "config.hpp"
+#include "policy.hpp"
+#include "game.hpp"
+#include "replay.hpp"
+
+#include <iostream>
+#include <iomanip>
+#include <cstdlib>
+#include <cstdint>
+#include <cstring>
+#include <chrono>
+#include <thread>
+#include <vector>
+#include <string>
+
+// Headless simulator, plays seeded games with a move policy on every core
+// clang++ -std=c++11 -O2 -pthread -IHeaders -o binary/minesweeper-sim sim.cpp Sources/policy.cpp Sources/probability.cpp Sources/solver.cpp Sources/game.cpp Sources/snapshot.cpp Sources/replay.cpp Sources/noguess.cpp Sources/tiles.cpp Sources/memory.cpp Sources/counts.cpp Sources/config.cpp
+
+namespace {
+
+    struct Options {
+        long long Games = 100000;
+        long long Seed = 1;
+        long long Jobs = std::max(1u,std::thread::hardware_concurrency());
+        std::string Policy = "random";
+        std::string Verify;     // Recording to check instead of simulating
+    };
+
+    struct Totals {
+        Responses::SessionStats Stats;
+        long long Moves = 0;
+        long long Unfinished = 0;   // Games cut off by the move limit, a stuck policy
+        long long Guessing = 0;     // No-guess boards that had to be dealt without the guarantee
+        long long Allocations = 0;  // From the board's arena, over every game
+        Memory::Stats Arena;
+    };
+
+    void usage(const char* program) {
+        std::cerr
+        << "Usage: " << program << " [-n GAMES] [-s SEED] [-j JOBS] [-p POLICY] [board options]\n"
+        << "       " << program << " --verify RECORDING [-t THREADS]\n"
+        << "  Policies: " << Policy::Names() << '\n';
+        Config::Usage(program);
+    }
+
+    inline bool matches(const char* arg, const char* short_name, const char* long_name) {
+        return !std::strcmp(arg,short_name) || !std::strcmp(arg,long_name);
+    }
+
+    /**
+     * Splits the simulator's own options from the board options, which are left for Config::Parse
+     *
+     * @return If every simulator option was valid
+     */
+    bool parseOptions(int argc, char* argv[], Options& options, std::vector<char*>& board_args) {
+        board_args.push_back(argv[0]);
+        for (int i = 1; i < argc; i++) {
+            const char* Arg = argv[i];
+            const char* Value = (i + 1 < argc) ? argv[i + 1] : nullptr;
+
+            if (matches(Arg,"-p","--policy") && Value) {
+                options.Policy = Value;
+                i++;
+                continue;
+            }
+            if (matches(Arg,"-v","--verify") && Value) {
+                options.Verify = Value;
+                i++;
+                continue;
+            }
+
+            long long* Target;
+            if (matches(Arg,"-n","--games"))     {Target = &options.Games;}
+            else if (matches(Arg,"-s","--seed")) {Target = &options.Seed;}
+            else if (matches(Arg,"-j","--jobs")) {Target = &options.Jobs;}
+            else {
+                board_args.push_back(argv[i]);
+                continue;
+            }
+
+            char* End;
+            if (Value == nullptr) {return false;}
+            *Target = std::strtoll(Value,&End,10);
+            if (*Value == '\0' || *End != '\0' || *Target < 0) {return false;}
+            i++;
+        }
+        return options.Jobs >= 1 && Policy::Create(options.Policy) != nullptr;
+    }
+
+    /**
+     * Plays every game whose number is job, job + jobs, job + 2*jobs, ...
+     *
+     * Each game number is also its seed offset, so results don't depend on how many jobs there are
+     */
+    void play(const Config::Settings& settings, const Options& options, int job, Totals& totals) {
+        Minesweeper::Game Game(settings,options.Seed);
+        std::unique_ptr<Policy::Base> Player = Policy::Create(options.Policy);
+        const long long MoveLimit = 2LL*settings.Rows*settings.Columns;
+        Responses::Tap Response;
+
+        for (long long i = job; i < options.Games; i += options.Jobs) {
+            const std::uint64_t Seed = options.Seed + i;
+            Game.Reset(Seed);
+            Player->Start(Seed);
+
+            long long Moves = 0;
+            while (!Game.Over() && Moves < MoveLimit) {
+                const Policy::Move Move = Player->Next(Game);
+                if (Move.Key == States::Input::Flag) {
+                    Game.Flag(Move.Tile);
+                } else {
+                    Game.Tap(Move.Tile,Response);
+                    if (!Moves) {totals.Guessing += Game.NeedsGuess();}
+                }
+                Moves++;
+            }
+
+            totals.Moves += Moves;
+            totals.Unfinished += !Game.Over();
+            totals.Allocations += Game.getMemory().Allocations;
+        }
+        totals.Stats = Game.getStats();
+        totals.Arena = Game.getMemory();
+    }
+
+    /**
+     * Plays a recording back headless, checking every response against the recorded one
+     *
+     * @return Exit code, 0 if every event matched
+     */
+    int verify(const Options& options, const Config::Settings& settings) {
+        const auto Start = std::chrono::steady_clock::now();
+        const Replay::Report Report = Replay::Verify(options.Verify,settings.Threads);
+        const double Seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - Start).count();
+
+        if (!Report.Valid) {
+            std::cerr << "Can't read recording " << options.Verify << '\n';
+            return 1;
+        }
+        std::cout << std::fixed << std::setprecision(2)
+        << "Recording        " << options.Verify << (Report.Complete ? "" : " (damaged, stopped early)") << '\n'
+        << "Events           " << Report.Events << '\n'
+        << "Seconds          " << Seconds << '\n'
+        << "Events/sec       " << Report.Events/std::max(Seconds,1e-9) << '\n'
+        << "Mismatches       " << Report.Mismatches;
+        if (Report.Mismatches) {std::cout << " (first at event " << Report.FirstMismatch << ')';}
+        std::cout << '\n';
+        return Report.Mismatches || !Report.Complete;
+    }
+
+}
+
+int main(int argc, char* argv[]) {
+    Options Options;
+    std::vector<char*> BoardArgs;
+    Config::Settings Settings;
+    if (!parseOptions(argc,argv,Options,BoardArgs) || !Config::Parse(BoardArgs.size(),BoardArgs.data(),Settings)) {
+        usage(argv[0]);
+        return 1;
+    }
+    if (!Options.Verify.empty()) {return verify(Options,Settings);}
+
+    std::vector<Totals> PerJob(Options.Jobs);
+    std::vector<std::thread> Jobs;
+
+    const auto Start = std::chrono::steady_clock::now();
+    for (int j = 0; j < Options.Jobs; j++) {
+        Jobs.emplace_back(play,std::cref(Settings),std::cref(Options),j,std::ref(PerJob[j]));
+    }
+    for (auto& Job : Jobs) {
+        Job.join();
+    }
+    const double Seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - Start).count();
+
+    Totals Total;
+    for (const Totals& Job : PerJob) {
+        Total.Stats.BoardsPlayed += Job.Stats.BoardsPlayed;
+        Total.Stats.GamesWon += Job.Stats.GamesWon;
+        Total.Stats.GamesLost += Job.Stats.GamesLost;
+        Total.Stats.TilesRevealed += Job.Stats.TilesRevealed;
+        Total.Moves += Job.Moves;
+        Total.Unfinished += Job.Unfinished;
+        Total.Guessing += Job.Guessing;
+        Total.Allocations += Job.Allocations;
+        Total.Arena.PeakBytes = std::max(Total.Arena.PeakBytes,Job.Arena.PeakBytes);
+        Total.Arena.Blocks += Job.Arena.Blocks;
+    }
+
+    const double Games = std::max<long long>(1,Options.Games);
+    std::cout << std::fixed << std::setprecision(2)
+    << "Board            " << Settings.Rows << 'x' << Settings.Columns << ", " << Settings.Mines << " mines\n"
+    << "Policy           " << Options.Policy << '\n'
+    << "Jobs             " << Options.Jobs << '\n'
+    << "Seconds          " << Seconds << '\n'
+    << "Games/sec        " << Options.Games/Seconds << '\n'
+    << "Boards Played    " << Total.Stats.BoardsPlayed << '\n'
+    << "Games Won        " << Total.Stats.GamesWon << " (" << 100.0*Total.Stats.GamesWon/Games << "%)\n"
+    << "Games Lost       " << Total.Stats.GamesLost << '\n'
+    << "Unfinished       " << Total.Unfinished << '\n'
+    << "Tiles Revealed   " << Total.Stats.TilesRevealed << " (" << Total.Stats.TilesRevealed/Games << " per game)\n"
+    << "Moves            " << Total.Moves << " (" << Total.Moves/Games << " per game)\n"
+    << "Arena            " << Total.Allocations/Games << " allocations and at most " << Total.Arena.PeakBytes
+    << " bytes per game, " << Total.Arena.Blocks << " heap blocks\n";
+    if (Settings.NoGuess) {std::cout << "Needs Guessing   " << Total.Guessing << " boards\n";}
+}
@@ -1,231 +1,1392 @@
+#include "tiles.hpp"
+#include "game.hpp"
+#include "coords.hpp"
+#include "config.hpp"
+#include "counts.hpp"
+#include "prng.hpp"
+#include "memory.hpp"
+#include "replay.hpp"
+#include "analytics.hpp"
+#include "screen.hpp"
+#include "input.hpp"
+#include "keyboard.hpp"
+#include "pipeline.hpp"
+
 #include <algorithm>
+#include <array>
+#include <string>
 #include <iostream>
+#include <cstdlib>  // For malloc, free
+#include <cmath>
+#include <cctype>
+#include <cstdio>   // For remove
+#include <fstream>
+#include <iterator>
+#include <new>
+#include <atomic>
 #include <utility>
+#include <cstdint>
 #include <random>
+#include <chrono>
+#include <thread>
 #include <vector>
-#include <stack>
-#include <map>
 #include <set>
+#include <map>
+
+#include <unistd.h>  // For pipe
+#include <fcntl.h>   // For open
+
+// clang++ -std=c++11 -pthread -IHeaders -o binary/test_board tests/test_board.cpp Sources/game.cpp Sources/snapshot.cpp Sources/replay.cpp Sources/analytics.cpp Sources/screen.cpp Sources/input.cpp Sources/keyboard.cpp Sources/pipeline.cpp Sources/noguess.cpp Sources/solver.cpp Sources/tiles.cpp Sources/memory.cpp Sources/counts.cpp Sources/coords.cpp Sources/config.cpp && ./binary/test_board
+
+int Failures = 0;
+std::mt19937 Rng(175);
+
+#define CHECK(condition) \
+    if (!(condition)) {std::cout << "FAILED " << __LINE__ << ": " #condition "\n"; Failures++;}
+
+// Every allocation the program makes, see TestAllocations. New and delete are kept out of line, so the compiler never
+// sees a pointer from one being freed by the other's malloc and free
+std::atomic<long long> Allocations(0);
+
+[[gnu::noinline]] void* operator new(std::size_t size) {
+    Allocations++;
+    if (void* Memory = std::malloc(size ? size : 1)) {return Memory;}
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size) {
+    return operator new(size);
+}
+
+// Every form of delete frees through the same pair as new, sized or not
+[[gnu::noinline]] void operator delete(void* memory) noexcept {
+    std::free(memory);
+}
 
-// clang++ -std=c++11 -o binary/test_board tests/test_board.cpp && ./binary/test_board
+void operator delete[](void* memory) noexcept {
+    operator delete(memory);
+}
+
+void operator delete(void* memory, std::size_t size) noexcept {
+    (void)size;
+    operator delete(memory);
+}
 
-struct {
-    std::map<std::pair<char,char>,int> Tiles;
-    std::set<std::pair<char,char>> Mines;
-    std::set<std::pair<char,char>> Revealed;
+void operator delete[](void* memory, std::size_t size) noexcept {
+    (void)size;
+    operator delete(memory);
+}
 
-    void generateMines(
-        std::vector<std::pair<char,char>>& all_tiles,
-        const std::set<std::pair<char,char>>& safe_tiles
-    ) {
-        int Converted = 0;
+namespace Legacy {
 
-        std::mt19937 g(175); // Set Seed
-        std::shuffle(all_tiles.begin(),all_tiles.end(),g);
+    // The split() based parser input.cpp had before it read words in place, kept to fuzz the new one against
 
-        for (const auto Tile : all_tiles) {
-            if (safe_tiles.find(Tile) == safe_tiles.end()) {
-                Mines.insert(Tile);
-                Converted++;
+    std::vector<std::string> split(std::string& s, const char delimiter = ' ') {
+        std::vector<std::string> Strings;
+        size_t Position = 0;
+        std::string Str;
+        while ((Position = s.find(delimiter)) != std::string::npos) {
+            Str = s.substr(0,Position);
+            if (Str.size() >= 1) {
+                std::transform(Str.begin(),Str.end(),Str.begin(),[](unsigned char c){return std::tolower(c);});
+                Strings.push_back(Str);
             }
-            if (Converted == 100) {break;}
+            s.erase(0,Position + 1);
         }
+        if (s.size() >= 1) {
+            std::transform(s.begin(),s.end(),s.begin(),[](unsigned char c){return std::tolower(c);});
+            Strings.push_back(s);
+        }
+        return Strings;
     }
 
-    void setTiles(const std::vector<std::pair<char,char>>& all_tiles) {
-        for (const auto& Tile : all_tiles) {
+    std::string splitPath(const std::string& input, std::string& path) {
+        const size_t Start = input.find_first_not_of(' ');
+        if (Start == std::string::npos) {return "";}
+        const size_t End = input.find(' ',Start);
+        std::string Key = input.substr(Start,End - Start);
+        std::transform(Key.begin(),Key.end(),Key.begin(),[](unsigned char c){return std::tolower(c);});
+        const size_t First = End == std::string::npos ? End : input.find_first_not_of(' ',End);
+        const size_t Last = input.find_last_not_of(' ');
+        path = First == std::string::npos ? "" : input.substr(First,Last + 1 - First);
+        return Key;
+    }
 
-            if (Mines.find(Tile) != Mines.end()) {
-                Tiles[Tile] = 9;
-                continue;
+    std::pair<int,int> parseTile(std::string& tile, const Config::Settings& settings) {
+        std::vector<std::string> Tokens = split(tile,':');
+        if (Tokens.size() != 2) {
+            Tokens = split(tile,';');
+            if (Tokens.size() != 2) {return {0,0};}
+        }
+        const int Row = Coords::Parse(Tokens[0]);
+        const int Column = Coords::Parse(Tokens[1]);
+        if ((Row >= 1 && Row <= settings.Rows) && (Column >= 1 && Column <= settings.Columns)) {return {Row,Column};}
+        return {0,0};
+    }
+
+    Responses::Input Parse(std::string input, const Config::Settings& settings) {
+        const std::map<std::string,std::pair<int,int>> DIRECTIONS = {
+            {"up", {-1,0}}, {"down", {1,0}}, {"left", {0,-1}}, {"right", {0,1}},
+        };
+        Responses::Input Response;
+        const std::string Command = splitPath(input,Response.Path);
+        if (Command == "save" || Command == "load") {
+            Response.Key = Response.Path.empty() ? States::Input::Bad
+                : Command == "save" ? States::Input::Save : States::Input::Load;
+            return Response;
+        }
+        std::vector<std::string> Tokens = split(input);
+        Response.Key = States::Input::Bad;
+        if (Tokens.size() == 1) {
+            const std::string& Key = Tokens[0];
+            if (Key == "quit" || Key == "q") {Response.Key = States::Input::Quit;}
+            else if (Key == "reset" || Key == "r") {Response.Key = States::Input::Reset;}
+            else if (Key == "undo" || Key == "u") {Response.Key = States::Input::Undo;}
+            else if (Key == "redo") {Response.Key = States::Input::Redo;}
+            else if (DIRECTIONS.count(Key)) {
+                Response.Key = States::Input::Pan;
+                Response.Tile = {DIRECTIONS.at(Key).first*13,DIRECTIONS.at(Key).second*13};
             }
+        } else if (Tokens.size() == 2) {
+            const std::string& Key = Tokens[0];
+            if (DIRECTIONS.count(Key)) {
+                const int Count = std::isdigit((unsigned char)Tokens[1][0]) ? Coords::Parse(Tokens[1]) : 0;
+                Response.Key = Count ? States::Input::Pan : States::Input::Bad;
+                Response.Tile = {DIRECTIONS.at(Key).first*Count,DIRECTIONS.at(Key).second*Count};
+                return Response;
+            }
+            const std::pair<int,int> Tile = parseTile(Tokens[1],settings);
+            if (Tile == std::pair<int,int>(0,0)) {return Response;}
+            if (Key == "tap" || Key == "t") {Response.Key = States::Input::Tap;}
+            else if (Key == "flag" || Key == "f") {Response.Key = States::Input::Flag;}
+            else if (Key == "view" || Key == "v") {Response.Key = States::Input::View;}
+            if (Response.Key != States::Input::Bad) {Response.Tile = Tile;}
+        }
+        return Response;
+    }
+
+}
+
+void TestCoords() {
+    CHECK(Coords::Label(1) == "A");
+    CHECK(Coords::Label(26) == "Z");
+    CHECK(Coords::Label(27) == "AA");
+    CHECK(Coords::Label(702) == "ZZ");
+    CHECK(Coords::Label(703) == "AAA");
+
+    for (int n = 1; n <= 100000; n++) {
+        if (Coords::Parse(Coords::Label(n)) != n) {
+            CHECK(Coords::Parse(Coords::Label(n)) == n);
+            break;
+        }
+    }
 
-            int MinesFound = 0;
-            int Row = (Tile.first - 64) - 1;
-            int Column = (Tile.second - 64) - 1;
-            for (int i = 1; i <= 9; i++) {
-                if ((Row > 0 && Row <= 26) && (Column > 0 && Column <= 26) && (i != 5)) {
+    CHECK(Coords::Parse("aa") == 27);
+    CHECK(Coords::Parse("123") == 123);
+    CHECK(Coords::Parse("") == 0);
+    CHECK(Coords::Parse("A1") == 0);
+    CHECK(Coords::Parse("1A") == 0);
+    CHECK(Coords::Parse("99999999999") == 0);
+}
+
+/**
+ * Checks every mine counting kernel against a per tile neighbour probe
+ */
+void TestCounts() {
+    std::mt19937 g(175);
+    for (int i = 0; i < 500; i++) {
+        const int Rows = 1 + g()%70;
+        const int Columns = 1 + g()%150;
+        std::vector<unsigned char> Mines(Rows*Columns);
+        std::vector<unsigned char> Counts(Rows*Columns);
+        for (auto& Mine : Mines) {
+            Mine = g()%4 == 0;
+        }
+
+        for (int k = 0; k <= 2; k++) {
+            Counts::Compute(Mines.data(),Counts.data(),Rows,Columns,(Counts::Kernel)k);
 
-                    const std::pair<char,char> AdjacentTile = {64 + Row,64 + Column};
-                    if (Mines.find(AdjacentTile) != Mines.end()) {
-                        MinesFound++;
+            int Mismatches = 0;
+            for (int Row = 0; Row < Rows; Row++) {
+                for (int Column = 0; Column < Columns; Column++) {
+                    int Adjacent = 0;
+                    for (int r = Row - 1; r <= Row + 1; r++) {
+                        for (int c = Column - 1; c <= Column + 1; c++) {
+                            if ((r != Row || c != Column) && r >= 0 && r < Rows && c >= 0 && c < Columns) {
+                                Adjacent += Mines[r*Columns + c];
+                            }
+                        }
                     }
+                    Mismatches += Counts[Row*Columns + Column] != Adjacent;
                 }
-                if (i%3==0) {
-                    Column -= 2;
-                    Row++;
+            }
+            CHECK(Mismatches == 0);
+        }
+    }
+}
+
+int adjacentMines(const std::pair<int,int>& tile, const std::set<std::pair<int,int>>& mines) {
+    int Adjacent = 0;
+    for (int r = -1; r <= 1; r++) {
+        for (int c = -1; c <= 1; c++) {
+            Adjacent += mines.count({tile.first + r,tile.second + c});
+        }
+    }
+    return Adjacent;
+}
+
+/**
+ * Works out which tiles a tap should give back, the same way the original depth first cascade did
+ */
+std::set<std::pair<int,int>> expectedReveal(
+    const std::pair<int,int>& tile,
+    const std::set<std::pair<int,int>>& mines,
+    const std::set<std::pair<int,int>>& revealed,
+    const Config::Settings& settings
+) {
+    std::set<std::pair<int,int>> Expected = {tile};
+    if (revealed.count(tile) || adjacentMines(tile,mines) != 0) {return Expected;}
+
+    std::vector<std::pair<int,int>> Stack = {tile};
+    while (!Stack.empty()) {
+        const std::pair<int,int> Current = Stack.back();
+        Stack.pop_back();
+        for (int r = -1; r <= 1; r++) {
+            for (int c = -1; c <= 1; c++) {
+                const std::pair<int,int> Adjacent = {Current.first + r,Current.second + c};
+                if (Adjacent.first < 1 || Adjacent.first > settings.Rows ||
+                    Adjacent.second < 1 || Adjacent.second > settings.Columns ||
+                    revealed.count(Adjacent) || !Expected.insert(Adjacent).second) {continue;}
+
+                if (adjacentMines(Adjacent,mines) == 0) {Stack.push_back(Adjacent);}
+            }
+        }
+    }
+    return Expected;
+}
+
+/**
+ * Plays a full game on a board and checks every response against the mine layout
+ *
+ * The layout is found by deliberately tapping a mine, which reveals every mine without changing the board
+ */
+void TestBoard(const Config::Settings& settings, const std::pair<int,int>& safe_tile) {
+    Tiles::Board Board(settings);
+    Board.generateBoard(safe_tile,Rng());
+
+    // The safe tile is never a mine, and neither are its neighbours
+    Responses::Tap TR = Board.Tap(safe_tile);
+    CHECK(TR.State != States::Game::Lose);
+    CHECK(TR.NumTilesLeft == settings.Rows*settings.Columns - (int)TR.Tiles.size());
+
+    std::set<std::pair<int,int>> Revealed;
+    for (const auto& TileData : TR.Tiles) {
+        Revealed.insert(TileData.first);
+    }
+    CHECK(Revealed.size() == TR.Tiles.size());
+    const std::set<std::pair<int,int>> Opening = Revealed;
+
+    // Find a mine to learn the layout
+    std::set<std::pair<int,int>> Mines;
+    for (int Row = 1; Row <= settings.Rows && Mines.empty(); Row++) {
+        for (int Column = 1; Column <= settings.Columns && Mines.empty(); Column++) {
+            if (Revealed.count({Row,Column})) {continue;}
+
+            const Responses::Tap Probe = Board.Tap({Row,Column});
+            for (const auto& TileData : Probe.Tiles) {
+                if (Probe.State == States::Game::Lose) {
+                    CHECK(TileData.second == 9);
+                    Mines.insert(TileData.first);
                 } else {
-                    Column++;
+                    Revealed.insert(TileData.first);
                 }
             }
+        }
+    }
+    CHECK((int)Mines.size() == settings.Mines);
+    CHECK(Opening == expectedReveal(safe_tile,Mines,{},settings));
+
+    for (int r = -1; r <= 1; r++) {
+        for (int c = -1; c <= 1; c++) {
+            CHECK(Mines.count({safe_tile.first + r,safe_tile.second + c}) == 0);
+        }
+    }
+
+    // Flagging
+    const std::pair<int,int> Mine = *Mines.begin();
+    CHECK(Board.Flag(*Revealed.begin()).State == States::Flag::Nothing);
+    CHECK(Board.Flag(Mine).State == States::Flag::Add);
+    CHECK(Board.Tap(Mine).State == States::Game::Playon);
+    CHECK(Board.Flag(Mine).State == States::Flag::Remove);
+
+    // Tap every safe tile, every reported number must match the layout
+    for (int Row = 1; Row <= settings.Rows; Row++) {
+        for (int Column = 1; Column <= settings.Columns; Column++) {
+            if (Mines.count({Row,Column}) || TR.State == States::Game::Win) {continue;}
 
-            Tiles[Tile] = MinesFound;
+            const std::set<std::pair<int,int>> Expected = expectedReveal({Row,Column},Mines,Revealed,settings);
+            std::set<std::pair<int,int>> Tapped;
+
+            TR = Board.Tap({Row,Column});
+            CHECK(TR.State != States::Game::Lose);
+            for (const auto& TileData : TR.Tiles) {
+                CHECK(TileData.second == adjacentMines(TileData.first,Mines));
+                Tapped.insert(TileData.first);
+                Revealed.insert(TileData.first);
+            }
+            CHECK(Tapped == Expected);
+            CHECK(Tapped.size() == TR.Tiles.size());
         }
     }
+    CHECK(TR.State == States::Game::Win);
+    CHECK(TR.NumTilesLeft == settings.Mines);
+    CHECK((int)Revealed.size() == settings.Rows*settings.Columns - settings.Mines);
+}
+
+/**
+ * Checks that a cascade clears false flags and gives back the flag count
+ */
+void TestFalseFlag() {
+    Config::Settings Settings;
+    Settings.Rows = 30;
+    Settings.Columns = 30;
+    Settings.Mines = 1;
+    Tiles::Board Board(Settings);
+    Board.generateBoard({1,1},Rng());
+
+    // With a single mine a cascade from the corner reveals everything except the mine, and any edge tiles
+    // it cuts off from the blank tiles (at most 3 in a corner)
+    const std::pair<int,int> Flags[] = {{30,30},{15,15}};
+    CHECK(Board.Flag(Flags[0]).NumFlags == 1);
+    CHECK(Board.Flag(Flags[1]).NumFlags == 2);
+    const Responses::Tap TR = Board.Tap({1,1});
+    CHECK(TR.NumTilesLeft <= 4);
+    CHECK((int)TR.Tiles.size() == 30*30 - TR.NumTilesLeft);
+    CHECK((TR.State == States::Game::Win) == (TR.NumTilesLeft == 1));
+
+    // Revealed tiles can't be flagged, so only flags left on unrevealed tiles can still be removed
+    int StillFlagged = 0;
+    for (const auto& Flag : Flags) {
+        StillFlagged += Board.Flag(Flag).State == States::Flag::Remove;
+    }
+    CHECK(TR.NumFlags == StillFlagged);
+}
 
-} Board;
+/**
+ * Checks that a step lists exactly the tiles whose view changed, with what they show now
+ */
+void CheckStep(
+    const Responses::Step& step, const Tiles::Board& board,
+    const std::vector<signed char>& before, const std::vector<signed char>& after
+) {
+    const int Columns = board.getSettings().Columns;
+    std::set<int> Listed;
+    for (const auto& Tile : step.Tiles) {
+        const int Index = (Tile.first.first - 1)*Columns + Tile.first.second - 1;
+        Listed.insert(Index);
+        if (step.State != States::Game::Lose) {CHECK(Tile.second == after[Index]);}
+    }
+    for (int i = 0; i < (int)after.size(); i++) {
+        if (before[i] != after[i]) {CHECK(Listed.count(i));}
+    }
+    CHECK(step.NumTilesLeft == board.getRemaining());
+    CHECK(step.NumFlags == board.getNumFlags());
+}
 
-std::vector<std::pair<char,char>> getAllTiles() {
-    std::vector<std::pair<char,char>> AllTiles;
-    AllTiles.reserve(676);
+/**
+ * Plays random taps and flags, then undoes every move and redoes them all, checking that the board goes back
+ * through exactly the same views and counts
+ *
+ * @param settings: Board settings
+ * @param flags: Flags placed before the first tap, so that cascades have some to clear
+ */
+void TestUndo(const Config::Settings& settings, int flags) {
+    Tiles::Board Board(settings);
+    const std::pair<int,int> Start = {1 + Rng()%settings.Rows,1 + Rng()%settings.Columns};
+    Board.generateBoard(Start,Rng());
+    std::uniform_int_distribution<int> Row(1,settings.Rows), Column(1,settings.Columns);
 
-    int Row = 1;
-    int Column = 1;
-    for (int i = 1; i <= 676; i++) {
-        const std::pair<char,char> Tile = {64 + Row,64 + Column};
-        AllTiles.push_back(Tile);
+    std::vector<std::vector<signed char>> Views(1);
+    std::vector<std::pair<int,int>> Counts = {{Board.getRemaining(),Board.getNumFlags()}};
+    Board.getView(Views.back());
 
-        if (i%26==0) {
-            Row++;
-            Column = 1;
+    // Moves that change nothing aren't logged, so only snapshot the ones that do
+    auto play = [&](bool flag, const std::pair<int,int>& tile) {
+        States::Game State = States::Game::Playon;
+        if (flag) {
+            if (Board.Flag(tile).State == States::Flag::Nothing) {return State;}
         } else {
-            Column++;
+            if (Board.tileRevealed(tile) || Board.tileFlagged(tile)) {return State;}
+            State = Board.Tap(tile).State;
         }
+        Views.emplace_back();
+        Board.getView(Views.back());
+        Counts.push_back({Board.getRemaining(),Board.getNumFlags()});
+        return State;
+    };
+
+    for (int i = 0; i < flags; i++) {
+        play(true,{Row(Rng),Column(Rng)});
+    }
+    States::Game State = play(false,Start);
+    for (int Move = 0; Move < 200 && State == States::Game::Playon; Move++) {
+        State = play(Rng()%4 == 0,{Row(Rng),Column(Rng)});
+    }
+
+    Responses::Step Step;
+    std::vector<signed char> View;
+    for (int i = Views.size() - 1; i > 0; i--) {
+        CHECK(Board.Undo(Step));
+        CHECK(Step.State == States::Game::Playon);
+        Board.getView(View);
+        CHECK(View == Views[i - 1]);
+        CHECK(Counts[i - 1] == std::make_pair(Board.getRemaining(),Board.getNumFlags()));
+        CheckStep(Step,Board,Views[i],View);
+        if (Failures) {return;}
+    }
+    CHECK(!Board.Undo(Step));
+
+    for (int i = 1; i < (int)Views.size(); i++) {
+        CHECK(Board.Redo(Step));
+        Board.getView(View);
+        CHECK(View == Views[i]);
+        CHECK(Counts[i] == std::make_pair(Board.getRemaining(),Board.getNumFlags()));
+        CheckStep(Step,Board,Views[i - 1],View);
+        if (Failures) {return;}
+    }
+    CHECK(!Board.Redo(Step));
+    CHECK(Step.State == State);
+
+    // A new move drops every undone one
+    if (Views.size() > 2) {
+        CHECK(Board.Undo(Step) && Board.Undo(Step) && Board.Redo(Step));
+        Board.getView(View);
+        const int Hidden = std::find(View.begin(),View.end(),Tiles::HIDDEN) - View.begin();
+        CHECK(Board.Flag({1 + Hidden/settings.Columns,1 + Hidden%settings.Columns}).State == States::Flag::Add);
+        CHECK(!Board.Redo(Step));
+        CHECK(Board.Undo(Step));
+        Board.getView(View);
+        CHECK(View == Views[Views.size() - 2]);
     }
-    return AllTiles;
 }
 
-std::set<std::pair<char,char>> getSafeTiles(const std::pair<char,char> safe_tile) {
-    std::set<std::pair<char,char>> SafeTiles = {safe_tile};
-    int Row = (safe_tile.first - 64) - 1;
-    int Column = (safe_tile.second - 64) - 1;
-    for (int i = 1; i <= 9; i++) {
-        if ((Row > 0 && Row <= 26) && (Column > 0 && Column <= 26) && (i != 5)) {
-            const std::pair<char,char> SafeTile = {64 + Row,64 + Column};
-            SafeTiles.insert(SafeTile);
+/**
+ * Checks mine placement: the right number of mines, never near the first tap, every tile equally likely, and the
+ * same board every time for the same seed
+ */
+void TestSeeds() {
+    // Every tile outside the safe area is a mine
+    Config::Settings Full;
+    Full.Rows = 4;
+    Full.Columns = 4;
+    Full.Mines = 12;
+    Tiles::Board Board(Full);
+    Board.generateBoard({1,1},Rng());
+    CHECK(Board.getMines() == Memory::Buffer<int>({2,3,6,7,8,9,10,11,12,13,14,15}));
+
+    // Each of the 16 tiles away from the first tap is a mine in 4/16 of the boards
+    Config::Settings Small;
+    Small.Rows = 5;
+    Small.Columns = 5;
+    Small.Mines = 4;
+    const int BOARDS = 20000;
+    std::vector<int> Hits(25,0);
+    Tiles::Board Sample(Small);
+    for (int b = 0; b < BOARDS; b++) {
+        Sample.generateBoard({3,2},Rng());
+        const Memory::Buffer<int>& Mines = Sample.getMines();
+        CHECK((int)Mines.size() == Small.Mines);
+        CHECK(std::is_sorted(Mines.begin(),Mines.end()));
+        CHECK(std::adjacent_find(Mines.begin(),Mines.end()) == Mines.end());
+        for (const int Mine : Mines) {
+            Hits[Mine]++;
         }
-        if (i%3==0) {
-            Row++;
-            Column -= 2;
+        if (Failures) {return;}
+    }
+    for (int i = 0; i < 25; i++) {
+        const bool Safe = i/5 >= 1 && i/5 <= 3 && i%5 <= 2;
+        if (Safe) {
+            CHECK(Hits[i] == 0);
         } else {
-            Column++;
+            CHECK(Hits[i] > BOARDS/4*0.95 && Hits[i] < BOARDS/4*1.05);
         }
     }
-    return SafeTiles;
-}
 
-struct TapResponse {
-    std::vector<std::pair<std::pair<char,char>,int>> Tiles;
-    char GameState;
-};
+    // Same seed and first tap, same board
+    Config::Settings Classic;
+    Tiles::Board First(Classic);
+    Tiles::Board Second(Classic);
+    First.generateBoard({5,20},42);
+    Second.generateBoard({5,20},42);
+    CHECK(First.getMines() == Second.getMines());
+    Second.generateBoard({5,20},43);
+    CHECK(First.getMines() != Second.getMines());
 
-TapResponse Tap(const std::pair<char,char>& tapped_tile) {
+    // A game's seeds replay its boards, and resetting moves on to a new seed
+    Minesweeper::Game Game(Classic);
+    Game.Tap({13,13});
+    const std::uint64_t Seed = Game.getSeed();
+    const Memory::Buffer<int> Mines = Game.getBoard().getMines();
+    Game.Reset();
+    CHECK(Game.getSeed() != Seed);
+    Game.Tap({13,13});
+    CHECK(Game.getBoard().getMines() != Mines);
 
-    TapResponse Response;
+    Minesweeper::Game Replay(Classic,Seed);
+    Replay.Tap({13,13});
+    CHECK(Replay.getBoard().getMines() == Mines);
+    Game.Reset(Seed);
+    Game.Tap({13,13});
+    CHECK(Game.getBoard().getMines() == Mines);
 
-    // Tile is a mine
-    if (Board.Tiles[tapped_tile] == 9) {
-        for (const auto& Tile : Board.Mines) {
-            Response.Tiles.push_back({Tile,9});
+    // Bounded draws never reach the bound
+    Prng::Generator Generator(175);
+    for (std::uint32_t Bound = 1; Bound < 1000; Bound++) {
+        CHECK(Generator.Below(Bound) < Bound);
+    }
+}
+
+/**
+ * Plays games through the caller owned response, which shouldn't allocate at all once everything has grown to fit
+ */
+void TestAllocations() {
+    Config::Settings Settings;
+    Minesweeper::Game Game(Settings,175);
+    Responses::Tap Response;
+    Response.Tiles.reserve(Settings.Rows*Settings.Columns);
+    Prng::Generator Moves(175);
+
+    auto play = [&](int games) {
+        for (int g = 0; g < games; g++) {
+            Game.Reset();
+            Game.Tap({1 + Moves.Below(Settings.Rows),1 + Moves.Below(Settings.Columns)},Response);
+            while (!Game.Over()) {
+                const std::pair<int,int> Tile = {1 + Moves.Below(Settings.Rows),1 + Moves.Below(Settings.Columns)};
+                Game.Flag(Tile);
+                Game.Flag(Tile);
+                Game.Tap(Tile,Response);
+            }
         }
-        Response.GameState = 'X';
-        return Response;
+    };
+
+    play(100);
+    const long long Before = Allocations;
+    const Memory::Stats Warm = Game.getMemory();
+    play(1000);
+    CHECK(Allocations == Before);
+    CHECK(Game.getStats().BoardsPlayed == 1100);
+
+    // Every reset only rewinds the board's arena, which never needs much more than the grid and mine plane
+    CHECK(Game.getMemory().Blocks == Warm.Blocks);
+    CHECK(Game.getMemory().PeakBytes < 3*Settings.Rows*Settings.Columns);
+}
+
+/**
+ * Checks that arenas align what they hand out, and merge their blocks on reset
+ */
+void TestArena() {
+    Memory::Arena Arena;
+    for (int i = 0; i < 100; i++) {
+        Arena.Allocate(1 + i%7,1);
+        const void* Aligned = Arena.Allocate(1000,64);
+        CHECK(reinterpret_cast<std::size_t>(Aligned)%64 == 0);
     }
+    CHECK(Arena.getStats().Allocations == 200);
+    CHECK(Arena.getStats().Blocks > 1);
 
-    // Tile has at least 1 adjacent mine
-    else if (Board.Tiles[tapped_tile] != 0) {
-        Board.Revealed.insert(tapped_tile);
-        const int AdjacentMines = Board.Tiles[tapped_tile];
-        Response.Tiles.push_back({tapped_tile,AdjacentMines});
-        if (Board.Revealed.size() == 676 - 100) {
-            Response.GameState = 'F';
-        } else {
-            Response.GameState = 'O';
+    Arena.Reset();
+    const long long Blocks = Arena.getStats().Blocks;
+    CHECK(Arena.getStats().Allocations == 0 && Arena.getStats().Bytes == 0);
+    for (int i = 0; i < 100; i++) {
+        Arena.Allocate(1 + i%7,1);
+        Arena.Allocate(1000,64);
+    }
+    CHECK(Arena.getStats().Blocks == Blocks);
+    CHECK(Arena.getStats().Bytes >= 100*1000 && Arena.getStats().PeakBytes >= Arena.getStats().Bytes);
+}
+
+/**
+ * Plays a seeded game by tapping every tile in order until it's over
+ *
+ * @return Stats of the game
+ */
+Responses::SessionStats playGame(unsigned seed) {
+    Config::Settings Settings;
+    Minesweeper::Game Game(Settings,seed);
+    for (int Row = 1; Row <= Settings.Rows && !Game.Over(); Row++) {
+        for (int Column = 1; Column <= Settings.Columns && !Game.Over(); Column++) {
+            Game.Tap({Row,Column});
         }
+    }
+    return Game.getStats();
+}
 
-        return Response;
+/**
+ * Checks that games are independent of each other, even when played at the same time on different threads
+ */
+void TestGames() {
+    const int GAMES = 64;
+    std::vector<Responses::SessionStats> Serial;
+    for (int i = 0; i < GAMES; i++) {
+        Serial.push_back(playGame(i));
     }
 
-    // Tile has 0 adjacent mines
-    else {
-        std::stack<std::pair<char,char>,std::vector<std::pair<char,char>>> Stack;
-        Stack.push(tapped_tile);
+    std::vector<Responses::SessionStats> Parallel(GAMES);
+    std::vector<std::thread> Threads;
+    for (int t = 0; t < 4; t++) {
+        Threads.emplace_back([&Parallel,t]() {
+            for (int i = t; i < GAMES; i += 4) {
+                Parallel[i] = playGame(i);
+            }
+        });
+    }
+    for (auto& Thread : Threads) {
+        Thread.join();
+    }
 
+    for (int i = 0; i < GAMES; i++) {
+        CHECK(Serial[i].BoardsPlayed == 1);
+        CHECK(Serial[i].GamesWon + Serial[i].GamesLost == 1);
+        CHECK(Serial[i].TilesRevealed == Parallel[i].TilesRevealed);
+        CHECK(Serial[i].GamesWon == Parallel[i].GamesWon);
+    }
 
-        do {
-            std::pair<char, char> CurrentTile = Stack.top();
-            Stack.pop();
+    // Resetting starts a new board on the next tap
+    Minesweeper::Game Game((Config::Settings()),1);
+    CHECK(!Game.Started());
+    Game.Tap({1,1});
+    CHECK(Game.Started());
+    Game.Reset();
+    CHECK(!Game.Started() && !Game.Over());
+    Game.Tap({26,26});
+    CHECK(Game.getStats().BoardsPlayed == 2);
+}
+
+/**
+ * Checks that a saved game loads back exactly, plays on the same, and that damaged or mismatched files are refused
+ */
+void TestSnapshot() {
+    const char* PATH = "test_board.snapshot";
+    Config::Settings Settings;
+    Minesweeper::Game Game(Settings,Rng());
+    Responses::Step Step;
+    CHECK(!Game.Save(PATH));
 
-            int Row = (CurrentTile.first - 64) - 1;
-            int Column = (CurrentTile.second - 64) - 1;
+    Game.Tap({13,13});
+    std::uniform_int_distribution<int> Tile(1,26);
+    for (int i = 0; i < 20; i++) {
+        Game.Flag({Tile(Rng),Tile(Rng)});
+    }
+    CHECK(Game.Save(PATH));
 
-            for (int i=1; i<=9; i++) {
-                if ((Row > 0 && Row <= 26) && (Column > 0 && Column <= 26) && (i != 5)) {
-                    std::pair<char,char> AdjacentTile = {64 + Row,64 + Column};
+    Minesweeper::Game Loaded(Settings,Rng());
+    CHECK(Loaded.Load(PATH,Step));
+    std::vector<signed char> Expected, View;
+    Game.getBoard().getView(Expected);
+    Loaded.getBoard().getView(View);
+    CHECK(View == Expected);
+    CHECK(Loaded.getBoard().getMines() == Game.getBoard().getMines());
+    CHECK(Loaded.getSeed() == Game.getSeed());
+    CHECK(Loaded.getStats().TilesRevealed == Game.getStats().TilesRevealed);
+    CHECK(Step.NumTilesLeft == Game.getBoard().getRemaining() && Step.NumFlags == Game.getBoard().getNumFlags());
+    int Shown = 0;
+    for (const signed char Value : Expected) {
+        Shown += Value != Tiles::HIDDEN;
+    }
+    CHECK((int)Step.Tiles.size() == Shown);
 
-                    if (Board.Revealed.find(AdjacentTile) == Board.Revealed.end()) {
-                        Board.Revealed.insert(AdjacentTile);
+    // Both play on the same
+    for (int i = 0; i < 50 && !Game.Over(); i++) {
+        const std::pair<int,int> Next = {Tile(Rng),Tile(Rng)};
+        const Responses::Tap A = Game.Tap(Next), B = Loaded.Tap(Next);
+        CHECK(A.Tiles == B.Tiles && A.State == B.State && A.NumTilesLeft == B.NumTilesLeft);
+    }
 
-                        const int AdjacentMines = Board.Tiles[AdjacentTile];
-                        Response.Tiles.push_back({AdjacentTile,AdjacentMines});
-                        if (AdjacentMines == 0) {
-                            Stack.push(AdjacentTile);
-                        }
-                    }
-                }
-                if (i%3==0) {
-                    Row++;
-                    Column -= 2;
-                } else {
-                    Column++;
-                }
+    // Damaged files are refused and leave the game alone
+    std::vector<char> Bytes;
+    {
+        std::ifstream In(PATH,std::ios::binary);
+        Bytes.assign(std::istreambuf_iterator<char>(In),std::istreambuf_iterator<char>());
+    }
+    const auto write = [&](const std::vector<char>& bytes) {
+        std::ofstream Out(PATH,std::ios::binary | std::ios::trunc);
+        Out.write(bytes.data(),bytes.size());
+    };
+    const Responses::SessionStats Before = Loaded.getStats();
+    std::vector<char> Damaged = Bytes;
+    Damaged[Damaged.size()/2] ^= 0x20;
+    write(Damaged);
+    CHECK(!Loaded.Load(PATH,Step));
+    write(std::vector<char>(Bytes.begin(),Bytes.end() - 1));
+    CHECK(!Loaded.Load(PATH,Step));
+    Damaged = Bytes;
+    Damaged[8]++;   // Version
+    write(Damaged);
+    CHECK(!Loaded.Load(PATH,Step));
+    CHECK(!Loaded.Load("missing.snapshot",Step));
+    CHECK(Loaded.getStats().BoardsPlayed == Before.BoardsPlayed);
+
+    // Only boards of the same size load
+    write(Bytes);
+    Config::Settings Other = Settings;
+    Other.Mines = 99;
+    Minesweeper::Game Mismatched(Other);
+    CHECK(!Mismatched.Load(PATH,Step));
+    CHECK(Minesweeper::Game(Settings).Load(PATH,Step));
+
+    // A lost game loads as it was left
+    Minesweeper::Game Lost(Settings,Rng());
+    Lost.Tap({13,13});
+    const int Mine = Lost.getBoard().getMines().front();
+    Lost.Tap({1 + Mine/Settings.Columns,1 + Mine%Settings.Columns});
+    CHECK(Lost.getState() == States::Game::Lose && Lost.Save(PATH));
+    CHECK(Minesweeper::Game(Settings).Load(PATH,Step) && Step.State == States::Game::Lose);
+
+    // Files with a good checksum but a board the game couldn't have left are refused too
+    const Tiles::Board& Board = Game.getBoard();
+    Snapshot::Header Header = {};
+    Header.Rows = Settings.Rows;
+    Header.Columns = Settings.Columns;
+    Header.Mines = Settings.Mines;
+    Header.Revealed = Settings.Rows*Settings.Columns - Board.getRemaining();
+    Header.Flagged = Board.getNumFlags();
+    Header.BoardsPlayed = 1;
+    const auto refused = [&](std::vector<int> mines, std::vector<unsigned char> cells, int revealed) {
+        Snapshot::Header Changed = Header;
+        Changed.Revealed += revealed;
+        CHECK(Snapshot::Save(PATH,Changed,mines.data(),cells.data()));
+        return !Loaded.Load(PATH,Step);
+    };
+    const std::vector<int> Mines(Board.getMines().begin(),Board.getMines().end());
+    const std::vector<unsigned char> Cells(Board.getCells().begin(),Board.getCells().end());
+    CHECK(!refused(Mines,Cells,0));
+    Snapshot::Header Counted = Header;
+    Counted.BoardsPlayed = 3000000000LL;
+    Counted.TilesRevealed = 1LL << 40;      // Session counts go past 32 bits
+    CHECK(Snapshot::Save(PATH,Counted,Mines.data(),Cells.data()) && Loaded.Load(PATH,Step));
+    CHECK(Loaded.getStats().BoardsPlayed == 3000000000LL && Loaded.getStats().TilesRevealed == 1LL << 40);
+    std::vector<int> Outside = Mines;
+    Outside.back() = 1 << 20;
+    CHECK(refused(Outside,Cells,0));
+    std::vector<int> Twice = Mines;
+    Twice[1] = Twice[0];
+    CHECK(refused(Twice,Cells,0));
+    std::vector<unsigned char> Miscounted = Cells;
+    Miscounted.at(Mines[0] == 0 ? 1 : 0) ^= 1;
+    CHECK(refused(Mines,Miscounted,0));
+    std::vector<unsigned char> Unmarked = Cells;
+    Unmarked[Mines[0]] &= ~0x10;
+    CHECK(refused(Mines,Unmarked,0));
+    CHECK(refused(Mines,Cells,1));
+
+    // So are states and stats that don't go with the board
+    const auto stated = [&](States::Game state, long long won, long long lost, const Snapshot::Header& header,
+        const Tiles::Board& board) {
+        Snapshot::Header Changed = header;
+        Changed.State = (std::int32_t)state;
+        Changed.GamesWon = won;
+        Changed.GamesLost = lost;
+        CHECK(Snapshot::Save(PATH,Changed,board.getMines().data(),board.getCells().data()));
+        return Loaded.Load(PATH,Step);
+    };
+    CHECK(!stated(States::Game::Win,1,0,Header,Board));
+    CHECK(!stated(States::Game::Lose,0,0,Header,Board));
+    CHECK(!stated(States::Game::Playon,1,1,Header,Board));
+    CHECK(stated(States::Game::Lose,0,1,Header,Board));
+    Minesweeper::Game Won(Settings,175);
+    Won.Tap({13,13});
+    for (int i = 0; i < Settings.Rows*Settings.Columns && !Won.Over(); i++) {
+        if (!(Won.getBoard().getCells()[i] & 0x10)) {Won.Tap({1 + i/Settings.Columns,1 + i%Settings.Columns});}
+    }
+    Snapshot::Header Cleared = Header;
+    Cleared.Revealed = Settings.Rows*Settings.Columns - Settings.Mines;
+    Cleared.Flagged = Won.getBoard().getNumFlags();
+    CHECK(Won.getState() == States::Game::Win && Won.Save(PATH) && Loaded.Load(PATH,Step));
+    CHECK(!stated(States::Game::Playon,0,0,Cleared,Won.getBoard()));
+    CHECK(!stated(States::Game::Lose,0,1,Cleared,Won.getBoard()));
+    CHECK(!stated(States::Game::Win,0,0,Cleared,Won.getBoard()));
+    CHECK(stated(States::Game::Win,1,0,Cleared,Won.getBoard()));
+
+    // A refused file leaves the last good load alone
+    CHECK(stated(States::Game::Playon,0,0,Header,Board) && !stated(States::Game::Win,1,0,Header,Board));
+    Loaded.getBoard().getView(View);
+    Game.getBoard().getView(Expected);
+    CHECK(View == Expected);
+    std::remove(PATH);
+}
+
+/**
+ * Records a session of random moves the way the game does, then checks that it reads back and verifies, and that
+ * a changed or cut short recording doesn't
+ */
+void TestReplay() {
+    const char* PATH = "test_board.replay";
+    Config::Settings Settings;
+    Minesweeper::Game Game(Settings,Rng());
+    std::vector<Replay::Event> Events;
+    {
+        Replay::Recorder Recorder(PATH,Settings,Game.getSeed());
+        CHECK(Recorder.Valid());
+        std::uniform_int_distribution<int> Tile(1,26);
+        Responses::Tap TR;
+        Responses::Step SR;
+        for (int i = 0; i < 2000; i++) {
+            Replay::Event Event;
+            Event.Tile = {Tile(Rng),Tile(Rng)};
+            const int Pick = Rng()%10;
+            if (Game.Over() || Pick == 0) {
+                if (!Game.Started()) {continue;}
+                Event.Key = States::Input::Reset;
+                Game.Reset();
+            } else if (Pick <= 2 && Game.Started()) {
+                Event.Key = States::Input::Flag;
+                Event.Check = Replay::Fingerprint(Game.Flag(Event.Tile));
+            } else if (Pick == 3 || Pick == 4) {
+                Event.Key = Pick == 3 ? States::Input::Undo : States::Input::Redo;
+                if (!(Pick == 3 ? Game.Undo(SR) : Game.Redo(SR))) {continue;}
+                Event.Check = Replay::Fingerprint(SR);
+            } else {
+                Event.Key = States::Input::Tap;
+                Event.Starts = !Game.Started();
+                Game.Tap(Event.Tile,TR);
+                Event.Seed = Game.getSeed();
+                Event.Check = Replay::Fingerprint(TR);
             }
-        } while (!Stack.empty());
+            Recorder.Record(Event);
+            Events.push_back(Event);
+        }
+    }
 
-        if (Board.Revealed.size() == 676 - 100) {
-            Response.GameState = 'F';
-        } else {
-            Response.GameState = 'O';
+    Replay::Reader Reader(PATH);
+    CHECK(Reader.Valid());
+    CHECK(Reader.getSettings().Rows == 26 && Reader.getSettings().Mines == 100);
+    Replay::Event Next;
+    for (const Replay::Event& Event : Events) {
+        CHECK(Reader.Next(Next));
+        CHECK(Next.Key == Event.Key && Next.Check == Event.Check && Next.Starts == Event.Starts);
+        if (Event.Key == States::Input::Tap || Event.Key == States::Input::Flag) {CHECK(Next.Tile == Event.Tile);}
+        if (Event.Starts) {CHECK(Next.Seed == Event.Seed);}
+        if (Failures) {return;}
+    }
+    CHECK(!Reader.Next(Next) && Reader.Done());
+
+    Replay::Report Report = Replay::Verify(PATH,1);
+    CHECK(Report.Valid && Report.Complete);
+    CHECK(Report.Events == (long long)Events.size() && Report.Mismatches == 0);
+
+    // Every board is counted once, under the tile it was started from
+    Analytics::Summary Summary;
+    Analytics::Analyze(PATH,Summary);
+    CHECK(Summary.Recordings == 1 && Summary.Unreadable == 0 && Summary.Damaged == 0);
+    CHECK(Summary.Events == (long long)Events.size());
+    CHECK(Summary.Stats.BoardsPlayed == Game.getStats().BoardsPlayed);
+    CHECK(Summary.Stats.GamesLost == Game.getStats().GamesLost);
+    CHECK(Summary.Stats.TilesRevealed == Game.getStats().TilesRevealed);
+    long long Boards = 0;
+    for (const auto& Entry : Summary.Openings) {
+        Boards += Entry.second.Boards;
+    }
+    CHECK(Boards == Summary.MovesPerBoard.Count());
+    CHECK(Boards == std::count_if(Events.begin(),Events.end(),[](const Replay::Event& e) {return e.Starts;}));
+
+    // A changed fingerprint is caught where it is, a cut short event stops the replay before it
+    std::vector<char> Bytes;
+    {
+        std::ifstream In(PATH,std::ios::binary);
+        Bytes.assign(std::istreambuf_iterator<char>(In),std::istreambuf_iterator<char>());
+    }
+    const auto write = [&](const std::vector<char>& bytes) {
+        std::ofstream Out(PATH,std::ios::binary | std::ios::trunc);
+        Out.write(bytes.data(),bytes.size());
+    };
+    std::vector<char> Changed = Bytes;
+    const bool LastReset = Events.back().Key == States::Input::Reset;
+    if (!LastReset) {
+        Changed.back() ^= 1;
+        write(Changed);
+        Report = Replay::Verify(PATH,1);
+        CHECK(Report.Complete && Report.Mismatches == 1 && Report.FirstMismatch == Report.Events - 1);
+    }
+    write(std::vector<char>(Bytes.begin(),Bytes.end() - 1));
+    Report = Replay::Verify(PATH,1);
+    CHECK(!Report.Complete && Report.Events == (long long)Events.size() - 1 && Report.Mismatches == 0);
+    write(std::vector<char>(Bytes.begin(),Bytes.begin() + 10));
+    CHECK(!Replay::Verify(PATH,1).Valid);
+
+    // Headers with boards the game can't deal are rejected, like they would be on the command line
+    for (const std::array<int,3>& Size : std::vector<std::array<int,3>>{{3,3,5},{26,26,0},{26,26,668},{200000,1,5}}) {
+        Config::Settings Bad;
+        Bad.Rows = Size[0];
+        Bad.Columns = Size[1];
+        Bad.Mines = Size[2];
+        {
+            Replay::Recorder Recorder(PATH,Bad,1);
         }
+        CHECK(!Replay::Reader(PATH).Valid() && !Replay::Verify(PATH,1).Valid);
+    }
+    CHECK(Config::ValidBoard(26,26,667) && !Config::ValidBoard(1ULL << 32,1ULL << 32,5));
+    std::remove(PATH);
+}
 
-        return Response;
+/**
+ * Checks that histogram percentiles land within a bucket of the exact ones, however they were merged
+ */
+void TestHistogram() {
+    std::vector<std::uint64_t> Values;
+    Analytics::Histogram Whole, Halves[2];
+    std::uniform_int_distribution<int> Exponent(0,40);
+    for (int i = 0; i < 100000; i++) {
+        const std::uint64_t Value = Rng() >> (Rng()%32) | (std::uint64_t)1 << Exponent(Rng);
+        Values.push_back(Value);
+        Whole.Add(Value);
+        Halves[i%2].Add(Value);
     }
+    Halves[0].Merge(Halves[1]);
+    std::sort(Values.begin(),Values.end());
 
+    CHECK(Whole.Count() == (long long)Values.size() && Whole.Max() == Values.back());
+    for (const double P : {1.0,25.0,50.0,90.0,99.0,99.9,100.0}) {
+        const double Exact = Values[std::max(0,(int)(P/100*Values.size() + 0.5) - 1)];
+        CHECK(std::abs(Whole.Percentile(P) - Exact) <= Exact/16 + 1);
+        CHECK(Halves[0].Percentile(P) == Whole.Percentile(P));
+    }
+
+    // Small values are exact
+    Analytics::Histogram Small;
+    for (int i = 0; i < 16; i++) {
+        Small.Add(i);
+    }
+    CHECK(Small.Percentile(50) == 7 && Small.Percentile(100) == 15 && Small.Mean() == 7.5);
 }
 
-void Test() {
-    std::map<int,const char*> Colours {
-        {0, "\033[34m"},
-        {1, "\033[37m"},
-        {2, "\033[37m"},
-        {3, "\033[37m"},
-        {4, "\033[37m"},
-        {5, "\033[37m"},
-        {6, "\033[37m"},
-        {7, "\033[37m"},
-        {8, "\033[37m"},
-        {9, "\033[31m"}
+/**
+ * Checks that a frame holds only the cells that changed, in as few bytes as it takes
+ */
+void TestScreen() {
+    int Pipe[2];
+    CHECK(pipe(Pipe) == 0);
+    const auto frame = [&](Screen::Buffer& screen) {
+        const std::size_t Size = screen.Flush(Pipe[1]);
+        std::string Frame(Size,'\0');
+        if (Size) {Frame.resize(read(Pipe[0],&Frame[0],Size));}
+        return Frame;
     };
 
-    int Count = 0;
-    std::vector<std::pair<char,char>> AllTiles = getAllTiles();
-    for (const auto& Tile : AllTiles) {
-        std::cout << Colours[Board.Tiles[Tile]] << Tile.first << ':' << Tile.second << "\033[0m ";
+    Screen::Buffer Screen(3,10);
+    CHECK(Screen.Print(1,1,"ab▶") == 3);
+    CHECK(frame(Screen) == "\033[2J\033[1;1Hab▶");
+    CHECK(frame(Screen).empty());
+
+    // Drawing what is already there changes nothing
+    Screen.Put(1,3,"▶");
+    CHECK(frame(Screen).empty());
+
+    // Colours are set once per run, gaps are redrawn only when that's shorter than moving the cursor
+    Screen.Put(2,5,"1",26);
+    Screen.Put(2,6,"2",26);
+    Screen.Put(2,8,"3",26);
+    Screen.Put(3,1,"x");
+    Screen.Put(3,3,"y");
+    CHECK(frame(Screen) == "\033[2;5H\033[38;5;26m12\033[2;8H3\033[3;1H\033[0mx y");
+
+    // Off screen is dropped
+    Screen.Put(4,1,"z");
+    CHECK(Screen.Print(3,9,"long") == 4);
+    CHECK(frame(Screen) == "\033[3;9Hlo");
+
+    // Blank cells are left to the clear, and the cursor ends up parked
+    Screen.Park(3,10);
+    Screen.Invalidate();
+    CHECK(frame(Screen) == "\033[2J\033[1;1Hab▶\033[2;5H\033[38;5;26m12\033[2;8H3\033[3;1H\033[0mx y     lo\033[3;10H");
+
+    const Screen::Metrics& Metrics = Screen.getMetrics();
+    CHECK(Metrics.Frames == 6 && Metrics.LastCells == 16 && Metrics.Cells == 3 + 6 + 2 + 16);
+
+    // A scrolled rectangle is redrawn, unless the terminal can scroll it within margins
+    Screen::Buffer Panel(4,6);
+    for (const bool Margins : {false,true}) {
+        Panel.useMargins(Margins);
+        Panel.Invalidate();
+        Panel.Print(1,1,"|abc|x");
+        Panel.Print(2,1,"|def|y");
+        frame(Panel);
+        Panel.Scroll(1,2,2,4);
+        Panel.Print(2,2,"gh");
+        CHECK(frame(Panel) == (Margins
+            ? "\033[?69h\033[1;2r\033[2;4s\033[1S\033[r\033[s\033[?69l\033[2;2Hgh"
+            : "\033[1;2Hdef\033[2;2Hgh "));
+    }
+    close(Pipe[0]);
+    close(Pipe[1]);
+}
+
+/**
+ * Checks commands are read the same as the parser they replaced did, without allocating
+ */
+void TestInput() {
+    Config::Settings Settings;
+    Settings.Rows = 30;
+    Settings.Columns = 800;
+
+    const auto same = [&](const std::string& line) {
+        const Responses::Input New = Input::Parse(line,Settings);
+        const Responses::Input Old = Legacy::Parse(line,Settings);
+        const bool Paths = (New.Key != States::Input::Save && New.Key != States::Input::Load) || New.Path == Old.Path;
+        return New.Key == Old.Key && New.Tile == Old.Tile && Paths;
+    };
 
-        Count++;
-        if (Count%26==0) {
-            std::cout << '\n';
+    CHECK(Input::Parse("  TaP  b:AD ",Settings).Tile == std::make_pair(2,30));
+    CHECK(Input::Parse("f 3;12",Settings).Key == States::Input::Flag);
+    CHECK(Input::Parse("Down 5",Settings).Tile == std::make_pair(5,0));
+    CHECK(Input::Parse("left",Settings).Tile == std::make_pair(0,-13));
+    CHECK(Input::Parse("tap a:a extra",Settings).Key == States::Input::Bad);
+    CHECK(Input::Parse("tap AE:A",Settings).Key == States::Input::Bad);
+    CHECK(Input::Parse("Save  My Game.save ",Settings).Path == "My Game.save");
+    CHECK(Input::Parse("load",Settings).Key == States::Input::Bad);
+    CHECK(Input::Parse(std::string("q\0",2),Settings).Key == States::Input::Bad);
+
+    // Lines built from pieces of commands, half of them shaped like a command and a tile, so most are close to valid
+    const std::vector<std::string> PIECES = {
+        "tap", "T", "flag", "f", "view", "V", "Up", "down", "left", "RIGHT", "quit", "q", "reset", "undo", "redo",
+        "save", "Load", "taps", "a", "Z", "ad", "aaa", "1", "30", "31", "0", "007", "99999999999", ":", ";", " ",
+        "  ", "\t", "\r", "-", "é", std::string(1,'\0'),
+    };
+    const std::vector<std::string> HALVES = {"a", "B", "ad", "AE", "1", "30", "0", "", ":", ";", ";", ":"};
+    for (int i = 0; i < 200000; i++) {
+        std::string Line;
+        if (i%2) {
+            Line = PIECES[Rng()%16] + std::string(1 + Rng()%2,' ');
+            for (int Pieces = Rng()%8; Pieces >= 0; Pieces--) {
+                Line += HALVES[Rng()%HALVES.size()];
+            }
+        }
+        for (int Pieces = Rng()%(i%2 ? 2 : 7); Pieces >= 0; Pieces--) {
+            Line += Rng()%8 ? PIECES[Rng()%PIECES.size()] : std::string(1,(char)(Rng()%256));
         }
+        if (!same(Line)) {
+            CHECK(same(Line));
+            break;
+        }
+    }
+
+    const std::vector<std::string> Lines = {
+        "tap ab:3", "FLAG 2;z", "v 30:ADT", "up 12", "redo", "a command with far too many words", "t a:a:a",
+    };
+    const long long Before = Allocations;
+    long long Rows = 0;
+    for (const std::string& Line : Lines) {
+        Rows += Input::Parse(Line,Settings).Tile.first;
     }
+    CHECK(Rows == 28 + 2 + 30 - 12);
+    CHECK(Allocations == Before);
+}
 
-    std::pair<char,char> TappedTile = {'D','J'};
-    TapResponse TR = Tap(TappedTile);
+/**
+ * Reads a script through a Reader, with lines split across its blocks and a line longer than a block
+ */
+void TestReader() {
+    Config::Settings Settings;
+    const char* PATH = "test_board.script";
+    const std::string Long = "save " + std::string(100000,'x');
+    {
+        std::ofstream Script(PATH,std::ios::binary);
+        for (int i = 0; i < 20000; i++) {
+            Script << (i%2 ? "tap b:c\n" : "\n\nUp 4\n");
+        }
+        Script << Long << "\n  \nquit";
+    }
 
-    std::cout << TR.Tiles.size() << '\n';
-    for (const auto& TileData : TR.Tiles) {
-        const auto Tile = TileData.first;
-        std::cout << Tile.first << ':' << Tile.second << " : " << TileData.second << '\n';
+    const int Descriptor = open(PATH,O_RDONLY);
+    Input::Reader Reader(Descriptor);
+    Responses::Input Response;
+    int Taps = 0, Pans = 0;
+    while (Reader.Next(Settings,Response) && Response.Key != States::Input::Save) {
+        Taps += Response.Key == States::Input::Tap && Response.Tile == std::make_pair(2,3);
+        Pans += Response.Key == States::Input::Pan && Response.Tile == std::make_pair(-4,0);
+    }
+    CHECK(Taps == 10000 && Pans == 10000);
+    CHECK(Response.Path == std::string(100000,'x'));
+    CHECK(Reader.Next(Settings,Response) && Response.Key == States::Input::Bad);
+    CHECK(Reader.Next(Settings,Response) && Response.Key == States::Input::Quit);
+    CHECK(!Reader.Next(Settings,Response));
+    CHECK(Reader.getLines() == 20000 + 3);
+    close(Descriptor);
+    std::remove(PATH);
+}
+
+/**
+ * Decodes keys, runs timers while waiting for them and turns them into moves, from a pipe instead of a terminal
+ */
+void TestKeyboard() {
+    const auto decode = [](const std::string& bytes, bool complete, Keyboard::Key key) {
+        Keyboard::Press Press;
+        const std::size_t Used = Keyboard::Decode(bytes.data(),bytes.size(),complete,Press);
+        return Press.Type == key ? Used : 0;
+    };
+    CHECK(decode("\033[A",false,Keyboard::Key::Up) == 3);
+    CHECK(decode("\033OB",false,Keyboard::Key::Down) == 3);
+    CHECK(decode("\033[1;5Cx",false,Keyboard::Key::Right) == 6);
+    CHECK(decode("\033[15~",false,Keyboard::Key::None) == 5);
+    Keyboard::Press Pending;
+    CHECK(Keyboard::Decode("\033[",2,false,Pending) == 0);
+    CHECK(decode("\033[",true,Keyboard::Key::Escape) == 1);
+    CHECK(decode("\033",true,Keyboard::Key::Escape) == 1);
+    CHECK(decode("\033x",false,Keyboard::Key::Escape) == 1);
+    CHECK(decode("\r",false,Keyboard::Key::Enter) == 1);
+    CHECK(decode("\x7f",false,Keyboard::Key::Backspace) == 1);
+    CHECK(decode("\x03",false,Keyboard::Key::Interrupt) == 1);
+    CHECK(decode("F",false,Keyboard::Key::Character) == 1);
+
+    // Timers run until the key arrives, half of an arrow key waits for the other half
+    int Pipe[2];
+    CHECK(pipe(Pipe) == 0);
+    Keyboard::Loop Loop(Pipe[0]);
+    int Ticks = 0;
+    Loop.Every(std::chrono::milliseconds(5),[&] {Ticks++;});
+    std::thread Typist([&] {
+        std::this_thread::sleep_for(std::chrono::milliseconds(60));
+        CHECK(write(Pipe[1],"\033[",2) == 2);
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        CHECK(write(Pipe[1],"D",1) == 1);
+        close(Pipe[1]);
+    });
+    Keyboard::Press Press;
+    CHECK(Loop.Next(Press) && Press.Type == Keyboard::Key::Left);
+    CHECK(Ticks >= 5);
+    CHECK(!Loop.Next(Press));
+    Typist.join();
+    close(Pipe[0]);
+
+    // Moves, with a command typed and corrected in between
+    Config::Settings Settings;
+    CHECK(pipe(Pipe) == 0);
+    const std::string Keys = "\033[Bl f:t c:d\r:zz\x7f\x7fu\rq";
+    CHECK(write(Pipe[1],Keys.data(),Keys.size()) == (ssize_t)Keys.size());
+    close(Pipe[1]);
+    Keyboard::Commands Commands(Pipe[0],Settings);
+    Render::Base Renderer;
+    const std::vector<std::pair<States::Input,std::pair<int,int>>> Expected = {
+        {States::Input::Tap,{2,2}},
+        {States::Input::Flag,{2,2}},
+        {States::Input::Tap,{3,4}},
+        {States::Input::Undo,{0,0}},
+        {States::Input::Quit,{0,0}},
+        {States::Input::Quit,{0,0}},    // Once the keys run out
+    };
+    for (const auto& Move : Expected) {
+        const Responses::Input Response = Commands.Get(Renderer);
+        CHECK(Response.Key == Move.first && Response.Tile == Move.second);
+    }
+    CHECK(Commands.getLatency().Count() == 19);
+    close(Pipe[0]);
+}
+
+/**
+ * Passes items between two threads in order, and runs commands through the stages with a renderer slow enough that
+ * updates pile up and get merged into fewer frames, and that the engine has moved on by the time one is drawn
+ */
+void TestPipeline() {
+    Pipeline::Queue<int,8> Small;
+    int Item = 0;
+    for (int i = 0; i < 8; i++) {
+        Item = i;
+        CHECK(Small.Push(Item));
+    }
+    Item = 8;
+    CHECK(!Small.Push(Item) && Item == 8 && Small.Size() == 8);
+    CHECK(Small.Pop(Item) && Item == 0 && Small.Push(Item));
+    for (int i = 1; i < 9; i++) {CHECK(Small.Pop(Item) && Item == i % 8);}
+    CHECK(!Small.Pop(Item));
+
+    constexpr int ITEMS = 1000000;
+    Pipeline::Queue<int,64> Shared;
+    std::thread Producer([&] {
+        Pipeline::Backoff Full;
+        for (int i = 0; i < ITEMS; i++) {
+            int Next = i;
+            while (!Shared.Push(Next)) {Full.Wait();}
+            Full.Reset();
+        }
+    });
+    int Expected = 0;
+    Pipeline::Backoff Empty;
+    while (Expected < ITEMS) {
+        if (!Shared.Pop(Item)) {
+            Empty.Wait();
+            continue;
+        }
+        Empty.Reset();
+        if (Item != Expected) {break;}
+        Expected++;
+    }
+    Producer.join();
+    CHECK(Expected == ITEMS);
+
+    // Logs a tile per command, every frame takes a while to write
+    class Slow : public Render::Base {
+    public:
+        std::vector<int> Logged;
+        int Frames = 0;
+        void Log(States::Log key, const std::pair<int,int>& tile) override {
+            if (key == States::Log::Tap) {Logged.push_back(tile.first);}
+        }
+        void Prompt() override {Flush();}
+        void Flush() override {
+            std::this_thread::sleep_for(std::chrono::milliseconds(2));
+            Frames++;
+        }
+    };
+
+    constexpr int COMMANDS = 300;
+    for (const bool Prompting : {false,true}) {
+        Slow Target;
+        int Read = 0;
+        Pipeline::Stages Stages(Target,[&](Pipeline::Command& command) {
+            std::this_thread::sleep_for(std::chrono::microseconds(100));
+            command.Input.Key = States::Input::Tap;
+            command.Input.Tile = {Read,0};
+            command.End = Read++ == COMMANDS;
+        },Prompting);
+
+        while (true) {
+            const Pipeline::Command Command = Stages.Next();
+            if (Command.End) {break;}
+            Stages.Log(States::Log::Tap,Command.Input.Tile);
+        }
+        Stages.Flush();
+        Stages.Stop();
+
+        const Pipeline::Metrics& Metrics = Stages.getMetrics();
+        CHECK((int)Target.Logged.size() == COMMANDS);
+        for (int i = 0; i < (int)Target.Logged.size(); i++) {CHECK(Target.Logged[i] == i);}
+        CHECK(Metrics.Updates == COMMANDS && Metrics.Frames == Target.Frames);
+        CHECK(Prompting ? Target.Frames > 1 && Target.Frames < COMMANDS/2 : Target.Frames == 1);
+        CHECK(Metrics.Latency.Count() == COMMANDS && Metrics.InputWait.Count() == COMMANDS + 1);
+        CHECK(Metrics.Engine.Count() == COMMANDS && Metrics.InputDepth.Max() <= 64);
     }
 
+    // Once every slot has held a reveal this large, queueing and drawing more of them allocates nothing
+    Render::Base Quiet;
+    const Tiles::Board Dealt((Config::Settings()));
+    Pipeline::Stages Stages(Quiet,[](Pipeline::Command& command) {command.End = true;},false);
+    Stages.Dashboard(Dealt);
+    Responses::Tap Tap = {};
+    Tap.Tiles.assign(100,{{1,1},1});
+    for (int i = 0; i < 512; i++) {Stages.Reveal(Tap);}
+    const long long Before = Allocations;
+    for (int i = 0; i < 4096; i++) {Stages.Reveal(Tap);}
+    const long long Queued = Allocations - Before;
+    Stages.Stop();
+    CHECK(Queued == 0 && Stages.getMetrics().Updates == 1 + 512 + 4096);
+
+    // Copies what it is given to draw from, slowly enough that the engine keeps running ahead of it
+    class Copying : public Render::Base {
+    public:
+        const Tiles::View* Source = nullptr;
+        std::vector<std::vector<signed char>> Copies;
+        void Dashboard(const Tiles::View& board) override {Source = &board;}
+        void Reveal(const Responses::Tap& response) override {(void)response; copy();}
+        void Flag(const std::pair<int,int>& tile, const Responses::Flag& response) override {
+            (void)tile;
+            (void)response;
+            copy();
+        }
+        void Step(const Responses::Step& response) override {(void)response; copy();}
+
+        void copy() {
+            std::this_thread::sleep_for(std::chrono::microseconds(50));
+            const Config::Settings& Settings = Source->getSettings();
+            Copies.emplace_back();
+            for (int Row = 1; Row <= Settings.Rows; Row++) {
+                for (int Column = 1; Column <= Settings.Columns; Column++) {
+                    Copies.back().push_back(Source->getShown({Row,Column}));
+                }
+            }
+        }
+    };
+
+    // The window is redrawn from what the updates showed, never from the board the engine has since changed
+    Config::Settings Classic;
+    Tiles::Board Played(Classic);
+    Played.generateBoard({13,13},175);
+    Copying Target;
+    std::vector<std::vector<signed char>> Views;
+    {
+        Pipeline::Stages Drawing(Target,[](Pipeline::Command& command) {command.End = true;},false);
+        Drawing.Dashboard(Played);
+        Responses::Step Step;
+        bool Lost = false;
+        for (int i = 0; i < 400; i++) {
+            const std::pair<int,int> Tile = {1 + Rng()%Classic.Rows,1 + Rng()%Classic.Columns};
+            const int Move = Lost ? 2 : Rng()%4;    // A loss is always undone straight away
+            if (Move == 0) {
+                const Responses::Tap Tap = Played.Tap(Tile);
+                Lost = Tap.State == States::Game::Lose;
+                Drawing.Reveal(Tap);
+            } else if (Move == 1) {
+                Drawing.Flag(Tile,Played.Flag(Tile));
+            } else if (Move == 2 ? Played.Undo(Step) : Played.Redo(Step)) {
+                Lost = Step.State == States::Game::Lose;
+                Drawing.Step(Step);
+            } else {
+                continue;
+            }
+            Views.emplace_back();
+            Played.getView(Views.back());
+            if (Lost) {
+                for (const int Mine : Played.getMines()) {Views.back()[Mine] = Pipeline::Mirror::MINE;}
+            }
+        }
+        Drawing.Stop();
+    }
+    CHECK(Target.Copies.size() == Views.size() && Target.Copies == Views);
 }
 
 int main() {
-    std::pair<char,char> SafeTile = {'G','T'};
+    TestCoords();
+    TestCounts();
 
-    std::vector<std::pair<char,char>> AllTiles = getAllTiles();
-    std::set<std::pair<char,char>> SafeTiles = getSafeTiles(SafeTile);
-    Board.generateMines(AllTiles,SafeTiles);
-    Board.setTiles(AllTiles);
+    Config::Settings Classic;
+    TestBoard(Classic,{'G' - 64,'T' - 64});
 
-    Test();
-}
\ No newline at end of file
+    Config::Settings Wide;
+    Wide.Rows = 7;
+    Wide.Columns = 300;
+    Wide.Mines = 400;
+    TestBoard(Wide,{4,150});
+
+    Config::Settings Big;
+    Big.Rows = 400;
+    Big.Columns = 250;
+    Big.Mines = 15000;
+    TestBoard(Big,{1,1});
+
+    // Big enough openings to be finished in parallel
+    Config::Settings Sparse;
+    Sparse.Rows = 400;
+    Sparse.Columns = 400;
+    Sparse.Mines = 150;
+    Sparse.Threads = 4;
+    TestBoard(Sparse,{200,200});
+
+    TestFalseFlag();
+    for (int i = 0; i < 50; i++) {
+        TestUndo(Classic,4);
+    }
+    TestUndo(Sparse,50);
+    TestSeeds();
+    TestAllocations();
+    TestArena();
+    TestGames();
+    TestSnapshot();
+    TestReplay();
+    TestHistogram();
+    TestScreen();
+    TestInput();
+    TestReader();
+    TestKeyboard();
+    TestPipeline();
+
+    std::cout << (Failures ? "FAILED" : "PASSED") << '\n';
+    return Failures != 0;
+}
@@ -0,0 +1,184 @@
+#include "probability.hpp"
+#include "tiles.hpp"
+#include "config.hpp"
+
+#include <iostream>
+#include <utility>
+#include <cstdint>
+#include <random>
+#include <vector>
+#include <cmath>
+
+// clang++ -std=c++11 -pthread -IHeaders -o binary/test_probability tests/test_probability.cpp Sources/probability.cpp Sources/solver.cpp Sources/tiles.cpp Sources/memory.cpp Sources/counts.cpp Sources/config.cpp && ./binary/test_probability
+
+int Failures = 0;
+std::mt19937 Rng(175);
+
+#define CHECK(condition) \
+    if (!(condition)) {std::cout << "FAILED " << __LINE__ << ": " #condition "\n"; Failures++;}
+
+/**
+ * Finds every mine of a board, by tapping a mine on a copy of it
+ */
+std::vector<bool> findMines(const Tiles::Board& board) {
+    const Config::Settings& Settings = board.getSettings();
+    Tiles::Board Copy = board;
+    std::vector<bool> Mines(Settings.Rows*Settings.Columns,false);
+    for (int Row = 1; Row <= Settings.Rows; Row++) {
+        for (int Column = 1; Column <= Settings.Columns; Column++) {
+            const Responses::Tap Probe = Copy.Tap({Row,Column});
+            if (Probe.State != States::Game::Lose) {continue;}
+            for (const auto& TileData : Probe.Tiles) {
+                Mines[(TileData.first.first - 1)*Settings.Columns + TileData.first.second - 1] = true;
+            }
+            return Mines;
+        }
+    }
+    return Mines;
+}
+
+// Picks a random unrevealed tile that is not a mine
+std::pair<int,int> findSafe(const Tiles::Board& board, const std::vector<bool>& mines) {
+    const Config::Settings& Settings = board.getSettings();
+    std::pair<int,int> Tile;
+    do {
+        Tile = {1 + Rng()%Settings.Rows,1 + Rng()%Settings.Columns};
+    } while (board.tileRevealed(Tile) || mines[(Tile.first - 1)*Settings.Columns + Tile.second - 1]);
+    return Tile;
+}
+
+/**
+ * Compares the engine with the share of every arrangement with the right number of mines, on small boards
+ */
+void TestExact(const Config::Settings& settings, int boards) {
+    Probability::Engine Engine;
+    const int TotalTiles = settings.Rows*settings.Columns;
+    std::vector<signed char> View;
+
+    for (int b = 0; b < boards; b++) {
+        Tiles::Board Board(settings);
+        const std::pair<int,int> Start = {1 + b%settings.Rows,1 + b%settings.Columns};
+        Board.generateBoard(Start,Rng());
+        const std::vector<bool> Mines = findMines(Board);
+
+        bool Playing = Board.Tap(Start).State == States::Game::Playon;
+        while (Playing) {
+            Board.getView(View);
+            std::vector<int> Hidden;
+            for (int i = 0; i < TotalTiles; i++) {
+                if (View[i] < 0) {Hidden.push_back(i);}
+            }
+
+            // Every set of hidden tiles with the right size, in increasing order
+            std::vector<double> MineCounts(TotalTiles,0);
+            double Arrangements = 0;
+            std::vector<unsigned char> Plane(TotalTiles);
+            const long End = 1L << Hidden.size();
+            for (long Set = (1L << settings.Mines) - 1; Set < End;) {
+                std::fill(Plane.begin(),Plane.end(),0);
+                for (size_t h = 0; h < Hidden.size(); h++) {
+                    Plane[Hidden[h]] = Set >> h & 1;
+                }
+
+                bool Fits = true;
+                for (int i = 0; i < TotalTiles && Fits; i++) {
+                    if (View[i] < 0) {continue;}
+                    const int Row = i/settings.Columns;
+                    const int Column = i%settings.Columns;
+                    int Adjacent = 0;
+                    for (int r = std::max(0,Row - 1); r <= std::min(settings.Rows - 1,Row + 1); r++) {
+                        for (int c = std::max(0,Column - 1); c <= std::min(settings.Columns - 1,Column + 1); c++) {
+                            Adjacent += Plane[r*settings.Columns + c];
+                        }
+                    }
+                    Fits = Adjacent == View[i];
+                }
+                if (Fits) {
+                    Arrangements++;
+                    for (int i : Hidden) {
+                        MineCounts[i] += Plane[i];
+                    }
+                }
+
+                const long Low = Set & -Set;
+                const long Carry = Set + Low;
+                Set = (((Set ^ Carry) >> 2)/Low) | Carry;
+            }
+
+            const std::vector<double>& Odds = Engine.Compute(Board);
+            CHECK(Engine.Exact());
+            CHECK(Arrangements > 0);
+            for (int i = 0; i < TotalTiles; i++) {
+                CHECK(std::fabs(Odds[i] - MineCounts[i]/Arrangements) < 1e-9);
+            }
+            if (Failures) {return;}
+
+            Playing = Board.Tap(findSafe(Board,Mines)).State == States::Game::Playon;
+        }
+    }
+}
+
+/**
+ * Splitting big components between threads must give the same chances as one thread
+ */
+void TestThreads(const Config::Settings& settings, int boards) {
+    Config::Settings Threaded = settings;
+    Threaded.Threads = 4;
+    Probability::Engine Serial;
+    Probability::Engine Parallel;
+
+    for (int b = 0; b < boards; b++) {
+        Tiles::Board Board(settings);
+        Tiles::Board Copy(Threaded);
+        const std::uint64_t Seed = Rng();
+        const std::pair<int,int> Start = {(settings.Rows + 1)/2,(settings.Columns + 1)/2};
+        Board.generateBoard(Start,Seed);
+        Copy.generateBoard(Start,Seed);
+        const std::vector<bool> Mines = findMines(Board);
+
+        bool Playing = Board.Tap(Start).State == States::Game::Playon;
+        Copy.Tap(Start);
+        while (Playing) {
+            const std::vector<double> One = Serial.Compute(Board);
+            const std::vector<double>& Four = Parallel.Compute(Copy);
+            CHECK(Serial.Exact() == Parallel.Exact());
+
+            double Sum = 0;
+            for (size_t i = 0; i < One.size(); i++) {
+                CHECK(std::fabs(One[i] - Four[i]) < 1e-9);
+                CHECK(One[i] >= 0 && One[i] <= 1);
+                Sum += One[i];
+            }
+            // Every mine is somewhere
+            CHECK(std::fabs(Sum - settings.Mines) < 1e-6);
+            if (Failures) {return;}
+
+            const std::pair<int,int> Safe = findSafe(Board,Mines);
+            Playing = Board.Tap(Safe).State == States::Game::Playon;
+            Copy.Tap(Safe);
+        }
+    }
+}
+
+int main() {
+    Config::Settings Small;
+    Small.Rows = 4;
+    Small.Columns = 5;
+    Small.Mines = 5;
+    TestExact(Small,60);
+
+    Config::Settings Narrow;
+    Narrow.Rows = 3;
+    Narrow.Columns = 7;
+    Narrow.Mines = 5;
+    TestExact(Narrow,30);
+
+    Config::Settings Expert;
+    Expert.Rows = 16;
+    Expert.Columns = 30;
+    Expert.Mines = 99;
+    TestThreads(Expert,2);
+
+    std::cout << (Failures ? "FAILED" : "PASSED") << '\n';
+    return Failures != 0;
+}
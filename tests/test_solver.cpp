@@ -0,0 +1,285 @@
+#include "solver.hpp"
+#include "noguess.hpp"
+#include "tiles.hpp"
+#include "game.hpp"
+#include "config.hpp"
+
+#include <iostream>
+#include <utility>
+#include <cstdint>
+#include <random>
+#include <thread>
+#include <chrono>
+#include <vector>
+#include <set>
+
+// clang++ -std=c++11 -pthread -IHeaders -o binary/test_solver tests/test_solver.cpp Sources/solver.cpp Sources/noguess.cpp Sources/game.cpp Sources/snapshot.cpp Sources/tiles.cpp Sources/memory.cpp Sources/counts.cpp Sources/config.cpp && ./binary/test_solver
+
+int Failures = 0;
+std::mt19937 Rng(175);
+
+#define CHECK(condition) \
+    if (!(condition)) {std::cout << "FAILED " << __LINE__ << ": " #condition "\n"; Failures++;}
+
+/**
+ * Generates a board and a copy of it, the copy is used to learn the layout by tapping a mine
+ */
+std::set<std::pair<int,int>> generate(Tiles::Board& board, const std::pair<int,int>& safe_tile) {
+    const Config::Settings& Settings = board.getSettings();
+    const std::uint64_t Seed = Rng();
+    board.generateBoard(safe_tile,Seed);
+
+    Tiles::Board Oracle(Settings);
+    Oracle.generateBoard(safe_tile,Seed);
+    Oracle.Tap(safe_tile);
+
+    std::set<std::pair<int,int>> Mines;
+    for (int Row = 1; Row <= Settings.Rows && Mines.empty(); Row++) {
+        for (int Column = 1; Column <= Settings.Columns && Mines.empty(); Column++) {
+            const Responses::Tap Probe = Oracle.Tap({Row,Column});
+            if (Probe.State != States::Game::Lose) {continue;}
+            for (const auto& TileData : Probe.Tiles) {
+                Mines.insert(TileData.first);
+            }
+        }
+    }
+    CHECK((int)Mines.size() == Settings.Mines);
+    return Mines;
+}
+
+/**
+ * Plays boards with the solver, guessing with knowledge of the layout when it gets stuck. Everything it proves
+ * must match the layout.
+ */
+void TestSound(const Config::Settings& settings, int boards) {
+    Solver::Engine Solver;
+    for (int b = 0; b < boards; b++) {
+        Tiles::Board Board(settings);
+        const std::pair<int,int> Start = {(settings.Rows + 1)/2,(settings.Columns + 1)/2};
+        const std::set<std::pair<int,int>> Mines = generate(Board,Start);
+
+        Responses::Tap TR = Board.Tap(Start);
+        while (TR.State == States::Game::Playon) {
+            const Solver::Result& Result = Solver.Solve(Board);
+            for (const std::pair<int,int>& Tile : Result.Safe) {
+                CHECK(!Mines.count(Tile));
+                CHECK(!Board.tileRevealed(Tile));
+            }
+            for (const std::pair<int,int>& Tile : Result.Mines) {
+                CHECK(Mines.count(Tile));
+            }
+            if (Failures) {return;}
+
+            if (!Result.Safe.empty()) {
+                for (const std::pair<int,int>& Tile : Result.Safe) {
+                    TR = Board.Tap(Tile);
+                }
+                continue;
+            }
+
+            std::uniform_int_distribution<int> Row(1,settings.Rows);
+            std::uniform_int_distribution<int> Column(1,settings.Columns);
+            std::pair<int,int> Guess;
+            do {
+                Guess = {Row(Rng),Column(Rng)};
+            } while (Board.tileRevealed(Guess) || Mines.count(Guess));
+            TR = Board.Tap(Guess);
+        }
+        CHECK(TR.State == States::Game::Win);
+    }
+}
+
+/**
+ * Compares the solver with every mine arrangement of small boards
+ *
+ * Arrangements that fit every number but ignore the mine count prove the least, the solver has to find at least
+ * that. Arrangements that also have the right number of mines prove the most, the solver can never claim more.
+ */
+void TestExhaustive(const Config::Settings& settings, int boards) {
+    Solver::Engine Solver;
+    const int TotalTiles = settings.Rows*settings.Columns;
+    std::vector<signed char> View;
+
+    for (int b = 0; b < boards; b++) {
+        Tiles::Board Board(settings);
+        const std::pair<int,int> Start = {1 + b%settings.Rows,1 + b%settings.Columns};
+        const std::set<std::pair<int,int>> Mines = generate(Board,Start);
+
+        Responses::Tap TR = Board.Tap(Start);
+        while (TR.State == States::Game::Playon) {
+            Board.getView(View);
+            std::vector<int> Hidden;
+            for (int i = 0; i < TotalTiles; i++) {
+                if (View[i] < 0) {Hidden.push_back(i);}
+            }
+
+            // Tiles seen as safe (bit 0) and as mines (bit 1), with and without the mine count
+            std::vector<int> Any(TotalTiles,0);
+            std::vector<int> Counted(TotalTiles,0);
+            std::vector<unsigned char> Plane(TotalTiles);
+            for (long Arrangement = 0; Arrangement < (1L << Hidden.size()); Arrangement++) {
+                std::fill(Plane.begin(),Plane.end(),0);
+                int NumMines = 0;
+                for (size_t h = 0; h < Hidden.size(); h++) {
+                    if (Arrangement >> h & 1) {
+                        Plane[Hidden[h]] = 1;
+                        NumMines++;
+                    }
+                }
+
+                bool Fits = true;
+                for (int i = 0; i < TotalTiles && Fits; i++) {
+                    if (View[i] < 0) {continue;}
+                    const int Row = i/settings.Columns;
+                    const int Column = i%settings.Columns;
+                    int Adjacent = 0;
+                    for (int r = std::max(0,Row - 1); r <= std::min(settings.Rows - 1,Row + 1); r++) {
+                        for (int c = std::max(0,Column - 1); c <= std::min(settings.Columns - 1,Column + 1); c++) {
+                            Adjacent += Plane[r*settings.Columns + c];
+                        }
+                    }
+                    Fits = Adjacent == View[i];
+                }
+                if (!Fits) {continue;}
+
+                for (int i : Hidden) {
+                    Any[i] |= 1 << Plane[i];
+                    if (NumMines == settings.Mines) {Counted[i] |= 1 << Plane[i];}
+                }
+            }
+
+            const Solver::Result& Result = Solver.Solve(Board);
+            CHECK(Result.Complete);
+            std::vector<int> Proven(TotalTiles,0);
+            for (const std::pair<int,int>& Tile : Result.Safe) {
+                Proven[(Tile.first - 1)*settings.Columns + Tile.second - 1] = 1;
+            }
+            for (const std::pair<int,int>& Tile : Result.Mines) {
+                Proven[(Tile.first - 1)*settings.Columns + Tile.second - 1] = 2;
+            }
+            for (int i : Hidden) {
+                if (Any[i] == 1 || Any[i] == 2) {CHECK(Proven[i] == Any[i]);}
+                if (Proven[i]) {CHECK(Counted[i] == Proven[i]);}
+            }
+            if (Failures) {return;}
+
+            std::pair<int,int> Next;
+            do {
+                Next = {1 + Rng()%settings.Rows,1 + Rng()%settings.Columns};
+            } while (Board.tileRevealed(Next) || Mines.count(Next));
+            TR = Board.Tap(Next);
+        }
+    }
+}
+
+/**
+ * No-guess boards, generated directly, by a game and by the pool, must all be solvable from their start tile
+ */
+void TestNoGuess() {
+    Solver::Engine Solver;
+    Config::Settings Classic;
+    for (int b = 0; b < 10; b++) {
+        Tiles::Board Board(Classic);
+        const std::pair<int,int> Start = {1 + b*2,1 + b*5 % 26};
+        std::uint64_t Seed = Rng();
+        CHECK(NoGuess::Generate(Board,Start,Seed,Solver));
+        CHECK(NoGuess::Solvable(Board,Start,Solver));
+
+        // The seed handed back gives the same board, straight away
+        Tiles::Board Again(Classic);
+        const std::uint64_t Accepted = Seed;
+        CHECK(NoGuess::Generate(Again,Start,Seed,Solver));
+        CHECK(Seed == Accepted);
+        CHECK(Again.getMines() == Board.getMines());
+        CHECK(Board.Tap(Start).State != States::Game::Lose);
+    }
+
+    // Games only ever need the solver's safe tiles
+    Config::Settings Settings;
+    Settings.NoGuess = true;
+    Minesweeper::Game Game(Settings,7);
+    for (int b = 0; b < 10; b++) {
+        Game.Reset();
+        Responses::Tap TR = Game.Tap({13,13});
+        CHECK(!Game.NeedsGuess());
+        while (TR.State == States::Game::Playon) {
+            const Solver::Result& Result = Solver.Solve(Game.getBoard());
+            CHECK(!Result.Safe.empty());
+            if (Result.Safe.empty()) {break;}
+            TR = Game.Tap(Result.Safe.front());
+        }
+        CHECK(TR.State == States::Game::Win);
+    }
+
+    // Boards so crowded that none can be solved from a corner are dealt anyway, and the game says so
+    Config::Settings Crowded;
+    Crowded.Rows = 6;
+    Crowded.Columns = 6;
+    Crowded.Mines = 26;
+    Crowded.NoGuess = true;
+    Minesweeper::Game Packed(Crowded,7);
+    Packed.Tap({1,1});
+    CHECK(Packed.NeedsGuess());
+    Crowded.NoGuess = false;
+    Minesweeper::Game Plain(Crowded,7);
+    Plain.Tap({1,1});
+    CHECK(!Plain.NeedsGuess());
+
+    Config::Settings Beginner;
+    Beginner.Rows = 9;
+    Beginner.Columns = 9;
+    Beginner.Mines = 10;
+    Beginner.Threads = 2;
+    NoGuess::Pool Pool(Beginner,11);
+    for (int Wait = 0; Wait < 500 && Pool.Ready() < 81; Wait++) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    CHECK(Pool.Ready() >= 81);
+
+    std::uint64_t Seed;
+    for (int Row = 1; Row <= 9; Row++) {
+        for (int Column = 1; Column <= 9; Column++) {
+            if (!Pool.Take({Row,Column},Seed)) {continue;}
+
+            Tiles::Board Board(Beginner);
+            Board.generateBoard({Row,Column},Seed);
+            CHECK(NoGuess::Solvable(Board,{Row,Column},Solver));
+        }
+    }
+
+    // Too big to keep a ring for every start tile
+    Config::Settings Huge;
+    Huge.Rows = 1000;
+    Huge.Columns = 1000;
+    Huge.Mines = 1000;
+    NoGuess::Pool None(Huge,11);
+    CHECK(!None.Take({1,1},Seed));
+}
+
+int main() {
+    Config::Settings Classic;
+    TestSound(Classic,100);
+
+    Config::Settings Expert;
+    Expert.Rows = 16;
+    Expert.Columns = 30;
+    Expert.Mines = 99;
+    TestSound(Expert,50);
+
+    Config::Settings Small;
+    Small.Rows = 4;
+    Small.Columns = 5;
+    Small.Mines = 5;
+    TestExhaustive(Small,60);
+
+    Config::Settings Narrow;
+    Narrow.Rows = 2;
+    Narrow.Columns = 9;
+    Narrow.Mines = 4;
+    TestExhaustive(Narrow,100);
+
+    TestNoGuess();
+
+    std::cout << (Failures ? "FAILED" : "PASSED") << '\n';
+    return Failures != 0;
+}